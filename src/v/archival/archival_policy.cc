@@ -248,6 +248,7 @@ static ss::future<> get_file_range(
         // as well as file offset.
         // Lookup the index, if the index is available and some value is found
         // use it as a starting point otherwise, start from the begining.
+        co_await segment->index().hydrate();
         auto ix_begin = segment->index().find_nearest(begin_inclusive);
         size_t scan_from = ix_begin ? ix_begin->filepos : 0;
         model::offset sto = ix_begin ? ix_begin->offset
@@ -303,6 +304,7 @@ static ss::future<> get_file_range(
         // of the segment.
         // Lookup the index, if the index is available and some value is found
         // use it as a starting point otherwise, start from the begining.
+        co_await segment->index().hydrate();
         auto ix_end = segment->index().find_nearest(end_inclusive.value());
 
         // NOTE: Index lookup might return an offset which isn't committed yet.
@@ -262,10 +262,12 @@ ss::future<> controller::start() {
             std::ref(_partition_manager),
             std::ref(_raft_manager),
             std::ref(_as),
+            std::ref(_hm_frontend),
             config::shard_local_cfg().enable_leader_balancer.bind(),
             config::shard_local_cfg().leader_balancer_idle_timeout.bind(),
             config::shard_local_cfg().leader_balancer_mute_timeout.bind(),
             config::shard_local_cfg().leader_balancer_node_mute_timeout.bind(),
+            config::shard_local_cfg().leader_balancer_throughput_aware.bind(),
             _raft0);
           return _leader_balancer->start();
       })
@@ -589,6 +589,7 @@ struct ntp_leader {
     model::term_id term;
     std::optional<model::node_id> leader_id;
     model::revision_id revision_id;
+    std::optional<partition_throughput> throughput;
 };
 
 partition_status to_partition_leader(const ntp_leader& ntpl) {
@@ -597,6 +598,18 @@ partition_status to_partition_leader(const ntp_leader& ntpl) {
       .term = ntpl.term,
       .leader_id = ntpl.leader_id,
       .revision_id = ntpl.revision_id,
+      .throughput = ntpl.throughput,
+    };
+}
+
+// throughput is only reported by leaders, followers do not serve clients
+std::optional<partition_throughput> leader_throughput(partition& p) {
+    if (!p.is_leader()) {
+        return std::nullopt;
+    }
+    return partition_throughput{
+      .bytes_produced = p.probe().bytes_produced(),
+      .bytes_fetched = p.probe().bytes_fetched(),
     };
 }
 
@@ -616,6 +629,7 @@ std::vector<ntp_leader> collect_shard_local_leaders(
                 .term = p.second->term(),
                 .leader_id = p.second->get_leader_id(),
                 .revision_id = p.second->get_revision_id(),
+                .throughput = leader_throughput(*p.second),
               };
           });
     } else {
@@ -626,6 +640,7 @@ std::vector<ntp_leader> collect_shard_local_leaders(
                   .term = partition->term(),
                   .leader_id = partition->get_leader_id(),
                   .revision_id = partition->get_revision_id(),
+                  .throughput = leader_throughput(*partition),
                 });
             }
         }
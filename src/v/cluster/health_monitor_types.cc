@@ -81,14 +81,24 @@ std::ostream& operator<<(std::ostream& o, const cluster_health_report& r) {
     return o;
 }
 
+std::ostream& operator<<(std::ostream& o, const partition_throughput& t) {
+    fmt::print(
+      o,
+      "{{bytes_produced: {}, bytes_fetched: {}}}",
+      t.bytes_produced,
+      t.bytes_fetched);
+    return o;
+}
+
 std::ostream& operator<<(std::ostream& o, const partition_status& ps) {
     fmt::print(
       o,
-      "{{id: {}, term: {}, leader_id: {}, revision_id: {}}}",
+      "{{id: {}, term: {}, leader_id: {}, revision_id: {}, throughput: {}}}",
       ps.id,
       ps.term,
       ps.leader_id,
-      ps.revision_id);
+      ps.revision_id,
+      ps.throughput);
     return o;
 }
 
@@ -173,8 +183,12 @@ void adl<cluster::partition_status>::to(
     // if revision is not set fallback to old version, we do it here to prevent
     // old redpanda version from crashing, request handler will decode request
     // version and base on that handle revision_id field correctly.
+    // The same applies to the throughput, it is cleared for the requests
+    // decoded with a version older than -2.
     if (s.revision_id == model::revision_id{}) {
         serialize(out, int8_t(0), s.id, s.term, s.leader_id);
+    } else if (!s.throughput) {
+        serialize(out, int8_t(-1), s.id, s.term, s.leader_id, s.revision_id);
     } else {
         serialize(
           out,
@@ -182,7 +196,9 @@ void adl<cluster::partition_status>::to(
           s.id,
           s.term,
           s.leader_id,
-          s.revision_id);
+          s.revision_id,
+          s.throughput->bytes_produced,
+          s.throughput->bytes_fetched);
     }
 }
 
@@ -201,6 +217,14 @@ adl<cluster::partition_status>::from(iobuf_parser& p) {
     if (version < 0) {
         ret.revision_id = adl<model::revision_id>{}.from(p);
     }
+    if (version <= -2) {
+        auto produced = adl<uint64_t>{}.from(p);
+        auto fetched = adl<uint64_t>{}.from(p);
+        ret.throughput = cluster::partition_throughput{
+          .bytes_produced = produced,
+          .bytes_fetched = fetched,
+        };
+    }
     return ret;
 }
 
@@ -47,19 +47,37 @@ struct node_state {
     friend std::ostream& operator<<(std::ostream&, const node_state&);
 };
 
+/**
+ * Bytes produced to and fetched from a partition by its current leader since
+ * the partition was created on the leader's node. Counters are cumulative,
+ * consumers compute rates from subsequent reports.
+ */
+struct partition_throughput {
+    uint64_t bytes_produced{0};
+    uint64_t bytes_fetched{0};
+
+    friend std::ostream& operator<<(std::ostream&, const partition_throughput&);
+    friend bool
+    operator==(const partition_throughput&, const partition_throughput&)
+      = default;
+};
+
 struct partition_status {
     /**
      * We increase a version here 'backward' since incorrect assertion would
      * cause older redpanda versions to crash.
      *
      * Version: -1: added revision_id field
+     * Version: -2: added throughput field
      */
-    static constexpr int8_t current_version = -1;
+    static constexpr int8_t current_version = -2;
 
     model::partition_id id;
     model::term_id term;
     std::optional<model::node_id> leader_id;
     model::revision_id revision_id;
+    // only set for partitions led by the reporting node
+    std::optional<partition_throughput> throughput;
 
     friend std::ostream& operator<<(std::ostream&, const partition_status&);
     friend bool operator==(const partition_status&, const partition_status&)
@@ -151,7 +169,8 @@ using force_refresh = ss::bool_class<struct hm_force_refresh_tag>;
 
 struct get_node_health_request {
     // version -1: included revision id in partition status
-    static constexpr int8_t current_version = -1;
+    // version -2: included throughput in partition status
+    static constexpr int8_t current_version = -2;
 
     node_report_filter filter;
     // this field is not serialized
@@ -167,7 +186,8 @@ struct get_node_health_reply {
 
 struct get_cluster_health_request {
     // version -1: included revision id in partition status
-    static constexpr int8_t current_version = -1;
+    // version -2: included throughput in partition status
+    static constexpr int8_t current_version = -2;
     cluster_report_filter filter;
     // if set to true will force node health metadata refresh
     force_refresh refresh = force_refresh::no;
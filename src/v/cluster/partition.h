@@ -126,6 +126,18 @@ public:
         return raft::details::next_offset(_raft->last_visible_index());
     }
 
+    /**
+     * Resolves once the high watermark moves past `hwm`, i.e. new batches are
+     * visible to consumers. Throws raft::offset_monitor::wait_aborted when the
+     * partition is shut down.
+     */
+    ss::future<> wait_for_high_watermark(
+      model::offset hwm,
+      model::timeout_clock::time_point deadline,
+      std::optional<std::reference_wrapper<ss::abort_source>> as) {
+        return _raft->visible_offset_monitor().wait(hwm, deadline, as);
+    }
+
     model::term_id term() { return _raft->term(); }
 
     model::offset dirty_offset() const {
@@ -177,6 +189,11 @@ public:
         return _raft->get_leader_id();
     }
 
+    /// replication state of the followers, empty if not the leader
+    std::vector<raft::follower_metrics> get_follower_metrics() const {
+        return _raft->get_follower_metrics();
+    }
+
     model::offset get_latest_configuration_offset() const {
         return _raft->get_latest_configuration_offset();
     }
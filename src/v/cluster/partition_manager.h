@@ -132,6 +132,19 @@ public:
         _unmanage_watchers.unregister_notify(id);
     }
 
+    /*
+     * register for leadership and term changes of the raft groups of the
+     * partitions, see raft::group_manager::register_leadership_notification
+     */
+    notification_id_type
+    register_leadership_notification(raft::group_manager::leader_cb_t cb) {
+        return _raft_manager.local().register_leadership_notification(
+          std::move(cb));
+    }
+    void unregister_leadership_notification(notification_id_type id) {
+        _raft_manager.local().unregister_leadership_notification(id);
+    }
+
     /*
      * read-only interface to partitions.
      *
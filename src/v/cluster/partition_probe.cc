@@ -122,6 +122,8 @@ partition_probe make_materialized_partition_probe() {
         void add_records_produced(uint64_t) final {}
         void add_bytes_fetched(uint64_t) final {}
         void add_bytes_produced(uint64_t) final {}
+        uint64_t bytes_produced() const final { return 0; }
+        uint64_t bytes_fetched() const final { return 0; }
     };
     return partition_probe(std::make_unique<impl>());
 }
@@ -28,6 +28,8 @@ public:
         virtual void add_records_fetched(uint64_t) = 0;
         virtual void add_bytes_produced(uint64_t) = 0;
         virtual void add_bytes_fetched(uint64_t) = 0;
+        virtual uint64_t bytes_produced() const = 0;
+        virtual uint64_t bytes_fetched() const = 0;
         virtual void setup_metrics(const model::ntp&) = 0;
         virtual ~impl() noexcept = default;
     };
@@ -54,6 +56,10 @@ public:
         return _impl->add_bytes_fetched(bytes);
     }
 
+    uint64_t bytes_produced() const { return _impl->bytes_produced(); }
+
+    uint64_t bytes_fetched() const { return _impl->bytes_fetched(); }
+
 private:
     std::unique_ptr<impl> _impl;
 };
@@ -68,6 +74,9 @@ public:
     void add_bytes_fetched(uint64_t cnt) final { _bytes_fetched += cnt; }
     void add_bytes_produced(uint64_t cnt) final { _bytes_produced += cnt; }
 
+    uint64_t bytes_produced() const final { return _bytes_produced; }
+    uint64_t bytes_fetched() const final { return _bytes_fetched; }
+
 private:
     const partition& _partition;
     uint64_t _records_produced{0};
@@ -1409,6 +1409,21 @@ void rm_stm::apply_fence(model::record_batch&& b) {
 }
 
 ss::future<> rm_stm::apply(model::record_batch b) {
+    co_await apply_batch(std::move(b));
+    after_apply();
+}
+
+ss::future<>
+rm_stm::apply_batches(ss::circular_buffer<model::record_batch> batches) {
+    for (auto& b : batches) {
+        co_await apply_batch(std::move(b));
+    }
+    // the session table compaction and the auto abort check only depend on
+    // the state after the batches are applied
+    after_apply();
+}
+
+ss::future<> rm_stm::apply_batch(model::record_batch b) {
     auto last_offset = b.last_offset();
 
     const auto& hdr = b.header();
@@ -1427,7 +1442,9 @@ ss::future<> rm_stm::apply(model::record_batch b) {
     }
 
     _insync_offset = last_offset;
+}
 
+void rm_stm::after_apply() {
     compact_snapshot();
     if (_is_autoabort_enabled && !_is_autoabort_active) {
         abort_old_txes();
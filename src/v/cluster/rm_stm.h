@@ -297,6 +297,10 @@ private:
     get_abort_origin(const model::producer_identity&, model::tx_seq) const;
 
     ss::future<> apply(model::record_batch) override;
+    ss::future<>
+      apply_batches(ss::circular_buffer<model::record_batch>) override;
+    ss::future<> apply_batch(model::record_batch);
+    void after_apply();
     void apply_fence(model::record_batch&&);
     void apply_prepare(rm_stm::prepare_marker);
     ss::future<>
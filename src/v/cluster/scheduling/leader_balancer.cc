@@ -10,9 +10,11 @@
  */
 #include "cluster/scheduling/leader_balancer.h"
 
+#include "cluster/health_monitor_frontend.h"
 #include "cluster/logger.h"
 #include "cluster/partition_leaders_table.h"
 #include "cluster/scheduling/leader_balancer_greedy.h"
+#include "cluster/scheduling/leader_balancer_throughput.h"
 #include "cluster/shard_table.h"
 #include "cluster/topic_table.h"
 #include "model/namespace.h"
@@ -43,15 +45,18 @@ leader_balancer::leader_balancer(
   ss::sharded<partition_manager>& partition_manager,
   ss::sharded<raft::group_manager>& group_manager,
   ss::sharded<ss::abort_source>& as,
+  ss::sharded<health_monitor_frontend>& hm_frontend,
   config::binding<bool>&& enabled,
   config::binding<std::chrono::milliseconds>&& idle_timeout,
   config::binding<std::chrono::milliseconds>&& mute_timeout,
   config::binding<std::chrono::milliseconds>&& node_mute_timeout,
+  config::binding<bool>&& throughput_aware,
   consensus_ptr raft0)
   : _enabled(std::move(enabled))
   , _idle_timeout(std::move(idle_timeout))
   , _mute_timeout(std::move(mute_timeout))
   , _node_mute_timeout(std::move(node_mute_timeout))
+  , _throughput_aware(std::move(throughput_aware))
   , _topics(topics)
   , _leaders(leaders)
   , _client(std::move(client))
@@ -59,6 +64,7 @@ leader_balancer::leader_balancer(
   , _partition_manager(partition_manager)
   , _group_manager(group_manager)
   , _as(as)
+  , _hm_frontend(hm_frontend)
   , _raft0(std::move(raft0))
   , _timer([this] { trigger_balance(); }) {
     if (!config::shard_local_cfg().disable_metrics()) {
@@ -246,10 +252,14 @@ ss::future<ss::stop_iteration> leader_balancer::balance() {
      * (e.g. on average little should change between ticks) and bounding the
      * search for leader moves.
      */
-    greedy_balanced_shards strategy(build_index(), muted_nodes());
+    if (_throughput_aware()) {
+        co_await refresh_throughput();
+    }
+
+    auto strategy = make_strategy();
 
     if (clusterlog.is_enabled(ss::log_level::trace)) {
-        auto cores = strategy.stats();
+        auto cores = strategy->stats();
         for (const auto& core : cores) {
             vlog(
               clusterlog.trace,
@@ -259,8 +269,8 @@ ss::future<ss::stop_iteration> leader_balancer::balance() {
         }
     }
 
-    auto error = strategy.error();
-    auto transfer = strategy.find_movement(muted_groups());
+    auto error = strategy->error();
+    auto transfer = strategy->find_movement(muted_groups());
     if (!transfer) {
         vlog(
           clusterlog.debug,
@@ -597,6 +607,58 @@ leader_balancer::index_type leader_balancer::build_index() {
     return index;
 }
 
+std::unique_ptr<leader_balancer_strategy> leader_balancer::make_strategy() {
+    if (_throughput_aware()) {
+        return std::make_unique<throughput_balanced_shards>(
+          build_index(), muted_nodes(), throughput_rates());
+    }
+    return std::make_unique<greedy_balanced_shards>(
+      build_index(), muted_nodes());
+}
+
+ss::future<> leader_balancer::refresh_throughput() {
+    const auto now = clock_type::now();
+    if (
+      now - _throughput_refreshed < throughput_refresh_interval
+      || !_hm_frontend.local_is_initialized()) {
+        co_return;
+    }
+    _throughput_refreshed = now;
+
+    auto report = co_await _hm_frontend.local().get_cluster_health(
+      cluster_report_filter{},
+      force_refresh::no,
+      model::timeout_clock::now() + health_report_timeout);
+    if (report.has_error()) {
+        vlog(
+          clusterlog.debug,
+          "Leadership balancer tick: failed to get cluster health report: {}",
+          report.error().message());
+        co_return;
+    }
+
+    _throughput.update(report.value());
+}
+
+absl::flat_hash_map<raft::group_id, double>
+leader_balancer::throughput_rates() const {
+    absl::flat_hash_map<raft::group_id, double> rates;
+    for (const auto& topic : _topics.topics_map()) {
+        if (!topic.second.is_topic_replicable()) {
+            continue;
+        }
+        for (const auto& partition :
+             topic.second.get_configuration().assignments) {
+            auto rate = _throughput.rate(
+              model::ntp(topic.first.ns, topic.first.tp, partition.id));
+            if (rate) {
+                rates.emplace(partition.group, *rate);
+            }
+        }
+    }
+    return rates;
+}
+
 ss::future<bool> leader_balancer::do_transfer(reassignment transfer) {
     vlog(
       clusterlog.debug,
@@ -9,10 +9,13 @@
  * by the Apache License, Version 2.0
  */
 #pragma once
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "cluster/fwd.h"
 #include "cluster/partition_manager.h"
 #include "cluster/scheduling/leader_balancer_probe.h"
 #include "cluster/scheduling/leader_balancer_strategy.h"
+#include "cluster/scheduling/leader_balancer_throughput.h"
 #include "cluster/types.h"
 #include "raft/consensus.h"
 #include "raft/consensus_client_protocol.h"
@@ -62,6 +65,15 @@ class leader_balancer {
      */
     static constexpr clock_type::duration leader_transfer_rpc_timeout = 30s;
 
+    /*
+     * throughput aware balancing computes partition rates from the
+     * cumulative byte counters in health reports. the rates are refreshed at
+     * most this often, the health report itself is refreshed less often.
+     */
+    static constexpr clock_type::duration throughput_refresh_interval = 10s;
+    static constexpr model::timeout_clock::duration health_report_timeout
+      = 5s;
+
 public:
     leader_balancer(
       topic_table&,
@@ -71,10 +83,12 @@ public:
       ss::sharded<partition_manager>&,
       ss::sharded<raft::group_manager>&,
       ss::sharded<ss::abort_source>&,
+      ss::sharded<health_monitor_frontend>&,
       config::binding<bool>&&,
       config::binding<std::chrono::milliseconds>&&,
       config::binding<std::chrono::milliseconds>&&,
       config::binding<std::chrono::milliseconds>&&,
+      config::binding<bool>&&,
       consensus_ptr);
 
     ss::future<> start();
@@ -85,6 +99,9 @@ private:
     using reassignment = leader_balancer_strategy::reassignment;
 
     index_type build_index();
+    std::unique_ptr<leader_balancer_strategy> make_strategy();
+    ss::future<> refresh_throughput();
+    absl::flat_hash_map<raft::group_id, double> throughput_rates() const;
     std::optional<model::broker_shard> find_leader_shard(const model::ntp&);
     absl::flat_hash_set<raft::group_id> muted_groups() const;
     absl::flat_hash_set<model::node_id> muted_nodes() const;
@@ -137,6 +154,16 @@ private:
      */
     config::binding<std::chrono::milliseconds> _node_mute_timeout;
 
+    /*
+     * balance leaders by the produce and fetch rates of the partitions
+     * instead of by their number.
+     */
+    config::binding<bool> _throughput_aware;
+
+    // partition rates computed from the health reports
+    throughput_tracker _throughput;
+    clock_type::time_point _throughput_refreshed;
+
     struct last_known_leader {
         model::broker_shard shard;
         clock_type::time_point expires;
@@ -154,6 +181,7 @@ private:
     ss::sharded<partition_manager>& _partition_manager;
     ss::sharded<raft::group_manager>& _group_manager;
     ss::sharded<ss::abort_source>& _as;
+    ss::sharded<health_monitor_frontend>& _hm_frontend;
     consensus_ptr _raft0;
     ss::gate _gate;
     ss::timer<clock_type> _timer;
@@ -26,6 +26,8 @@ namespace cluster {
  */
 class leader_balancer_strategy {
 public:
+    virtual ~leader_balancer_strategy() = default;
+
     /*
      * Map a shard to the set of groups whose replica sets contain the shard as
      * a leader of the group. For convenience, the data structure also contains
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+
+#include "cluster/health_monitor_types.h"
+#include "cluster/scheduling/leader_balancer_strategy.h"
+#include "model/fundamental.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+
+/*
+ * Throughput balanced shards strategy weights each group by the rate of bytes
+ * produced to and fetched from it, so that the hot partitions are spread over
+ * the nodes instead of ending up on the same one. The error is dominated by
+ * the squared deviation of the node loads from their share of the total load,
+ * which is proportional to the number of their cores. The deviation of the
+ * core loads only breaks ties: a core leading a single hot group is always
+ * overloaded, if the cores weighed as much as the nodes the strategy would
+ * move the other groups off the node of the hot group to the already loaded
+ * nodes.
+ *
+ * Every leader also has a fixed cost of a fraction of the mean rate, so that
+ * idle groups are still spread. Groups without a known rate, e.g. the ones
+ * that were just created, are assumed to have the mean rate. With no rates at
+ * all the strategy balances the number of leaders.
+ */
+namespace cluster {
+
+class throughput_balanced_shards final : public leader_balancer_strategy {
+    /*
+     * a move needs to improve the error by more than this fraction of the
+     * current error, this avoids chasing tiny improvements caused by noise in
+     * the measured rates.
+     */
+    static constexpr double error_jitter = 0.0001;
+
+    /*
+     * fixed cost of a leader as a fraction of the mean rate of the groups
+     */
+    static constexpr double leader_cost = 0.05;
+
+    /*
+     * weight of the core loads in the error relative to the node loads
+     */
+    static constexpr double shard_error_weight = 0.01;
+
+public:
+    using rates_t = absl::flat_hash_map<raft::group_id, double>;
+
+    throughput_balanced_shards(
+      index_type cores,
+      absl::flat_hash_set<model::node_id> muted_nodes,
+      const rates_t& rates)
+      : _cores(std::move(cores))
+      , _muted_nodes(std::move(muted_nodes)) {
+        compute_weights(rates);
+        compute_loads();
+    }
+
+    /*
+     * target = total_load / num_cores
+     * error = sum((node.load - node.cores * target)^2 for each node)
+     *       + w * sum((shard.load - target)^2 for each shard)
+     */
+    double error() const final {
+        const auto target = target_load();
+        double e = 0;
+        for (const auto& [node, load] : _node_load) {
+            if (!_muted_nodes.contains(node)) {
+                e += std::pow(load - node_target(node, target), 2);
+            }
+        }
+        for (const auto& [shard, load] : _shard_load) {
+            if (!_muted_nodes.contains(shard.node_id)) {
+                e += shard_error_weight * std::pow(load - target, 2);
+            }
+        }
+        return e;
+    }
+
+    /*
+     * Compute the change of the error when a group of weight `w` moves from a
+     * core to a core of another node.
+     */
+    double error_delta(
+      const model::broker_shard& from,
+      const model::broker_shard& to,
+      double w) const {
+        const auto target = target_load();
+        const auto from_node = _node_load.at(from.node_id);
+        const auto to_node = _node_load.at(to.node_id);
+        const auto from_target = node_target(from.node_id, target);
+        const auto to_target = node_target(to.node_id, target);
+        const auto from_shard = _shard_load.at(from);
+        const auto to_shard = _shard_load.at(to);
+        return std::pow(from_node - w - from_target, 2)
+               + std::pow(to_node + w - to_target, 2)
+               - std::pow(from_node - from_target, 2)
+               - std::pow(to_node - to_target, 2)
+               + shard_error_weight
+                   * (std::pow(from_shard - w - target, 2)
+                      + std::pow(to_shard + w - target, 2)
+                      - std::pow(from_shard - target, 2)
+                      - std::pow(to_shard - target, 2));
+    }
+
+    /*
+     * Starting with the cores of the most loaded node find the move of a group
+     * to one of its replicas that improves the error the most. Replicas of a
+     * group are on different nodes, so every move changes the load of two
+     * nodes. Like in the greedy strategy cores on muted nodes are neither a
+     * source nor a target.
+     */
+    std::optional<reassignment>
+    find_movement(const absl::flat_hash_set<raft::group_id>& skip) const final {
+        std::vector<index_type::const_iterator> load;
+        load.reserve(_cores.size());
+        for (auto it = _cores.cbegin(); it != _cores.cend(); ++it) {
+            if (!_muted_nodes.contains(it->first.node_id)) {
+                load.push_back(it);
+            }
+        }
+        std::sort(load.begin(), load.end(), [this](auto a, auto b) {
+            const auto a_node = _node_load.at(a->first.node_id);
+            const auto b_node = _node_load.at(b->first.node_id);
+            if (a_node != b_node) {
+                return a_node > b_node;
+            }
+            return _shard_load.at(a->first) > _shard_load.at(b->first);
+        });
+
+        const auto min_improvement = error() * error_jitter;
+        for (const auto& from : load) {
+            std::optional<reassignment> best;
+            double best_delta = -min_improvement;
+            for (const auto& [group, replicas] : from->second) {
+                if (skip.contains(group)) {
+                    continue;
+                }
+                const auto w = _weights.at(group);
+                for (const auto& to : replicas) {
+                    if (
+                      to.node_id == from->first.node_id
+                      || _muted_nodes.contains(to.node_id)
+                      || !_cores.contains(to)) {
+                        continue;
+                    }
+                    auto d = error_delta(from->first, to, w);
+                    if (d < best_delta) {
+                        best_delta = d;
+                        best = reassignment{group, from->first, to};
+                    }
+                }
+            }
+            if (best) {
+                return best;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<shard_load> stats() const final {
+        std::vector<shard_load> ret;
+        ret.reserve(_cores.size());
+        for (const auto& [shard, groups] : _cores) {
+            ret.push_back(
+              shard_load{shard, static_cast<size_t>(groups.size())});
+        }
+        return ret;
+    }
+
+    /*
+     * Update the state as if the reassignment was executed, used to plan
+     * several moves ahead.
+     */
+    void apply_movement(const reassignment& r) {
+        auto& from = _cores.at(r.from);
+        auto it = from.find(r.group);
+        if (it == from.end()) {
+            return;
+        }
+        const auto w = _weights.at(r.group);
+        _cores[r.to].emplace(r.group, std::move(it->second));
+        from.erase(it);
+        _shard_load[r.from] -= w;
+        _shard_load[r.to] += w;
+        _node_load[r.from.node_id] -= w;
+        _node_load[r.to.node_id] += w;
+    }
+
+private:
+    void compute_weights(const rates_t& rates) {
+        size_t known = 0;
+        double total = 0;
+        for (const auto& [shard, groups] : _cores) {
+            for (const auto& g : groups) {
+                if (auto it = rates.find(g.first); it != rates.end()) {
+                    ++known;
+                    total += it->second;
+                }
+            }
+        }
+        const auto mean = known == 0 ? 0 : total / static_cast<double>(known);
+        for (const auto& [shard, groups] : _cores) {
+            for (const auto& g : groups) {
+                auto it = rates.find(g.first);
+                auto rate = it == rates.end() ? mean : it->second;
+                // all groups idle: every leader weighs the same
+                _weights[g.first] = mean > 0 ? rate + leader_cost * mean : 1;
+            }
+        }
+    }
+
+    void compute_loads() {
+        for (const auto& [shard, groups] : _cores) {
+            double load = 0;
+            for (const auto& g : groups) {
+                load += _weights.at(g.first);
+            }
+            _shard_load[shard] = load;
+            _node_load[shard.node_id] += load;
+            ++_node_cores[shard.node_id];
+            if (!_muted_nodes.contains(shard.node_id)) {
+                _total_load += load;
+                ++_num_cores;
+            }
+        }
+    }
+
+    double target_load() const {
+        return _num_cores == 0
+                 ? 0
+                 : _total_load / static_cast<double>(_num_cores);
+    }
+
+    double node_target(model::node_id id, double target) const {
+        return target * static_cast<double>(_node_cores.at(id));
+    }
+
+    index_type _cores;
+    absl::flat_hash_set<model::node_id> _muted_nodes;
+    absl::flat_hash_map<raft::group_id, double> _weights;
+    absl::flat_hash_map<model::broker_shard, double> _shard_load;
+    absl::flat_hash_map<model::node_id, double> _node_load;
+    absl::flat_hash_map<model::node_id, size_t> _node_cores;
+    // of the cores on nodes that are not muted
+    double _total_load{0};
+    size_t _num_cores{0};
+};
+
+/*
+ * Rates of the partitions computed from the cumulative byte counters that
+ * leaders report in health reports. The uptime of the reporting node is used
+ * as the time of a sample, so that cached reports do not skew the rates and
+ * restarts are detected.
+ */
+class throughput_tracker {
+public:
+    void update(const cluster_health_report& report) {
+        const auto generation = ++_generation;
+        for (const auto& node : report.node_reports) {
+            const auto uptime = node.local_state.uptime;
+            for (const auto& topic : node.topics) {
+                for (const auto& p : topic.partitions) {
+                    // only leaders report throughput, skip stale leaders
+                    if (!p.throughput || p.leader_id != node.id) {
+                        continue;
+                    }
+                    update(
+                      model::ntp(topic.tp_ns.ns, topic.tp_ns.tp, p.id),
+                      node.id,
+                      uptime,
+                      p.throughput->bytes_produced
+                        + p.throughput->bytes_fetched);
+                }
+            }
+        }
+        // drop the partitions that were deleted or have no leader anymore
+        absl::erase_if(_samples, [generation](const auto& e) {
+            return e.second.generation != generation;
+        });
+    }
+
+    std::optional<double> rate(const model::ntp& ntp) const {
+        auto it = _samples.find(ntp);
+        if (it == _samples.end()) {
+            return std::nullopt;
+        }
+        return it->second.rate;
+    }
+
+    size_t size() const { return _samples.size(); }
+
+private:
+    struct sample {
+        model::node_id leader;
+        std::chrono::milliseconds uptime;
+        uint64_t bytes;
+        std::optional<double> rate;
+        uint64_t generation;
+    };
+
+    void update(
+      model::ntp ntp,
+      model::node_id leader,
+      std::chrono::milliseconds uptime,
+      uint64_t bytes) {
+        auto [it, inserted] = _samples.try_emplace(
+          std::move(ntp),
+          sample{
+            .leader = leader,
+            .uptime = uptime,
+            .bytes = bytes,
+            .generation = _generation});
+        auto& s = it->second;
+        s.generation = _generation;
+        if (inserted || uptime == s.uptime) {
+            return;
+        }
+        /*
+         * counters belong to the leader, when leadership moves or the node
+         * restarts they start over. keep the last rate until the next sample.
+         */
+        if (s.leader == leader && uptime > s.uptime && bytes >= s.bytes) {
+            auto elapsed = std::chrono::duration<double>(uptime - s.uptime);
+            s.rate = static_cast<double>(bytes - s.bytes) / elapsed.count();
+        }
+        s.leader = leader;
+        s.uptime = uptime;
+        s.bytes = bytes;
+    }
+
+    absl::flat_hash_map<model::ntp, sample> _samples;
+    uint64_t _generation{0};
+};
+
+} // namespace cluster
@@ -413,6 +413,14 @@ void clear_partition_revisions(node_health_report& report) {
         }
     }
 }
+
+void clear_partition_throughput(node_health_report& report) {
+    for (auto& t : report.topics) {
+        for (auto& p : t.partitions) {
+            p.throughput = std::nullopt;
+        }
+    }
+}
 } // namespace
 
 ss::future<get_node_health_reply>
@@ -428,6 +436,10 @@ service::do_collect_node_health_report(get_node_health_request req) {
     if (req.decoded_version == 0) {
         clear_partition_revisions(report);
     }
+    // nodes older than version -2 can not decode the throughput
+    if (req.decoded_version > -2) {
+        clear_partition_throughput(report);
+    }
     co_return get_node_health_reply{
       .error = errc::success,
       .report = std::move(report),
@@ -452,6 +464,12 @@ service::do_get_cluster_health_report(get_cluster_health_request req) {
             clear_partition_revisions(r);
         }
     }
+    // nodes older than version -2 can not decode the throughput
+    if (req.decoded_version > -2) {
+        for (auto& r : report.node_reports) {
+            clear_partition_throughput(r);
+        }
+    }
     co_return get_cluster_health_reply{
       .error = errc::success,
       .report = std::move(report),
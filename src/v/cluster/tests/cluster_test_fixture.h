@@ -68,7 +68,8 @@ public:
       int16_t proxy_port,
       int16_t schema_reg_port,
       int16_t coproc_supervisor_port,
-      std::vector<config::seed_server> seeds) {
+      std::vector<config::seed_server> seeds,
+      std::optional<model::rack_id> rack) {
         _instances.emplace(
           node_id,
           std::make_unique<redpanda_thread_fixture>(
@@ -81,7 +82,8 @@ public:
             seeds,
             ssx::sformat("{}.{}", _base_dir, node_id()),
             _sgroups,
-            false));
+            false,
+            std::move(rack)));
     }
 
     application* get_node_application(model::node_id id) {
@@ -107,7 +109,9 @@ public:
       int rpc_port = 11000,
       int proxy_port = 8082,
       int schema_reg_port = 8081,
-      int coproc_supervisor_port = 43189) {
+      int coproc_supervisor_port = 43189,
+      std::optional<model::rack_id> rack = model::rack_id(
+        redpanda_thread_fixture::rack_name)) {
         std::vector<config::seed_server> seeds = {};
         if (node_id != 0) {
             seeds.push_back(
@@ -120,7 +124,8 @@ public:
           proxy_port + node_id(),
           schema_reg_port + node_id(),
           coproc_supervisor_port + node_id(),
-          std::move(seeds));
+          std::move(seeds),
+          std::move(rack));
         return get_node_application(node_id);
     }
 
@@ -0,0 +1,350 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#define BOOST_TEST_MODULE leader_balancer_throughput
+
+#include "cluster/scheduling/leader_balancer_greedy.h"
+#include "cluster/scheduling/leader_balancer_throughput.h"
+#include "units.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+/*
+ * Simulation harness: a distribution of partition byte rates is replayed on a
+ * cluster with the leaders of the hottest partitions placed on one node. Moves
+ * of a strategy are applied until it finds none and the resulting per node
+ * byte rates are compared with the lower bound of the max node load and with
+ * the result of balancing the number of leaders.
+ */
+namespace {
+
+using index_type = cluster::leader_balancer_strategy::index_type;
+using reassignment = cluster::leader_balancer_strategy::reassignment;
+
+constexpr size_t nodes = 5;
+constexpr size_t cores = 4;
+constexpr size_t replication = 3;
+constexpr size_t max_moves = 10000;
+
+struct load_distribution {
+    const char* name;
+    // bytes per second of each partition
+    std::vector<double> rates;
+};
+
+std::vector<model::broker_shard> all_shards() {
+    std::vector<model::broker_shard> shards;
+    for (auto n = 0U; n < nodes; n++) {
+        for (auto s = 0U; s < cores; s++) {
+            shards.push_back(model::broker_shard{model::node_id(n), s});
+        }
+    }
+    return shards;
+}
+
+/*
+ * the leaders of the hottest fifth of the partitions are on node 0, the
+ * others are spread over all cores. followers are spread over the other
+ * nodes.
+ */
+index_type skewed_placement(const std::vector<double>& rates) {
+    const auto shards = all_shards();
+    std::vector<size_t> order(rates.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&rates](auto a, auto b) {
+        return rates[a] > rates[b];
+    });
+
+    index_type index;
+    for (const auto& s : shards) {
+        index.try_emplace(s);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto leader = shards[i % shards.size()];
+        if (i < order.size() / nodes) {
+            leader = model::broker_shard{
+              model::node_id(0), static_cast<uint32_t>(i % cores)};
+        }
+        std::vector<model::broker_shard> replicas{leader};
+        for (size_t j = i; replicas.size() < replication; j += 7) {
+            const auto& s = shards[j % shards.size()];
+            auto on_node = std::any_of(
+              replicas.begin(), replicas.end(), [&s](const auto& r) {
+                  return r.node_id == s.node_id;
+              });
+            if (!on_node) {
+                replicas.push_back(s);
+            }
+        }
+        index[leader][raft::group_id(order[i])] = std::move(replicas);
+    }
+    return index;
+}
+
+cluster::throughput_balanced_shards::rates_t
+to_rates(const std::vector<double>& rates) {
+    cluster::throughput_balanced_shards::rates_t ret;
+    for (size_t i = 0; i < rates.size(); ++i) {
+        ret[raft::group_id(i)] = rates[i];
+    }
+    return ret;
+}
+
+void apply(index_type& index, const reassignment& r) {
+    auto& from = index.at(r.from);
+    auto it = from.find(r.group);
+    index[r.to][r.group] = std::move(it->second);
+    from.erase(it);
+}
+
+std::vector<double>
+node_rates(const index_type& index, const std::vector<double>& rates) {
+    std::vector<double> ret(nodes, 0);
+    for (const auto& [shard, groups] : index) {
+        for (const auto& g : groups) {
+            ret[shard.node_id()] += rates[g.first()];
+        }
+    }
+    return ret;
+}
+
+std::vector<size_t> node_leaders(const index_type& index) {
+    std::vector<size_t> ret(nodes, 0);
+    for (const auto& [shard, groups] : index) {
+        ret[shard.node_id()] += groups.size();
+    }
+    return ret;
+}
+
+double max_of(const std::vector<double>& v) {
+    return *std::max_element(v.begin(), v.end());
+}
+
+// no placement has a node load lower than this
+double lower_bound(const std::vector<double>& rates) {
+    auto total = std::accumulate(rates.begin(), rates.end(), 0.0);
+    return std::max(total / nodes, max_of(rates));
+}
+
+struct simulation_result {
+    index_type index;
+    size_t moves{0};
+};
+
+simulation_result
+replay_throughput(index_type index, const std::vector<double>& rates) {
+    cluster::throughput_balanced_shards strategy(index, {}, to_rates(rates));
+    simulation_result ret;
+    while (ret.moves < max_moves) {
+        auto m = strategy.find_movement({});
+        if (!m) {
+            break;
+        }
+        strategy.apply_movement(*m);
+        apply(index, *m);
+        ++ret.moves;
+    }
+    ret.index = std::move(index);
+    return ret;
+}
+
+simulation_result replay_count(index_type index) {
+    simulation_result ret;
+    while (ret.moves < max_moves) {
+        auto m = cluster::greedy_balanced_shards(index, {}).find_movement({});
+        if (!m) {
+            break;
+        }
+        apply(index, *m);
+        ++ret.moves;
+    }
+    ret.index = std::move(index);
+    return ret;
+}
+
+std::vector<load_distribution> distributions() {
+    std::vector<load_distribution> ret;
+
+    // one hot topic and many idle partitions
+    load_distribution hot{.name = "hot_topic"};
+    hot.rates.assign(10, double(50_MiB));
+    hot.rates.resize(300, double(10_KiB));
+    ret.push_back(std::move(hot));
+
+    // zipf distributed rates
+    load_distribution zipf{.name = "zipf"};
+    for (auto i = 0; i < 500; ++i) {
+        zipf.rates.push_back(100_MiB / std::pow(i + 1, 1.1));
+    }
+    ret.push_back(std::move(zipf));
+
+    // a few hot, some warm and many idle partitions
+    load_distribution tiers{.name = "tiers"};
+    tiers.rates.assign(20, double(20_MiB));
+    tiers.rates.resize(120, double(2_MiB));
+    tiers.rates.resize(400, 0);
+    ret.push_back(std::move(tiers));
+
+    return ret;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(throughput_replay_distributions) {
+    for (const auto& d : distributions()) {
+        BOOST_TEST_CONTEXT(d.name) {
+            auto index = skewed_placement(d.rates);
+            auto by_count = replay_count(index);
+            auto by_throughput = replay_throughput(index, d.rates);
+
+            BOOST_REQUIRE_LT(by_throughput.moves, max_moves);
+            auto count_max = max_of(node_rates(by_count.index, d.rates));
+            auto throughput_max = max_of(
+              node_rates(by_throughput.index, d.rates));
+            BOOST_CHECK_LE(throughput_max, 1.05 * lower_bound(d.rates));
+            BOOST_CHECK_LT(throughput_max, count_max);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(throughput_uniform_is_count_balanced) {
+    // equal rates, or none at all, balance the number of leaders
+    std::vector<double> rates(400, 1_MiB);
+    for (const auto& r : {to_rates(rates), to_rates({})}) {
+        auto index = skewed_placement(rates);
+        cluster::throughput_balanced_shards strategy(index, {}, r);
+        while (auto m = strategy.find_movement({})) {
+            strategy.apply_movement(*m);
+            apply(index, *m);
+        }
+        for (auto leaders : node_leaders(index)) {
+            BOOST_CHECK_EQUAL(leaders, rates.size() / nodes);
+        }
+        // cores only break ties, they are close to but not exactly balanced
+        for (const auto& [shard, groups] : index) {
+            BOOST_CHECK_LE(
+              std::abs(
+                static_cast<int>(groups.size())
+                - static_cast<int>(rates.size() / nodes / cores)),
+              1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(throughput_moves_hot_leader) {
+    std::vector<double> rates(100, 1_KiB);
+    rates[0] = rates[1] = 10_MiB;
+    auto index = skewed_placement(rates);
+
+    cluster::throughput_balanced_shards strategy(index, {}, to_rates(rates));
+    auto m = strategy.find_movement({});
+    BOOST_REQUIRE(m);
+    // the hottest groups lead on node 0, one of them has to move away
+    BOOST_REQUIRE_EQUAL(m->from.node_id, model::node_id(0));
+    BOOST_REQUIRE_NE(m->to.node_id, model::node_id(0));
+    BOOST_REQUIRE(m->group == raft::group_id(0) || m->group == raft::group_id(1));
+
+    // unless they are muted
+    m = strategy.find_movement({raft::group_id(0), raft::group_id(1)});
+    BOOST_REQUIRE(m);
+    BOOST_REQUIRE_NE(m->group, raft::group_id(0));
+    BOOST_REQUIRE_NE(m->group, raft::group_id(1));
+}
+
+BOOST_AUTO_TEST_CASE(throughput_muted_nodes) {
+    std::vector<double> rates(100, 1_KiB);
+    rates[0] = 10_MiB;
+    auto index = skewed_placement(rates);
+
+    // leaders are neither moved to nor away from a muted node
+    const model::node_id muted(1);
+    cluster::throughput_balanced_shards strategy(
+      index, {muted}, to_rates(rates));
+    size_t moves = 0;
+    while (auto m = strategy.find_movement({})) {
+        BOOST_REQUIRE_NE(m->from.node_id, muted);
+        BOOST_REQUIRE_NE(m->to.node_id, muted);
+        strategy.apply_movement(*m);
+        BOOST_REQUIRE_LT(++moves, max_moves);
+    }
+    BOOST_REQUIRE_GT(moves, 0);
+}
+
+/*
+ * health report of a node leading (or claiming to lead) partition 0 of topic
+ * "t" that got `bytes` produced and fetched since the partition was created
+ */
+static cluster::cluster_health_report throughput_report(
+  model::node_id node,
+  std::chrono::milliseconds uptime,
+  model::node_id leader,
+  uint64_t bytes) {
+    cluster::node_health_report nr;
+    nr.id = node;
+    nr.local_state.uptime = uptime;
+    nr.topics.push_back(cluster::topic_status{
+      .tp_ns = model::topic_namespace(model::ns("kafka"), model::topic("t")),
+      .partitions = {cluster::partition_status{
+        .id = model::partition_id(0),
+        .term = model::term_id(1),
+        .leader_id = leader,
+        .revision_id = model::revision_id(1),
+        .throughput = cluster::partition_throughput{
+          .bytes_produced = bytes / 2,
+          .bytes_fetched = bytes - bytes / 2,
+        }}}});
+    cluster::cluster_health_report report;
+    report.node_reports.push_back(std::move(nr));
+    return report;
+}
+
+BOOST_AUTO_TEST_CASE(throughput_rates_sampled_by_uptime) {
+    using namespace std::chrono_literals;
+    const model::ntp ntp(
+      model::ns("kafka"), model::topic("t"), model::partition_id(0));
+    const model::node_id n1(1);
+    const model::node_id n2(2);
+    cluster::throughput_tracker tracker;
+
+    // a single sample has no rate
+    tracker.update(throughput_report(n1, 10s, n1, 1000));
+    BOOST_REQUIRE(!tracker.rate(ntp));
+
+    tracker.update(throughput_report(n1, 20s, n1, 6000));
+    BOOST_REQUIRE_EQUAL(*tracker.rate(ntp), 500.0);
+
+    // a cached report of the same uptime is not a new sample
+    tracker.update(throughput_report(n1, 20s, n1, 6000));
+    BOOST_REQUIRE_EQUAL(*tracker.rate(ntp), 500.0);
+
+    // the node restarted, counters start over and the last rate is kept
+    tracker.update(throughput_report(n1, 5s, n1, 100));
+    BOOST_REQUIRE_EQUAL(*tracker.rate(ntp), 500.0);
+    tracker.update(throughput_report(n1, 7s, n1, 300));
+    BOOST_REQUIRE_EQUAL(*tracker.rate(ntp), 100.0);
+
+    // leadership moved, the counters of the new leader are a new series
+    tracker.update(throughput_report(n2, 50s, n2, 10));
+    BOOST_REQUIRE_EQUAL(*tracker.rate(ntp), 100.0);
+    tracker.update(throughput_report(n2, 52s, n2, 410));
+    BOOST_REQUIRE_EQUAL(*tracker.rate(ntp), 200.0);
+
+    // reports of a stale leader are skipped, the partition is dropped once
+    // no leader reports it anymore
+    tracker.update(throughput_report(n1, 60s, n2, 1000000));
+    BOOST_REQUIRE(!tracker.rate(ntp));
+    BOOST_REQUIRE_EQUAL(tracker.size(), size_t(0));
+}
@@ -20,6 +20,7 @@
 #include "test_utils/rpc.h"
 #include "tristate.h"
 #include "units.h"
+#include "vassert.h"
 
 #include <seastar/testing/thread_test_case.hh>
 
@@ -452,3 +453,100 @@ SEASTAR_THREAD_TEST_CASE(partition_status_serialization_old_version) {
         BOOST_CHECK(result[i].leader_id == original[i].leader_id);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(partition_status_throughput_serialization_test) {
+    cluster::partition_status status{
+      .id = model::partition_id(10),
+      .term = model::term_id(256),
+      .leader_id = model::node_id(123),
+      .revision_id = model::revision_id(1024),
+      .throughput = cluster::partition_throughput{
+        .bytes_produced = 1_GiB,
+        .bytes_fetched = 3_GiB,
+      },
+    };
+    auto original = status;
+
+    auto result = serialize_roundtrip_rpc(std::move(status));
+
+    BOOST_CHECK(result == original);
+}
+
+// partition status before the throughput was added
+struct partition_status_v1 {
+    model::partition_id id;
+    model::term_id term;
+    std::optional<model::node_id> leader_id;
+    model::revision_id revision_id;
+};
+
+namespace reflection {
+template<>
+struct adl<partition_status_v1> {
+    void to(iobuf& out, partition_status_v1&& s) {
+        serialize(out, int8_t(-1), s.id, s.term, s.leader_id, s.revision_id);
+    }
+
+    partition_status_v1 from(iobuf_parser& p) {
+        auto version = adl<int8_t>{}.from(p);
+        vassert(version >= -1, "unsupported partition status version");
+        auto id = adl<model::partition_id>{}.from(p);
+        auto term = adl<model::term_id>{}.from(p);
+        auto leader = adl<std::optional<model::node_id>>{}.from(p);
+        model::revision_id revision;
+        if (version < 0) {
+            revision = adl<model::revision_id>{}.from(p);
+        }
+        return partition_status_v1{
+          .id = id,
+          .term = term,
+          .leader_id = leader,
+          .revision_id = revision,
+        };
+    }
+};
+} // namespace reflection
+
+SEASTAR_THREAD_TEST_CASE(partition_status_throughput_backward_compat_test) {
+    // reports of older nodes have no throughput
+    partition_status_v1 status{
+      .id = model::partition_id(10),
+      .term = model::term_id(256),
+      .leader_id = model::node_id(123),
+      .revision_id = model::revision_id(1024),
+    };
+    auto original = status;
+    auto result = reflection::from_iobuf<cluster::partition_status>(
+      reflection::to_iobuf(std::move(status)));
+
+    BOOST_REQUIRE_EQUAL(result.id, original.id);
+    BOOST_REQUIRE_EQUAL(result.term, original.term);
+    BOOST_REQUIRE_EQUAL(result.leader_id, original.leader_id);
+    BOOST_REQUIRE_EQUAL(result.revision_id, original.revision_id);
+    BOOST_REQUIRE(!result.throughput);
+}
+
+SEASTAR_THREAD_TEST_CASE(partition_status_throughput_old_version) {
+    // the throughput is cleared for older requesters, the status is then
+    // encoded with the version they know
+    std::vector<cluster::partition_status> statuses;
+    for (int i = 0; i < 2; ++i) {
+        statuses.push_back(cluster::partition_status{
+          .id = model::partition_id(i),
+          .term = model::term_id(256),
+          .leader_id = model::node_id(123),
+          .revision_id = model::revision_id(1024),
+        });
+    }
+
+    auto original = statuses;
+    auto result = reflection::from_iobuf<std::vector<partition_status_v1>>(
+      reflection::to_iobuf(std::move(statuses)));
+    BOOST_REQUIRE_EQUAL(result.size(), original.size());
+    for (size_t i = 0; i < original.size(); ++i) {
+        BOOST_CHECK(result[i].id == original[i].id);
+        BOOST_CHECK(result[i].term == original[i].term);
+        BOOST_CHECK(result[i].leader_id == original[i].leader_id);
+        BOOST_CHECK(result[i].revision_id == original[i].revision_id);
+    }
+}
@@ -175,6 +175,25 @@ configuration::configuration()
       "connection.  Set to 0 to disable force disconnection.",
       {.visibility = visibility::tunable},
       3)
+  , raft_quiescent_heartbeats(
+      *this,
+      "raft_quiescent_heartbeats",
+      "Stop sending heartbeats for idle raft groups whose followers are up to "
+      "date, a single node level heartbeat per node pair keeps them alive",
+      {.needs_restart = needs_restart::no,
+       .example = "true",
+       .visibility = visibility::tunable},
+      false)
+  , raft_quiescent_group_lease_ms(
+      *this,
+      "raft_quiescent_group_lease_ms",
+      "Milliseconds a follower of an idle raft group relies on node level "
+      "heartbeats of its leader. Leaders refresh idle groups with a regular "
+      "heartbeat every half of it",
+      {.needs_restart = needs_restart::no,
+       .example = "10000",
+       .visibility = visibility::tunable},
+      10s)
 
   , min_version(*this, "min_version")
   , max_version(*this, "max_version")
@@ -195,6 +214,14 @@ configuration::configuration()
       {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
       512_KiB,
       {.min = 128, .max = 5_MiB})
+  , raft_install_snapshot_chunk_size(
+      *this,
+      "raft_install_snapshot_chunk_size",
+      "Size of the snapshot chunks sent to a follower in install snapshot "
+      "requests",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      512_KiB,
+      {.min = 4_KiB, .max = 5_MiB})
   , use_scheduling_groups(*this, "use_scheduling_groups")
   , enable_admin_api(*this, "enable_admin_api")
   , default_num_windows(
@@ -220,12 +247,40 @@ configuration::configuration()
   , target_quota_byte_rate(
       *this,
       "target_quota_byte_rate",
-      "Target quota byte rate (bytes per second) - 2GB default",
+      "Target produce quota byte rate (bytes per second) of a client on a "
+      "node - 2GB default",
       {.needs_restart = needs_restart::no,
        .example = "1073741824",
        .visibility = visibility::user},
       2_GiB,
       {.min = 1_MiB})
+  , target_fetch_quota_byte_rate(
+      *this,
+      "target_fetch_quota_byte_rate",
+      "Target fetch quota byte rate (bytes per second) of a client on a node "
+      "- disabled default",
+      {.needs_restart = needs_restart::no,
+       .example = "1073741824",
+       .visibility = visibility::user},
+      std::nullopt,
+      {.min = 1_MiB})
+  , target_request_time_quota_percent(
+      *this,
+      "target_request_time_quota_percent",
+      "Target share of the time of one core (percent) spent handling the "
+      "requests of a client on a node - disabled default",
+      {.needs_restart = needs_restart::no,
+       .example = "200",
+       .visibility = visibility::user},
+      std::nullopt,
+      {.min = 1})
+  , quota_manager_reduce_interval_ms(
+      *this,
+      "quota_manager_reduce_interval_ms",
+      "Interval at which the client rates of all cores are summed up, the "
+      "node wide rates used for throttling are at most this old",
+      {.visibility = visibility::tunable},
+      std::chrono::milliseconds(100))
   , cluster_id(
       *this,
       "cluster_id",
@@ -327,8 +382,8 @@ configuration::configuration()
   , fetch_reads_debounce_timeout(
       *this,
       "fetch_reads_debounce_timeout",
-      "Time to wait for next read in fetch request when requested min bytes "
-      "wasn't reached",
+      "Minimum time between reads of a fetch request when requested min "
+      "bytes wasn't reached",
       {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
       1ms)
   , alter_topic_cfg_timeout_ms(
@@ -392,6 +447,36 @@ configuration::configuration()
        .visibility = visibility::user},
       {},
       validate_connection_rate)
+  , kafka_max_inflight_requests_per_connection(
+      *this,
+      "kafka_max_inflight_requests_per_connection",
+      "Maximum number of requests of a connection that are handled "
+      "concurrently or whose responses wait to be written",
+      {.visibility = visibility::tunable},
+      64,
+      {.min = 1})
+  , kafka_produce_validation_listeners(
+      *this,
+      "kafka_produce_validation_listeners",
+      "Validation level of produced batches for specific kafka listeners: "
+      "full (crc and records), crc or header. Batches produced through other "
+      "listeners are fully validated",
+      {.needs_restart = needs_restart::no,
+       .example = R"(['internal:header', 'replication:crc'])",
+       .visibility = visibility::tunable},
+      {},
+      validate_produce_validation_overrides)
+  , kafka_produce_validation_principals(
+      *this,
+      "kafka_produce_validation_principals",
+      "Validation level of produced batches for specific principals, takes "
+      "precedence over the listener level: full (crc and records), crc or "
+      "header",
+      {.needs_restart = needs_restart::no,
+       .example = R"(['ingest:header'])",
+       .visibility = visibility::tunable},
+      {},
+      validate_produce_validation_overrides)
   , transactional_id_expiration_ms(
       *this,
       "transactional_id_expiration_ms",
@@ -560,6 +645,15 @@ configuration::configuration()
       "one follower",
       {.visibility = visibility::tunable},
       16)
+  , raft_group_commit_window_us(
+      *this,
+      "raft_group_commit_window_us",
+      "Microseconds raft log flushes of all groups on a shard are collected "
+      "for before they are issued as a single round. Disabled if 0",
+      {.needs_restart = needs_restart::no,
+       .example = "500",
+       .visibility = visibility::tunable},
+      0)
   , reclaim_min_size(
       *this,
       "reclaim_min_size",
@@ -590,6 +684,14 @@ configuration::configuration()
       "Free memory limit that will be kept by batch cache background reclaimer",
       {.visibility = visibility::tunable},
       64_MiB)
+  , batch_cache_compressed_tier_size(
+      *this,
+      "batch_cache_compressed_tier_size",
+      "Memory used by the compressed second tier of the batch cache. Ranges "
+      "evicted by the background reclaimer are kept lz4 compressed in this "
+      "tier and promoted back on hit. Disabled if 0",
+      {.example = "67108864", .visibility = visibility::tunable},
+      0)
   , auto_create_topics_enabled(
       *this,
       "auto_create_topics_enabled",
@@ -691,6 +793,51 @@ configuration::configuration()
       "How many additional reads to issue ahead of current read location",
       {.example = "1", .visibility = visibility::tunable},
       10)
+  , storage_read_readahead_max_bytes(
+      *this,
+      "storage_read_readahead_max_bytes",
+      "Max bytes in flight per segment stream. Readers scanning a log in "
+      "order grow their read-ahead up to this limit",
+      {.needs_restart = needs_restart::no,
+       .example = "16777216",
+       .visibility = visibility::tunable},
+      16_MiB)
+  , storage_segment_index_memory_budget(
+      *this,
+      "storage_segment_index_memory_budget",
+      "Max memory per shard used by in-memory segment indices. Indices of "
+      "cold segments over the budget are evicted and reloaded on demand. "
+      "Unlimited if unset",
+      {.needs_restart = needs_restart::no,
+       .example = "67108864",
+       .visibility = visibility::tunable},
+      std::nullopt)
+  , storage_compaction_key_map_memory(
+      *this,
+      "storage_compaction_key_map_memory",
+      "Max memory used by the key map while compacting a segment. Keys "
+      "beyond it are spilled to disk as sorted runs and merged",
+      {.needs_restart = needs_restart::no,
+       .example = "33554432",
+       .visibility = visibility::tunable},
+      32_MiB)
+  , storage_compaction_max_adjacent_segments(
+      *this,
+      "storage_compaction_max_adjacent_segments",
+      "Max number of adjacent segments combined in a single compaction pass",
+      {.needs_restart = needs_restart::no,
+       .example = "32",
+       .visibility = visibility::tunable},
+      32)
+  , storage_max_concurrent_compactions(
+      *this,
+      "storage_max_concurrent_compactions",
+      "Max number of partitions compacted concurrently on a shard. The "
+      "compaction controller scales the actual number with the backlog",
+      {.needs_restart = needs_restart::no,
+       .example = "4",
+       .visibility = visibility::tunable},
+      4)
   , segment_fallocation_step(
       *this,
       "segment_fallocation_step",
@@ -1065,6 +1212,13 @@ configuration::configuration()
       "Leadership rebalancing node mute timeout",
       {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
       20s)
+  , leader_balancer_throughput_aware(
+      *this,
+      "leader_balancer_throughput_aware",
+      "Balance leadership by the produce and fetch byte rates of the "
+      "partitions instead of by the number of leaders",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      false)
   , internal_topic_replication_factor(
       *this,
       "internal_topic_replication_factor",
@@ -1142,6 +1296,13 @@ configuration::configuration()
       "enable_rack_awareness",
       "Enables rack-aware replica assignment",
       {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      false)
+  , enable_follower_fetching(
+      *this,
+      "enable_follower_fetching",
+      "Allow consumers to fetch from followers. Consumers that report their "
+      "rack are pointed to an in-sync replica in the same rack",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
       false) {}
 
 configuration::error_map_t configuration::load(const YAML::Node& root_node) {
@@ -67,10 +67,13 @@ struct configuration final : public config_store {
     bounded_property<std::chrono::milliseconds> raft_heartbeat_interval_ms;
     bounded_property<std::chrono::milliseconds> raft_heartbeat_timeout_ms;
     property<size_t> raft_heartbeat_disconnect_failures;
+    property<bool> raft_quiescent_heartbeats;
+    property<std::chrono::milliseconds> raft_quiescent_group_lease_ms;
     deprecated_property min_version;
     deprecated_property max_version;
     bounded_property<std::optional<size_t>> raft_max_recovery_memory;
     bounded_property<size_t> raft_recovery_default_read_size;
+    bounded_property<size_t> raft_install_snapshot_chunk_size;
     // Kafka
     deprecated_property use_scheduling_groups;
     deprecated_property enable_admin_api;
@@ -78,6 +81,10 @@ struct configuration final : public config_store {
     bounded_property<std::chrono::milliseconds> default_window_sec;
     property<std::chrono::milliseconds> quota_manager_gc_sec;
     bounded_property<uint32_t> target_quota_byte_rate;
+    bounded_property<std::optional<uint32_t>> target_fetch_quota_byte_rate;
+    bounded_property<std::optional<uint32_t>>
+      target_request_time_quota_percent;
+    property<std::chrono::milliseconds> quota_manager_reduce_interval_ms;
     property<std::optional<ss::sstring>> cluster_id;
     property<bool> disable_metrics;
     property<std::chrono::milliseconds> group_min_session_timeout_ms;
@@ -102,6 +109,9 @@ struct configuration final : public config_store {
     property<std::chrono::milliseconds> metadata_status_wait_timeout_ms;
     bounded_property<std::optional<int64_t>> kafka_connection_rate_limit;
     property<std::vector<ss::sstring>> kafka_connection_rate_limit_overrides;
+    bounded_property<uint32_t> kafka_max_inflight_requests_per_connection;
+    property<std::vector<ss::sstring>> kafka_produce_validation_listeners;
+    property<std::vector<ss::sstring>> kafka_produce_validation_principals;
     // same as transactional.id.expiration.ms in kafka
     property<std::chrono::milliseconds> transactional_id_expiration_ms;
     property<bool> enable_idempotence;
@@ -135,12 +145,14 @@ struct configuration final : public config_store {
     property<size_t> raft_learner_recovery_rate;
     property<uint32_t> raft_smp_max_non_local_requests;
     property<uint32_t> raft_max_concurrent_append_requests_per_follower;
+    property<uint32_t> raft_group_commit_window_us;
 
     property<size_t> reclaim_min_size;
     property<size_t> reclaim_max_size;
     property<std::chrono::milliseconds> reclaim_growth_window;
     property<std::chrono::milliseconds> reclaim_stable_window;
     property<size_t> reclaim_batch_cache_min_free;
+    property<size_t> batch_cache_compressed_tier_size;
     property<bool> auto_create_topics_enabled;
     property<bool> enable_pid_file;
     property<std::chrono::milliseconds> kvstore_flush_interval;
@@ -158,6 +170,11 @@ struct configuration final : public config_store {
     bounded_property<size_t> append_chunk_size;
     property<size_t> storage_read_buffer_size;
     property<int16_t> storage_read_readahead_count;
+    property<size_t> storage_read_readahead_max_bytes;
+    property<std::optional<size_t>> storage_segment_index_memory_budget;
+    property<size_t> storage_compaction_key_map_memory;
+    property<size_t> storage_compaction_max_adjacent_segments;
+    property<size_t> storage_max_concurrent_compactions;
     property<size_t> segment_fallocation_step;
     property<size_t> max_compacted_log_segment_size;
     property<int16_t> id_allocator_log_capacity;
@@ -236,6 +253,7 @@ struct configuration final : public config_store {
     property<std::chrono::milliseconds> leader_balancer_idle_timeout;
     property<std::chrono::milliseconds> leader_balancer_mute_timeout;
     property<std::chrono::milliseconds> leader_balancer_node_mute_timeout;
+    property<bool> leader_balancer_throughput_aware;
     property<int> internal_topic_replication_factor;
     property<std::chrono::milliseconds> health_manager_tick_interval;
 
@@ -254,6 +272,9 @@ struct configuration final : public config_store {
 
     // enables rack aware replica assignment
     property<bool> enable_rack_awareness;
+    // serve consumer fetches from followers and point consumers to the
+    // replica in their rack (KIP-392)
+    property<bool> enable_follower_fetching;
 
     configuration();
 
@@ -67,4 +67,38 @@ validate_connection_rate(const std::vector<ss::sstring>& ips_with_limit) {
     return std::nullopt;
 }
 
+std::optional<std::pair<std::string_view, std::string_view>>
+parse_produce_validation_override(std::string_view raw_option) {
+    auto del_pos = raw_option.rfind(':');
+    if (
+      del_pos == std::string_view::npos || del_pos == 0
+      || del_pos == raw_option.size() - 1) {
+        return std::nullopt;
+    }
+    return std::make_pair(
+      raw_option.substr(0, del_pos), raw_option.substr(del_pos + 1));
+}
+
+std::optional<ss::sstring>
+validate_produce_validation_overrides(const std::vector<ss::sstring>& values) {
+    absl::node_hash_set<ss::sstring> names;
+    for (const auto& v : values) {
+        auto parsed = parse_produce_validation_override(v);
+        if (!parsed) {
+            return fmt::format("Can not parse validation level override {}", v);
+        }
+        auto level = parsed->second;
+        if (level != "full" && level != "crc" && level != "header") {
+            return fmt::format(
+              "Unknown validation level {}, expected full, crc or header",
+              level);
+        }
+        if (!names.emplace(parsed->first).second) {
+            return fmt::format(
+              "Duplicate validation level for: {}", parsed->first);
+        }
+    }
+    return std::nullopt;
+}
+
 }; // namespace config
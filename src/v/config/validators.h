@@ -16,6 +16,7 @@
 #include <seastar/core/sstring.hh>
 
 #include <optional>
+#include <string_view>
 
 namespace config {
 
@@ -25,4 +26,14 @@ parse_connection_rate_override(const ss::sstring& raw_option);
 std::optional<ss::sstring>
 validate_connection_rate(const std::vector<ss::sstring>& ips_with_limit);
 
+/**
+ * Splits a "<name>:<level>" override of the produce validation level, the
+ * name may contain colons.
+ */
+std::optional<std::pair<std::string_view, std::string_view>>
+parse_produce_validation_override(std::string_view raw_option);
+
+std::optional<ss::sstring>
+validate_produce_validation_overrides(const std::vector<ss::sstring>&);
+
 }; // namespace config
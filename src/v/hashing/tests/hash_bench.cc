@@ -11,6 +11,8 @@
 #include "hashing/fnv.h"
 #include "hashing/twang.h"
 #include "hashing/xx.h"
+#include "model/record.h"
+#include "model/record_utils.h"
 #include "random/generators.h"
 
 #include <seastar/core/reactor.hh>
@@ -72,3 +74,71 @@ PERF_TEST(xx64_twang_fn, header_hash) {
     perf_tests::do_not_optimize(o);
     perf_tests::stop_measuring_time();
 }
+
+static model::record_batch_header random_batch_header() {
+    model::record_batch_header hdr;
+    hdr.size_bytes = random_generators::get_int<int32_t>();
+    hdr.base_offset = model::offset(random_generators::get_int<int64_t>());
+    hdr.type = model::record_batch_type::raft_data;
+    hdr.crc = random_generators::get_int<int32_t>();
+    hdr.attrs = model::record_batch_attributes(
+      random_generators::get_int<int16_t>());
+    hdr.last_offset_delta = random_generators::get_int<int32_t>();
+    hdr.first_timestamp = model::timestamp(
+      random_generators::get_int<int64_t>());
+    hdr.max_timestamp = model::timestamp(random_generators::get_int<int64_t>());
+    hdr.producer_id = random_generators::get_int<int64_t>();
+    hdr.producer_epoch = random_generators::get_int<int16_t>();
+    hdr.base_sequence = random_generators::get_int<int32_t>();
+    hdr.record_count = random_generators::get_int<int32_t>();
+    return hdr;
+}
+
+// the header part of the kafka batch crc
+PERF_TEST(record_batch_header, kafka_crc) {
+    auto hdr = random_batch_header();
+    crc::crc32c crc;
+    perf_tests::start_measuring_time();
+    model::crc_record_batch_header(crc, hdr);
+    auto o = crc.value();
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+PERF_TEST(record_batch_header, header_crc) {
+    auto hdr = random_batch_header();
+    perf_tests::start_measuring_time();
+    auto o = model::internal_header_only_crc(hdr);
+    perf_tests::do_not_optimize(o);
+    perf_tests::stop_measuring_time();
+}
+
+/*
+ * crc32c throughput. each test reports the time per byte hashed, so the
+ * throughput in GB/s per core is the inverse of the reported time in ns.
+ */
+template<size_t Size>
+struct crc32c_throughput {
+    crc32c_throughput()
+      : buffer(random_generators::gen_alphanum_string(Size)) {}
+
+    size_t run() {
+        crc::crc32c crc;
+        perf_tests::start_measuring_time();
+        crc.extend(buffer.data(), buffer.size());
+        auto o = crc.value();
+        perf_tests::do_not_optimize(o);
+        perf_tests::stop_measuring_time();
+        return buffer.size();
+    }
+
+    ss::sstring buffer;
+};
+
+using crc32c_throughput_4k = crc32c_throughput<4096>;
+using crc32c_throughput_128k = crc32c_throughput<128 * 1024>;
+using crc32c_throughput_1m = crc32c_throughput<1024 * 1024>;
+
+PERF_TEST_F(crc32c_throughput_4k, bytes) { return run(); }
+PERF_TEST_F(crc32c_throughput_128k, bytes) { return run(); }
+PERF_TEST_F(crc32c_throughput_1m, bytes) { return run(); }
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/metrics.hh>
+
+namespace kafka {
+
+/**
+ * Requests pipelined on the connections of a shard. A request is in flight
+ * from its dispatch until its response was written, a response is blocked at
+ * the head of the line while it waits for the responses of earlier requests.
+ */
+class pipeline_probe {
+public:
+    void setup_metrics() {
+        namespace sm = ss::metrics;
+
+        if (config::shard_local_cfg().disable_metrics()) {
+            return;
+        }
+        std::vector<sm::label_instance> labels{
+          sm::label("latency_metric")("microseconds")};
+        _metrics.add_group(
+          prometheus_sanitize::metrics_name("kafka:pipeline"),
+          {sm::make_gauge(
+             "inflight_requests",
+             [this] { return _inflight; },
+             sm::description(
+               "Number of requests in flight on all connections")),
+           sm::make_gauge(
+             "blocked_responses",
+             [this] { return _blocked; },
+             sm::description(
+               "Number of responses waiting for the responses of earlier "
+               "requests")),
+           sm::make_derive(
+             "window_full",
+             [this] { return _window_full; },
+             sm::description(
+               "Number of requests that waited for the in flight window of "
+               "their connection")),
+           sm::make_histogram(
+             "head_of_line_blocking_us",
+             sm::description(
+               "Time a response waited for the responses of earlier requests"),
+             labels,
+             [this] { return _hol_blocking.seastar_histogram_logform(); })});
+    }
+
+    // a response blocked at the head of the line, until it may be written
+    class hol_measurement {
+    public:
+        explicit hol_measurement(pipeline_probe& probe)
+          : _probe(probe)
+          , _measurement(probe._hol_blocking.auto_measure()) {
+            ++_probe._blocked;
+        }
+        hol_measurement(const hol_measurement&) = delete;
+        hol_measurement(hol_measurement&&) = delete;
+        hol_measurement& operator=(const hol_measurement&) = delete;
+        hol_measurement& operator=(hol_measurement&&) = delete;
+
+        ~hol_measurement() noexcept { --_probe._blocked; }
+
+    private:
+        pipeline_probe& _probe;
+        std::unique_ptr<hdr_hist::measurement> _measurement;
+    };
+
+    void request_dispatched() { ++_inflight; }
+    void response_written() { --_inflight; }
+    void window_full() { ++_window_full; }
+
+    std::unique_ptr<hol_measurement> auto_hol_measurement() {
+        return std::make_unique<hol_measurement>(*this);
+    }
+
+    uint64_t inflight_requests() const { return _inflight; }
+    uint64_t blocked_responses() const { return _blocked; }
+    uint64_t window_full_requests() const { return _window_full; }
+
+private:
+    uint64_t _inflight{0};
+    uint64_t _blocked{0};
+    uint64_t _window_full{0};
+    hdr_hist _hol_blocking;
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace kafka
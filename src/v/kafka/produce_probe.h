@@ -0,0 +1,64 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+
+#include <seastar/core/metrics.hh>
+
+namespace kafka {
+
+/**
+ * Work done on the produced batches before they are appended. A bulk ingest
+ * path of trusted v2 clients validated at the header level neither
+ * checksums nor decompresses anything.
+ */
+class produce_probe {
+public:
+    void setup_metrics() {
+        namespace sm = ss::metrics;
+
+        if (config::shard_local_cfg().disable_metrics()) {
+            return;
+        }
+        _metrics.add_group(
+          prometheus_sanitize::metrics_name("kafka:produce"),
+          {sm::make_derive(
+             "decompressed_bytes",
+             [this] { return _decompressed_bytes; },
+             sm::description(
+               "Number of bytes decompressed while handling produce requests")),
+           sm::make_derive(
+             "crc_verified_bytes",
+             [this] { return _crc_verified_bytes; },
+             sm::description("Number of produced bytes whose crc was verified")),
+           sm::make_derive(
+             "unverified_batches",
+             [this] { return _unverified_batches; },
+             sm::description(
+               "Number of produced batches of which only the header was "
+               "validated"))});
+    }
+
+    void add_decompressed_bytes(uint64_t b) { _decompressed_bytes += b; }
+    void add_crc_verified_bytes(uint64_t b) { _crc_verified_bytes += b; }
+    void unverified_batch() { ++_unverified_batches; }
+
+private:
+    uint64_t _decompressed_bytes{0};
+    uint64_t _crc_verified_bytes{0};
+    uint64_t _unverified_batches{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace kafka
@@ -30,6 +30,30 @@
 
 namespace kafka {
 
+std::optional<batch_validation_level>
+batch_validation_level_from_string(std::string_view s) {
+    if (s == "full") {
+        return batch_validation_level::full;
+    } else if (s == "crc") {
+        return batch_validation_level::crc;
+    } else if (s == "header") {
+        return batch_validation_level::header;
+    }
+    return std::nullopt;
+}
+
+std::ostream& operator<<(std::ostream& o, batch_validation_level l) {
+    switch (l) {
+    case batch_validation_level::full:
+        return o << "full";
+    case batch_validation_level::crc:
+        return o << "crc";
+    case batch_validation_level::header:
+        return o << "header";
+    }
+    return o << "unknown";
+}
+
 model::record_batch_header kafka_batch_adapter::read_header(iobuf_parser& in) {
     const size_t initial_bytes_consumed = in.bytes_consumed();
 
@@ -135,6 +159,12 @@ void kafka_batch_adapter::verify_crc(int32_t expected_crc, iobuf_parser in) {
 }
 
 iobuf kafka_batch_adapter::adapt(iobuf&& kbatch) {
+    auto remainder = adapt_header(std::move(kbatch));
+    validate(batch_validation_level::full);
+    return remainder;
+}
+
+iobuf kafka_batch_adapter::adapt_header(iobuf&& kbatch) {
     // The batch size given in the kafka header does not include the offset
     // preceeding the length field nor the size of the length field itself.
     constexpr size_t kafka_length_diff
@@ -156,7 +186,7 @@ iobuf kafka_batch_adapter::adapt(iobuf&& kbatch) {
       batch_length, kbatch.size_bytes() - batch_length);
     kbatch.trim_back(remainder.size_bytes());
 
-    auto crcparser = iobuf_parser(kbatch.share(0, kbatch.size_bytes()));
+    auto crc_data = kbatch.share(0, kbatch.size_bytes());
     auto parser = iobuf_parser(std::move(kbatch));
 
     auto header = read_header(parser);
@@ -167,35 +197,56 @@ iobuf kafka_batch_adapter::adapt(iobuf&& kbatch) {
         return remainder;
     }
 
-    verify_crc(header.crc, std::move(crcparser));
-    if (unlikely(!valid_crc)) {
-        vlog(klog.error, "batch has invalid CRC: {}", header);
-        return remainder;
-    }
-
     auto records_size = header.size_bytes
                         - model::packed_record_batch_header_size;
     auto records = parser.share(records_size);
 
-    auto new_batch = model::record_batch(
+    batch = model::record_batch(
       header, std::move(records), model::record_batch::tag_ctor_ng{});
+    _unverified = std::move(crc_data);
+    // until validated
+    valid_crc = true;
+    return remainder;
+}
+
+std::optional<size_t>
+kafka_batch_adapter::validate(batch_validation_level level) {
+    if (!batch || !_unverified) {
+        return std::nullopt;
+    }
+    auto crc_data = std::move(*_unverified);
+    _unverified.reset();
+    if (level == batch_validation_level::header) {
+        return 0;
+    }
+
+    const auto checksummed = crc_data.size_bytes();
+    verify_crc(batch->header().crc, iobuf_parser(std::move(crc_data)));
+    if (unlikely(!valid_crc)) {
+        vlog(klog.error, "batch has invalid CRC: {}", batch->header());
+        batch.reset();
+        return checksummed;
+    }
+
+    if (level == batch_validation_level::crc) {
+        return checksummed;
+    }
 
     /**
      * Perform some type of validation on the uncompressed input. In this case
      * we make sure that the records can be materialized but we avoid
-     * re-encoding them using the lazy-record optimization.
+     * re-encoding them using the lazy-record optimization. Compressed batches
+     * are not decompressed for the validation.
      */
-    if (!new_batch.compressed()) {
+    if (!batch->compressed()) {
         try {
-            new_batch.for_each_record([](model::record r) { (void)r; });
+            batch->for_each_record([](model::record r) { (void)r; });
         } catch (const std::exception& e) {
             vlog(klog.error, "Parsing uncompressed records: {}", e.what());
-            return remainder;
+            batch.reset();
         }
     }
-
-    batch = std::move(new_batch);
-    return remainder;
+    return checksummed;
 }
 
 /*
@@ -269,6 +320,7 @@ void kafka_batch_adapter::convert_message_set(
 
         auto batch_data = compression::compressor::uncompress(
           *batch->value, batch->compression());
+        decompressed_bytes += batch_data.size_bytes();
 
         convert_message_set(builder, std::move(batch_data), true);
     }
@@ -277,7 +329,7 @@ void kafka_batch_adapter::convert_message_set(
 void kafka_batch_adapter::adapt_with_version(
   iobuf kbatch, api_version version) {
     if (version >= api_version(3)) {
-        adapt(std::move(kbatch));
+        adapt_header(std::move(kbatch));
         return;
     }
 
@@ -18,6 +18,9 @@
 #include "storage/record_batch_builder.h"
 #include "utils/vint.h"
 
+#include <optional>
+#include <string_view>
+
 namespace kafka {
 
 namespace internal {
@@ -38,6 +41,23 @@ constexpr size_t kafka_header_size = sizeof(int64_t) + // base offset
 
 } // namespace internal
 
+/**
+ * How much of a produced batch is validated before it is appended
+ */
+enum class batch_validation_level : int8_t {
+    // header, crc and the records of uncompressed batches
+    full,
+    // header and crc
+    crc,
+    // only the header, for trusted clients
+    header,
+};
+
+std::optional<batch_validation_level>
+batch_validation_level_from_string(std::string_view);
+
+std::ostream& operator<<(std::ostream&, batch_validation_level);
+
 /**
  * Usage:
  *
@@ -56,6 +76,10 @@ constexpr size_t kafka_header_size = sizeof(int64_t) + // base offset
  *    wire than a single batch.
  *
  * Note that the default constructed batch adapter is in an undefined state.
+ *
+ * adapt_with_version() used when decoding produce requests only parses the
+ * batch header, the produce handler validates the batch with validate() once
+ * it knows the validation level of the client.
  */
 class kafka_batch_adapter {
 public:
@@ -64,15 +88,30 @@ public:
     bool v2_format;
     bool valid_crc;
     bool legacy_error{false};
+    // bytes of compressed legacy messages that had to be decompressed to
+    // convert them to a v2 batch
+    size_t decompressed_bytes{0};
 
     std::optional<model::record_batch> batch;
 
     void adapt_with_version(iobuf, api_version);
 
+    /**
+     * Validates the batch parsed with adapt_with_version(), the batch is
+     * reset if it is not valid. Returns the number of checksummed bytes or
+     * nullopt if there was nothing to validate, e.g. for converted legacy
+     * messages.
+     */
+    std::optional<size_t> validate(batch_validation_level);
+
 private:
+    iobuf adapt_header(iobuf&&);
     void verify_crc(int32_t, iobuf_parser);
     model::record_batch_header read_header(iobuf_parser&);
     void convert_message_set(storage::record_batch_builder&, iobuf, bool);
+
+    // checksummed data of a batch that was not validated yet
+    std::optional<iobuf> _unverified;
 };
 
 /*
@@ -27,6 +27,8 @@
 
 #include <boost/range/numeric.hpp>
 
+#include <array>
+#include <cstring>
 #include <optional>
 #include <string_view>
 
@@ -135,6 +137,12 @@ public:
         return write(std::move(*rdr).release());
     }
 
+    /// appends already encoded bytes, without a length prefix
+    uint32_t write_raw(const char* data, size_t size) {
+        _out->append(data, size);
+        return size;
+    }
+
     // write bytes directly to output without a length prefix
     uint32_t write_direct(iobuf&& f) {
         auto size = f.size_bytes();
@@ -259,20 +267,36 @@ writer_serialize_batch(response_writer& w, model::record_batch&& batch) {
                 + internal::kafka_header_size - sizeof(int64_t)
                 - sizeof(int32_t);
 
-    w.write(int64_t(batch.base_offset()));
-    w.write(int32_t(size)); // batch length
-    w.write(
-      int32_t(leader_epoch_from_term(batch.term()))); // partition leader epoch
-    w.write(int8_t(2));                               // magic
-    w.write(batch.header().crc);
-    w.write(int16_t(batch.header().attrs.value()));
-    w.write(int32_t(batch.header().last_offset_delta));
-    w.write(int64_t(batch.header().first_timestamp.value()));
-    w.write(int64_t(batch.header().max_timestamp.value()));
-    w.write(int64_t(batch.header().producer_id));
-    w.write(int16_t(batch.header().producer_epoch));
-    w.write(int32_t(batch.header().base_sequence));
-    w.write(int32_t(batch.record_count()));
+    /*
+     * the header has a fixed size, encode it on the stack and append it in
+     * one go instead of one append per field. the records are appended by
+     * reference, so the only per batch copy in the fetch path is the header.
+     */
+    std::array<char, internal::kafka_header_size> hdr;
+    char* out = hdr.data();
+    auto put = [&out](auto v) {
+        auto nv = ss::cpu_to_be(v);
+        std::memcpy(out, &nv, sizeof(nv));
+        out += sizeof(nv);
+    };
+    const auto& h = batch.header();
+    put(int64_t(h.base_offset()));
+    // batch length
+    put(int32_t(size));
+    // partition leader epoch
+    put(int32_t(leader_epoch_from_term(batch.term())));
+    // magic
+    put(int8_t(2));
+    put(h.crc);
+    put(int16_t(h.attrs.value()));
+    put(int32_t(h.last_offset_delta));
+    put(int64_t(h.first_timestamp.value()));
+    put(int64_t(h.max_timestamp.value()));
+    put(int64_t(h.producer_id));
+    put(int16_t(h.producer_epoch));
+    put(int32_t(h.base_sequence));
+    put(int32_t(h.record_count));
+    w.write_raw(hdr.data(), hdr.size());
     w.write_direct(std::move(batch).release_data());
 }
 
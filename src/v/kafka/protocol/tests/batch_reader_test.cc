@@ -221,3 +221,33 @@ SEASTAR_THREAD_TEST_CASE(batch_reader_record_batch_reader_impl_fail_magic) {
           return e.error == kafka::error_code::corrupt_message;
       });
 }
+
+SEASTAR_THREAD_TEST_CASE(batch_adapter_deferred_validation) {
+    using level = kafka::batch_validation_level;
+    for (auto l : {level::full, level::crc, level::header}) {
+        auto ctx = make_context(base_offset, few_batches);
+        corrupt_offset<int32_t>(
+          ctx.record_set, crc_offset, [](int32_t& t) { --t; });
+
+        // produce requests only parse the header when decoding
+        kafka::kafka_batch_adapter kba;
+        kba.adapt_with_version(std::move(ctx.record_set), kafka::api_version(7));
+        BOOST_REQUIRE(kba.v2_format);
+        BOOST_REQUIRE(kba.batch);
+
+        auto checksummed = kba.validate(l);
+        BOOST_REQUIRE(checksummed);
+        if (l == level::header) {
+            // trusted client, the crc is not verified
+            BOOST_REQUIRE_EQUAL(*checksummed, 0);
+            BOOST_REQUIRE(kba.valid_crc);
+            BOOST_REQUIRE(kba.batch);
+        } else {
+            BOOST_REQUIRE_GT(*checksummed, 0);
+            BOOST_REQUIRE(!kba.valid_crc);
+            BOOST_REQUIRE(!kba.batch);
+        }
+        // validated once
+        BOOST_REQUIRE(!kba.validate(l));
+    }
+}
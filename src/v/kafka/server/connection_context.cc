@@ -12,6 +12,16 @@
 
 #include "bytes/iobuf.h"
 #include "config/configuration.h"
+#include "kafka/protocol/api_versions.h"
+#include "kafka/protocol/describe_configs.h"
+#include "kafka/protocol/describe_groups.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/protocol/find_coordinator.h"
+#include "kafka/protocol/list_groups.h"
+#include "kafka/protocol/list_offsets.h"
+#include "kafka/protocol/metadata.h"
+#include "kafka/protocol/offset_fetch.h"
+#include "kafka/protocol/produce.h"
 #include "kafka/protocol/sasl_authenticate.h"
 #include "kafka/server/protocol.h"
 #include "kafka/server/protocol_utils.h"
@@ -145,6 +155,27 @@ bool connection_context::is_finished_parsing() const {
     return _rs.conn->input().eof() || _rs.abort_requested();
 }
 
+ss::future<> connection_context::wait_for_inflight_requests() {
+    return ss::get_units(_window, _window_size).discard_result();
+}
+
+/*
+ * requests that only read state may be handled concurrently with each other.
+ * every other request is a barrier: it is dispatched once the handlers of the
+ * earlier requests completed and later requests wait for its first stage, as
+ * e.g. an offset fetch expects an earlier offset commit to be ordered, a
+ * metadata request expects an earlier create topics to be applied and the
+ * group and transactional requests of a client depend on each other.
+ */
+static bool is_pipelined(api_key key) {
+    return key == fetch_api::key || key == metadata_api::key
+           || key == list_offsets_api::key || key == api_versions_api::key
+           || key == describe_configs_api::key
+           || key == find_coordinator_api::key
+           || key == describe_groups_api::key || key == list_groups_api::key
+           || key == offset_fetch_api::key;
+}
+
 ss::future<connection_context::session_resources>
 connection_context::throttle_request(
   const request_header& hdr, size_t request_size) {
@@ -159,38 +190,76 @@ connection_context::throttle_request(
     // distinguish throttling delays from real delays. delays
     // applied to subsequent messages allow backpressure to take
     // affect.
+    //
+    // only the bytes of produce requests count against the produce quota,
+    // fetched bytes and request time are recorded once the request was
+    // handled.
     auto delay = _proto.quota_mgr().record_tp_and_throttle(
-      hdr.client_id, request_size);
+      quota_principal(),
+      hdr.client_id,
+      quota_manager::quota_type::produce,
+      hdr.key == produce_api::key ? request_size : 0);
     auto tracker = std::make_unique<request_tracker>(_rs.probe());
-    auto fut = ss::now();
+    auto track = track_latency(hdr.key);
     if (!delay.first_violation) {
-        fut = ss::sleep_abortable(delay.duration, _rs.abort_source());
+        co_await ss::sleep_abortable(delay.duration, _rs.abort_source());
     }
-    auto track = track_latency(hdr.key);
-    return fut
-      .then(
-        [this, request_size] { return reserve_request_units(request_size); })
-      .then([this, delay, track, tracker = std::move(tracker)](
-              ss::semaphore_units<> units) mutable {
-          return server().get_request_unit().then(
-            [this,
-             delay,
-             mem_units = std::move(units),
-             track,
-             tracker = std::move(tracker)](
-              ss::semaphore_units<> qd_units) mutable {
-                session_resources r{
-                  .backpressure_delay = delay.duration,
-                  .memlocks = std::move(mem_units),
-                  .queue_units = std::move(qd_units),
-                  .tracker = std::move(tracker),
-                };
-                if (track) {
-                    r.method_latency = _rs.hist().auto_measure();
-                }
-                return r;
-            });
-      });
+    // bound the requests of the connection that are handled concurrently or
+    // whose responses wait for the ones of earlier requests
+    if (_window.available_units() <= 0) {
+        _proto.pipeline_probe().window_full();
+    }
+    auto window = co_await ss::get_units(_window, 1);
+    auto mem_units = co_await reserve_request_units(request_size);
+    auto qd_units = co_await server().get_request_unit();
+    session_resources r{
+      .backpressure_delay = delay.duration,
+      .memlocks = std::move(mem_units),
+      .queue_units = std::move(qd_units),
+      .tracker = std::move(tracker),
+      .window = std::make_unique<window_unit>(
+        std::move(window), _proto.pipeline_probe()),
+    };
+    if (track) {
+        r.method_latency = _rs.hist().auto_measure();
+    }
+    co_return r;
+}
+
+std::string_view connection_context::quota_principal() {
+    // connections without an authenticated principal share the anonymous one
+    if (_sasl.has_mechanism()) {
+        return _sasl.principal();
+    }
+    return "";
+}
+
+/*
+ * the request time is the time spent in the first stage, that is where the
+ * handler runs in the foreground, less the time the handler reported as
+ * waiting, e.g. a fetch long poll or reads on other shards. the second stage
+ * only waits, e.g. for the replication of produced batches.
+ */
+void connection_context::record_request_time(const quota_usage& quota) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      quota.timer->handling_time());
+    _proto.quota_mgr().record(
+      quota_principal(),
+      quota.client_id,
+      quota_manager::quota_type::request_time,
+      elapsed.count());
+}
+
+void connection_context::record_fetched_bytes(
+  const quota_usage& quota, const response& r) {
+    if (quota.key != fetch_api::key) {
+        return;
+    }
+    _proto.quota_mgr().record(
+      quota_principal(),
+      quota.client_id,
+      quota_manager::quota_type::fetch,
+      r.buf().size_bytes());
 }
 
 ss::future<ss::semaphore_units<>>
@@ -219,10 +288,47 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
             // protect against shutdown behavior
             return ss::make_ready_future<>();
         }
+        /*
+         * until authentication completed we process requests in order
+         * since all subsequent requests are dependent on it.
+         *
+         * the other important reason for disabling pipeling is because
+         * when a sasl handshake with version=0 is processed, the next
+         * data on the wire is _not_ another request: it is a
+         * size-prefixed authentication payload without a request
+         * envelope, and requires special handling.
+         *
+         * a well behaved client should implicitly provide a data stream
+         * that invokes this behavior in the server: that is, it won't
+         * send auth data (or any other requests) until handshake or the
+         * full auth-process completes, etc... but representing these
+         * nuances of the protocol _explicitly_ in the server makes its
+         * behavior easier to understand and avoids misbehaving clients
+         * creating server-side errors that will appear as a corrupted
+         * stream at best and at worst some odd behavior.
+         *
+         * afterwards the handlers of pipelined requests in the in flight
+         * window run concurrently and only their responses are written
+         * in order, so that e.g. a metadata request isn't stuck behind
+         * a fetch waiting for data. see is_pipelined for the others.
+         */
+        const bool pipelined
+          = sasl().state() == security::sasl_server::sasl_state::complete
+            && is_pipelined(hdr.key);
         auto remaining = size - request_header_size
                          - hdr.client_id_buffer.size();
         return read_iobuf_exactly(_rs.conn->input(), remaining)
-          .then([this, hdr = std::move(hdr), sres = std::move(sres)](
+          .then([this, pipelined](iobuf buf) {
+              if (pipelined || _pipelined_handlers == 0) {
+                  return ss::make_ready_future<iobuf>(std::move(buf));
+              }
+              return _pipelined_handlers_done
+                .wait([this] { return _pipelined_handlers == 0; })
+                .then([buf = std::move(buf)]() mutable {
+                    return std::move(buf);
+                });
+          })
+          .then([this, hdr = std::move(hdr), sres = std::move(sres), pipelined](
                   iobuf buf) mutable {
               if (_rs.abort_requested()) {
                   // _proto._cntrl etc might not be alive
@@ -231,41 +337,32 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
               auto self = shared_from_this();
               auto rctx = request_context(
                 self, std::move(hdr), std::move(buf), sres.backpressure_delay);
-              /*
-               * we process requests in order since all subsequent requests
-               * are dependent on authentication having completed.
-               *
-               * the other important reason for disabling pipeling is because
-               * when a sasl handshake with version=0 is processed, the next
-               * data on the wire is _not_ another request: it is a
-               * size-prefixed authentication payload without a request
-               * envelope, and requires special handling.
-               *
-               * a well behaved client should implicitly provide a data stream
-               * that invokes this behavior in the server: that is, it won't
-               * send auth data (or any other requests) until handshake or the
-               * full auth-process completes, etc... but representing these
-               * nuances of the protocol _explicitly_ in the server makes its
-               * behavior easier to understand and avoids misbehaving clients
-               * creating server-side errors that will appear as a corrupted
-               * stream at best and at worst some odd behavior.
-               */
-
               const auto correlation = rctx.header().correlation;
               const sequence_id seq = _seq_idx;
               _seq_idx = _seq_idx + sequence_id(1);
+              auto quota = quota_usage{
+                .key = rctx.header().key,
+                .client_id = rctx.header().client_id
+                               ? std::make_optional<ss::sstring>(
+                                 *rctx.header().client_id)
+                               : std::nullopt,
+                .timer = rctx.timer()};
               auto res = kafka::process_request(
                 std::move(rctx), _proto.smp_group());
               /**
-               * first stage processed in a foreground.
+               * first stage processed in a foreground, unless pipelined.
                */
-              return res.dispatched
-                .then_wrapped([this,
+              auto stages
+                = res.dispatched.then_wrapped([this,
                                f = std::move(res.response),
                                seq,
                                correlation,
                                self,
-                               s = std::move(sres)](ss::future<> d) mutable {
+                               s = std::move(sres),
+                               quota = std::move(quota)](
+                                ss::future<> d) mutable {
+                    record_request_time(quota);
+                    auto window = std::move(s.window);
                     /*
                      * if the dispatch/first stage failed, then we need to
                      * need to consume the second stage since it might be
@@ -282,10 +379,17 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
                                 "Discarding second stage failure {}",
                                 e);
                           })
-                          .finally([self, d = std::move(d)]() mutable {
+                          .finally([self,
+                                    seq,
+                                    window = std::move(window),
+                                    d = std::move(d)]() mutable {
                               self->_rs.probe().service_error();
                               self->_rs.probe().request_completed();
-                              return std::move(d);
+                              return self
+                                ->skip_response(seq, std::move(window))
+                                .then([d = std::move(d)]() mutable {
+                                    return std::move(d);
+                                });
                           });
                     }
                     /**
@@ -294,15 +398,32 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
                     ssx::background
                       = ssx::spawn_with_gate_then(
                           _rs.conn_gate(),
-                          [this, f = std::move(f), seq, correlation]() mutable {
-                              return f.then([this, seq, correlation](
+                          [this,
+                           f = std::move(f),
+                           seq,
+                           correlation,
+                           quota = std::move(quota),
+                           window = std::move(window)]() mutable {
+                              return f.then([this,
+                                             seq,
+                                             correlation,
+                                             quota = std::move(quota),
+                                             window = std::move(window)](
                                               response_ptr r) mutable {
+                                  record_fetched_bytes(quota, *r);
                                   r->set_correlation(correlation);
-                                  _responses.insert({seq, std::move(r)});
+                                  _responses.insert(
+                                    {seq,
+                                     pending_response{
+                                       .response = std::move(r),
+                                       .window = std::move(window),
+                                       .hol_blocking
+                                       = _proto.pipeline_probe()
+                                           .auto_hol_measurement()}});
                                   return process_next_response();
                               });
                           })
-                          .handle_exception([self](std::exception_ptr e) {
+                          .handle_exception([self, seq](std::exception_ptr e) {
                               // ssx::spawn_with_gate already caught
                               // shutdown-like exceptions, so we should only be
                               // taking this path for real errors.  That also
@@ -317,19 +438,53 @@ connection_context::dispatch_method_once(request_header hdr, size_t size) {
                                 e);
                               self->_rs.probe().service_error();
                               self->_rs.conn->shutdown_input();
+                              return self->skip_response(seq, nullptr);
                           })
                           .finally([s = std::move(s), self] {});
                     return d;
                 })
-                .handle_exception([self](std::exception_ptr e) {
-                    vlog(
-                      klog.info, "Detected error dispatching request: {}", e);
-                    self->_rs.conn->shutdown_input();
-                });
+                  .handle_exception([self](std::exception_ptr e) {
+                      vlog(
+                        klog.info,
+                        "Detected error dispatching request: {}",
+                        e);
+                      self->_rs.conn->shutdown_input();
+                  });
+              if (!pipelined) {
+                  return stages;
+              }
+              ++_pipelined_handlers;
+              ssx::background = ssx::spawn_with_gate_then(
+                                  _rs.conn_gate(),
+                                  [stages = std::move(stages)]() mutable {
+                                      return std::move(stages);
+                                  })
+                                  .finally([self] {
+                                      if (--self->_pipelined_handlers == 0) {
+                                          self->_pipelined_handlers_done
+                                            .broadcast();
+                                      }
+                                  });
+              return ss::now();
           });
     });
 }
 
+ss::future<> connection_context::skip_response(
+  sequence_id seq, std::unique_ptr<window_unit> window) {
+    if (seq < _next_response || _responses.contains(seq)) {
+        // the request already has its response
+        return ss::now();
+    }
+    auto r = std::make_unique<response>();
+    r->mark_noop();
+    _responses.insert(
+      {seq,
+       pending_response{
+         .response = std::move(r), .window = std::move(window)}});
+    return process_next_response();
+}
+
 ss::future<> connection_context::process_next_response() {
     return ss::repeat([this]() mutable {
         auto it = _responses.find(_next_response);
@@ -340,20 +495,34 @@ ss::future<> connection_context::process_next_response() {
         // found one; increment counter
         _next_response = _next_response + sequence_id(1);
 
-        auto r = std::move(it->second);
+        auto pending = std::move(it->second);
         _responses.erase(it);
+        // records the time the response waited for the earlier ones
+        pending.hol_blocking.reset();
 
-        if (r->is_noop()) {
+        if (pending.response->is_noop()) {
             return ss::make_ready_future<ss::stop_iteration>(
               ss::stop_iteration::no);
         }
 
-        auto msg = response_as_scattered(std::move(r));
+        auto msg = response_as_scattered(std::move(pending.response));
         try {
-            return _rs.conn->write(std::move(msg)).then([] {
-                return ss::make_ready_future<ss::stop_iteration>(
-                  ss::stop_iteration::no);
-            });
+            // the request leaves the in flight window once its response was
+            // written. a failed write doesn't stop the later responses from
+            // leaving it too
+            return _rs.conn->write(std::move(msg))
+              .then_wrapped([this, window = std::move(pending.window)](
+                              ss::future<> f) {
+                  if (f.failed()) {
+                      vlog(
+                        klog.debug,
+                        "Failed to write response: {}",
+                        f.get_exception());
+                      _rs.conn->shutdown_input();
+                  }
+                  return ss::make_ready_future<ss::stop_iteration>(
+                    ss::stop_iteration::no);
+              });
         } catch (...) {
             vlog(
               klog.debug,
@@ -10,6 +10,7 @@
  */
 #pragma once
 #include "kafka/server/protocol.h"
+#include "kafka/server/request_timer.h"
 #include "kafka/server/response.h"
 #include "net/server.h"
 #include "seastarx.h"
@@ -18,6 +19,7 @@
 #include "utils/hdr_hist.h"
 #include "utils/named_type.h"
 
+#include <seastar/core/condition-variable.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/core/semaphore.hh>
@@ -25,7 +27,9 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <chrono>
 #include <memory>
+#include <optional>
 
 namespace kafka {
 
@@ -47,6 +51,9 @@ public:
       bool enable_authorizer) noexcept
       : _proto(p)
       , _rs(std::move(r))
+      , _window_size(config::shard_local_cfg()
+                       .kafka_max_inflight_requests_per_connection())
+      , _window(_window_size)
       , _sasl(std::move(sasl))
       // tests may build a context without a live connection
       , _client_addr(_rs.conn ? _rs.conn->addr.addr() : ss::net::inet_address{})
@@ -105,12 +112,17 @@ public:
 
     ss::future<> process_one_request();
     bool is_finished_parsing() const;
+    // resolves once the responses of all requests in flight were written or
+    // dropped
+    ss::future<> wait_for_inflight_requests();
     ss::net::inet_address client_host() const { return _client_addr; }
     uint16_t client_port() const {
         return _rs.conn ? _rs.conn->addr.port() : 0;
     }
 
 private:
+    using sequence_id = named_type<uint64_t, struct kafka_protocol_sequence>;
+
     // used to track number of pending requests
     class request_tracker {
     public:
@@ -128,6 +140,27 @@ private:
     private:
         net::server_probe& _probe;
     };
+    // a request in the in flight window of the connection, from its dispatch
+    // until its response was written
+    class window_unit {
+    public:
+        window_unit(
+          ss::semaphore_units<> units, pipeline_probe& probe) noexcept
+          : _units(std::move(units))
+          , _probe(probe) {
+            _probe.request_dispatched();
+        }
+        window_unit(const window_unit&) = delete;
+        window_unit(window_unit&&) = delete;
+        window_unit& operator=(const window_unit&) = delete;
+        window_unit& operator=(window_unit&&) = delete;
+
+        ~window_unit() noexcept { _probe.response_written(); }
+
+    private:
+        ss::semaphore_units<> _units;
+        pipeline_probe& _probe;
+    };
     // used to pass around some internal state
     struct session_resources {
         ss::lowres_clock::duration backpressure_delay;
@@ -135,8 +168,20 @@ private:
         ss::semaphore_units<> queue_units;
         std::unique_ptr<hdr_hist::measurement> method_latency;
         std::unique_ptr<request_tracker> tracker;
+        std::unique_ptr<window_unit> window;
+    };
+
+    // a handled request, as recorded against the quotas of the client
+    struct quota_usage {
+        api_key key;
+        std::optional<ss::sstring> client_id;
+        ss::lw_shared_ptr<request_timer> timer;
     };
 
+    std::string_view quota_principal();
+    void record_request_time(const quota_usage&);
+    void record_fetched_bytes(const quota_usage&, const response&);
+
     /// called by throttle_request
     ss::future<ss::semaphore_units<>> reserve_request_units(size_t size);
 
@@ -146,13 +191,21 @@ private:
 
     ss::future<> dispatch_method_once(request_header, size_t sz);
     ss::future<> process_next_response();
+    // the request has no response, e.g. because its handler failed, the
+    // responses of later requests are written without it
+    ss::future<> skip_response(sequence_id, std::unique_ptr<window_unit>);
     ss::future<> do_process(request_context);
 
     ss::future<> handle_auth_v0(size_t);
 
 private:
-    using sequence_id = named_type<uint64_t, struct kafka_protocol_sequence>;
-    using map_t = absl::flat_hash_map<sequence_id, response_ptr>;
+    // a response waiting for the responses of earlier requests
+    struct pending_response {
+        response_ptr response;
+        std::unique_ptr<window_unit> window;
+        std::unique_ptr<pipeline_probe::hol_measurement> hol_blocking;
+    };
+    using map_t = absl::flat_hash_map<sequence_id, pending_response>;
 
     class ctx_log {
     public:
@@ -206,6 +259,12 @@ private:
 
     protocol& _proto;
     net::server::resources _rs;
+    // requests in flight, declared before the responses holding its units
+    const size_t _window_size;
+    ss::semaphore _window;
+    // handlers of pipelined requests that did not complete yet
+    size_t _pipelined_handlers{0};
+    ss::condition_variable _pipelined_handlers_done;
     sequence_id _next_response;
     sequence_id _seq_idx;
     map_t _responses;
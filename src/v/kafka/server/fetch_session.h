@@ -15,11 +15,16 @@
 #include "model/timeout_clock.h"
 #include "model/timestamp.h"
 
+#include <seastar/core/condition-variable.hh>
+
 #include <absl/container/flat_hash_map.h>
 #include <boost/iterator/iterator_adaptor.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/iterator_adaptors.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace kafka {
 
 struct fetch_session_partition {
@@ -39,6 +44,11 @@ struct fetch_session_partition {
  * Internally the map is based on absl::flat_hash_map containing entries that
  * are additionally linked by being elements of an intrusive list. The intrusive
  * list provides the insertion order traversal across the partitions.
+ *
+ * Partitions that may have something new for the consumer are also linked in
+ * the ready list. An incremental fetch only reads the ready partitions, the
+ * other ones are parked: they were read up to their high watermark and the
+ * session is notified once it moves, see fetch_session_cache.
  */
 class fetch_partitions_linked_hash_map {
 private:
@@ -47,7 +57,10 @@ private:
           : partition(std::move(partition)) {}
 
         kafka::fetch_session_partition partition;
+        // position in insertion order
+        uint64_t position{0};
         intrusive_list_hook _hook;
+        intrusive_list_hook _ready_hook;
     };
 
     struct topic_partition_hash {
@@ -126,7 +139,9 @@ public:
           "already present.",
           it->second->partition.topic,
           it->second->partition.partition);
+        it->second->position = next_position++;
         insertion_order.push_back(*it->second);
+        ready.push_back(*it->second);
     }
 
     bool contains(model::topic_partition_view v) {
@@ -162,9 +177,40 @@ public:
 
     void move_to_end(iterator it) {
         it->second->_hook.unlink();
+        it->second->position = next_position++;
         insertion_order.push_back(*it->second);
     }
 
+    void mark_ready(iterator it) {
+        if (!it->second->_ready_hook.is_linked()) {
+            ready.push_back(*it->second);
+        }
+    }
+
+    void park(iterator it) { it->second->_ready_hook.unlink(); }
+
+    bool is_ready(model::topic_partition_view v) const {
+        auto it = partitions.find(v);
+        return it != partitions.end() && it->second->_ready_hook.is_linked();
+    }
+
+    /// ready partitions in insertion order
+    std::vector<const fetch_session_partition*> ready_partitions() const {
+        std::vector<const entry*> entries;
+        for (const auto& e : ready) {
+            entries.push_back(&e);
+        }
+        std::sort(entries.begin(), entries.end(), [](auto a, auto b) {
+            return a->position < b->position;
+        });
+        std::vector<const fetch_session_partition*> ret;
+        ret.reserve(entries.size());
+        for (auto e : entries) {
+            ret.push_back(&e->partition);
+        }
+        return ret;
+    }
+
     iterator begin() { return partitions.begin(); }
     iterator end() { return partitions.end(); }
 
@@ -177,6 +223,8 @@ public:
 private:
     underlying_t partitions;
     intrusive_list<entry, &entry::_hook> insertion_order;
+    intrusive_list<entry, &entry::_ready_hook> ready;
+    uint64_t next_position{0};
 };
 
 inline fetch_session_epoch next_epoch(fetch_session_epoch current) {
@@ -219,6 +267,35 @@ public:
         return sizeof(fetch_session) + _partitions.mem_usage();
     }
 
+    // number of times the session cache marked parked partitions of the
+    // session ready
+    uint64_t ready_notifications() const { return _ready_notifications; }
+
+    void notify_ready() {
+        ++_ready_notifications;
+        _ready.broadcast();
+    }
+
+    /**
+     * Long polling fetches wait for a parked partition of their session to
+     * become ready instead of re-reading all of them. Resolves once there was
+     * a notification after the `seen` one or on the deadline.
+     */
+    ss::future<>
+    wait_for_ready(uint64_t seen, model::timeout_clock::time_point deadline) {
+        auto now = model::timeout_clock::now();
+        if (deadline <= now || _ready_notifications != seen) {
+            return ss::now();
+        }
+        auto notified = [this, seen] { return _ready_notifications != seen; };
+        if (deadline == model::no_timeout) {
+            return _ready.wait(notified);
+        }
+        return _ready.wait(deadline - now, notified)
+          .handle_exception_type(
+            [](const ss::condition_variable_timed_out&) {});
+    }
+
 private:
     friend struct fetch_session_ctx;
     friend class fetch_session_cache;
@@ -228,6 +305,8 @@ private:
     model::timeout_clock::time_point _last_used;
     fetch_session_epoch _epoch;
     bool _locked;
+    uint64_t _ready_notifications{0};
+    ss::condition_variable _ready;
 };
 
 using fetch_session_ptr = ss::lw_shared_ptr<fetch_session>;
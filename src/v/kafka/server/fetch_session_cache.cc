@@ -1,12 +1,19 @@
 #include "kafka/server/fetch_session_cache.h"
 
+#include "cluster/partition_manager.h"
 #include "config/configuration.h"
 #include "kafka/protocol/fetch.h"
 #include "kafka/server/logger.h"
+#include "kafka/server/partition_proxy.h"
+#include "kafka/server/replicated_partition.h"
 #include "kafka/types.h"
 #include "model/fundamental.h"
 #include "model/timeout_clock.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "raft/offset_monitor.h"
+#include "ssx/future-util.h"
+
+#include <seastar/core/coroutine.hh>
 
 #include <chrono>
 
@@ -35,6 +42,8 @@ void update_fetch_session(fetch_session& session, const fetch_request& req) {
             s_it != session.partitions().end()) {
             s_it->second->partition.max_bytes = partition.max_bytes;
             s_it->second->partition.fetch_offset = partition.fetch_offset;
+            // the consumer moved, the partition has to be read again
+            session.partitions().mark_ready(s_it);
         } else {
             session.partitions().emplace(
               make_fetch_partition(topic.name, partition));
@@ -79,6 +88,7 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
                 vlog(klog.info, "removing fetch session {}", session_id);
                 _sessions_mem_usage -= it->second->mem_usage();
                 _sessions.erase(it);
+                drop_watchers({.session = session_id});
             }
         }
         if (epoch == final_fetch_session_epoch) {
@@ -135,6 +145,7 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
           epoch);
 
         _sessions.erase(session_id);
+        drop_watchers({.session = session_id});
         return fetch_session_ctx();
     }
 
@@ -143,6 +154,345 @@ fetch_session_cache::maybe_get_session(const fetch_request& req) {
     return fetch_session_ctx(session, false);
 }
 
+ss::future<> fetch_session_cache::stop() {
+    _session_eviction_timer.cancel();
+    auto closed = _gate.close();
+    for (auto& [id, w] : _waiters) {
+        w.notified.broken();
+    }
+    if (_pm) {
+        _pm->unregister_leadership_notification(_leadership_notification);
+    }
+    for (auto& [ntp, w] : _watches) {
+        _pm->unregister_unmanage_notification(w.unmanage_notification);
+        if (!w.as.abort_requested()) {
+            w.as.request_abort();
+        }
+    }
+    return closed;
+}
+
+static bool above_fetch_offset(
+  const ss::lw_shared_ptr<cluster::partition>& p, model::offset fetch_offset) {
+    // fetch offsets are kafka offsets, the high watermark has to be translated
+    auto proxy = make_partition_proxy<replicated_partition>(p);
+    return proxy.high_watermark() > fetch_offset;
+}
+
+void fetch_session_cache::watch_partitions(
+  ss::sharded<cluster::partition_manager>& pm,
+  ss::shard_id shard,
+  watch_target target,
+  std::vector<watch_request> requests) {
+    if (_gate.is_closed()) {
+        return;
+    }
+    if (target.waiter) {
+        if (auto it = _waiters.find(target.waiter); it != _waiters.end()) {
+            it->second.watched = true;
+        }
+    }
+    ssx::spawn_with_gate(
+      _gate,
+      [this,
+       &pm,
+       shard,
+       target,
+       home = ss::this_shard_id(),
+       requests = std::move(requests)]() mutable {
+          return container().invoke_on(
+            shard,
+            [&pm, home, target, requests = std::move(requests)](
+              fetch_session_cache& cache) mutable {
+                cache.add_watchers(
+                  pm.local(), home, target, std::move(requests));
+            });
+      });
+}
+
+uint64_t fetch_session_cache::register_waiter(fetch_session_id session_id) {
+    auto id = _next_waiter_id++;
+    _waiters[id].session = session_id;
+    return id;
+}
+
+void fetch_session_cache::unregister_waiter(uint64_t waiter) {
+    auto it = _waiters.find(waiter);
+    if (it == _waiters.end()) {
+        return;
+    }
+    const bool watched = it->second.watched;
+    _waiters.erase(it);
+    if (watched) {
+        drop_watchers({.waiter = waiter});
+    }
+}
+
+uint64_t fetch_session_cache::waiter_notifications(uint64_t waiter) const {
+    auto it = _waiters.find(waiter);
+    return it != _waiters.end() ? it->second.notifications : 0;
+}
+
+ss::future<> fetch_session_cache::wait_for_waiter(
+  uint64_t waiter, uint64_t seen, model::timeout_clock::time_point deadline) {
+    auto it = _waiters.find(waiter);
+    auto now = model::timeout_clock::now();
+    if (
+      it == _waiters.end() || deadline <= now
+      || it->second.notifications != seen) {
+        return ss::now();
+    }
+    // the waiter is only unregistered by the fetch waiting on it
+    auto& w = it->second;
+    auto notified = [&w, seen] { return w.notifications != seen; };
+    auto f = deadline == model::no_timeout
+               ? w.notified.wait(notified)
+               : w.notified.wait(deadline - now, notified);
+    return f.handle_exception_type(
+              [](const ss::condition_variable_timed_out&) {})
+      .handle_exception_type([](const ss::broken_condition_variable&) {});
+}
+
+void fetch_session_cache::add_watchers(
+  cluster::partition_manager& pm,
+  ss::shard_id home,
+  watch_target target,
+  std::vector<watch_request> requests) {
+    if (_gate.is_closed()) {
+        return;
+    }
+    if (!_pm) {
+        _pm = &pm;
+        // a new term wakes all the watchers of the partition
+        _leadership_notification = pm.register_leadership_notification(
+          [this](
+            raft::group_id group,
+            model::term_id,
+            std::optional<model::node_id>) {
+              if (auto p = _pm->partition_for(group)) {
+                  abort_watch(p->ntp());
+              }
+          });
+    }
+    ready_partitions_t ready;
+    for (auto& r : requests) {
+        auto p = pm.get(r.ntp);
+        // data arrived after the read, nothing to wait for
+        if (!p || above_fetch_offset(p, r.fetch_offset)) {
+            ready.emplace_back(target, r.ntp.tp);
+            continue;
+        }
+        auto [it, inserted] = _watches.try_emplace(r.ntp);
+        auto& watchers = it->second.watchers;
+        auto w_it = std::find_if(
+          watchers.begin(), watchers.end(), [home, target](const auto& w) {
+              return w.home == home && w.target == target;
+          });
+        if (w_it != watchers.end()) {
+            w_it->fetch_offset = r.fetch_offset;
+        } else {
+            watchers.push_back(partition_watch::watcher{
+              .home = home,
+              .target = target,
+              .fetch_offset = r.fetch_offset});
+        }
+        if (inserted) {
+            it->second.id = _next_watch_id++;
+            // so does the removal of the partition from this shard
+            it->second.unmanage_notification
+              = pm.register_unmanage_notification(
+                r.ntp.ns,
+                r.ntp.tp.topic,
+                [this, ntp = r.ntp](model::partition_id id) {
+                    if (id == ntp.tp.partition) {
+                        abort_watch(ntp);
+                    }
+                });
+            ssx::spawn_with_gate(
+              _gate, [this, ntp = r.ntp, id = it->second.id]() mutable {
+                  return watch_partition(std::move(ntp), id);
+              });
+        }
+    }
+    notify_ready(home, std::move(ready));
+}
+
+/**
+ * Waits for the visible offset of the partition to move and wakes up the
+ * watchers whose fetch offset is below the new high watermark. The watch is
+ * aborted when the partition term changes, as the read may now end with an
+ * error, or when the partition is gone from this shard. All of its watchers
+ * are woken up then.
+ */
+ss::future<> fetch_session_cache::watch_partition(model::ntp ntp, uint64_t id) {
+    auto current = [this, &ntp, id] {
+        auto it = _watches.find(ntp);
+        return it != _watches.end() && it->second.id == id ? it
+                                                           : _watches.end();
+    };
+    while (true) {
+        auto it = current();
+        if (it == _watches.end() || _gate.is_closed()) {
+            co_return;
+        }
+        auto p = _pm->get(ntp);
+        if (p && !it->second.as.abort_requested()) {
+            try {
+                co_await p->wait_for_high_watermark(
+                  p->high_watermark(), model::no_timeout, it->second.as);
+            } catch (const raft::offset_monitor::wait_aborted&) {
+                // the watch was aborted or dropped, checked below
+            }
+            it = current();
+            if (it == _watches.end() || _gate.is_closed()) {
+                co_return;
+            }
+        }
+        if (!p || it->second.as.abort_requested()) {
+            wake_all_watchers(it);
+            co_return;
+        }
+
+        absl::flat_hash_map<ss::shard_id, ready_partitions_t> ready;
+        auto& watchers = it->second.watchers;
+        auto end = std::partition(
+          watchers.begin(),
+          watchers.end(),
+          [&p](const partition_watch::watcher& w) {
+              return !above_fetch_offset(p, w.fetch_offset);
+          });
+        for (auto w_it = end; w_it != watchers.end(); ++w_it) {
+            ready[w_it->home].emplace_back(w_it->target, ntp.tp);
+        }
+        watchers.erase(end, watchers.end());
+        const bool done = watchers.empty();
+        if (done) {
+            drop_watch(it);
+        }
+        for (auto& [home, partitions] : ready) {
+            notify_ready(home, std::move(partitions));
+        }
+        if (done) {
+            co_return;
+        }
+    }
+}
+
+void fetch_session_cache::abort_watch(const model::ntp& ntp) {
+    if (auto it = _watches.find(ntp);
+        it != _watches.end() && !it->second.as.abort_requested()) {
+        it->second.as.request_abort();
+    }
+}
+
+void fetch_session_cache::wake_all_watchers(watches_t::iterator it) {
+    absl::flat_hash_map<ss::shard_id, ready_partitions_t> ready;
+    for (const auto& w : it->second.watchers) {
+        ready[w.home].emplace_back(w.target, it->first.tp);
+    }
+    drop_watch(it);
+    for (auto& [home, partitions] : ready) {
+        notify_ready(home, std::move(partitions));
+    }
+}
+
+void fetch_session_cache::drop_watch(watches_t::iterator it) {
+    // wakes up the watch of the partition, if it is waiting
+    if (!it->second.as.abort_requested()) {
+        it->second.as.request_abort();
+    }
+    _pm->unregister_unmanage_notification(it->second.unmanage_notification);
+    _watches.erase(it);
+}
+
+void fetch_session_cache::remove_watchers(
+  ss::shard_id home, watch_target target) {
+    for (auto it = _watches.begin(); it != _watches.end();) {
+        auto& watchers = it->second.watchers;
+        watchers.erase(
+          std::remove_if(
+            watchers.begin(),
+            watchers.end(),
+            [home, target](const partition_watch::watcher& w) {
+                return w.home == home && w.target == target;
+            }),
+          watchers.end());
+        if (watchers.empty()) {
+            drop_watch(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void fetch_session_cache::drop_watchers(watch_target target) {
+    if (_gate.is_closed()) {
+        return;
+    }
+    ssx::spawn_with_gate(_gate, [this, target, home = ss::this_shard_id()] {
+        return container().invoke_on_all(
+          [home, target](fetch_session_cache& cache) {
+              cache.remove_watchers(home, target);
+          });
+    });
+}
+
+void fetch_session_cache::notify_ready(
+  ss::shard_id home, ready_partitions_t ready) {
+    if (ready.empty() || _gate.is_closed()) {
+        return;
+    }
+    ssx::spawn_with_gate(
+      _gate, [this, home, ready = std::move(ready)]() mutable {
+          return container().invoke_on(
+            home,
+            [ready = std::move(ready)](fetch_session_cache& cache) mutable {
+                cache.mark_ready(ready);
+            });
+      });
+}
+
+void fetch_session_cache::mark_ready(const ready_partitions_t& ready) {
+    if (_gate.is_closed()) {
+        return;
+    }
+    for (const auto& [target, tp] : ready) {
+        if (target.waiter) {
+            auto it = _waiters.find(target.waiter);
+            if (it == _waiters.end()) {
+                // the fetch is done, its other partitions need no watch either
+                drop_watchers(target);
+                continue;
+            }
+            ++it->second.notifications;
+            it->second.notified.broadcast();
+            continue;
+        }
+        auto it = _sessions.find(target.session);
+        if (it == _sessions.end()) {
+            // the session is gone, its other partitions need no watch either
+            drop_watchers(target);
+            continue;
+        }
+        auto& partitions = it->second->partitions();
+        if (auto p_it = partitions.find(tp); p_it != partitions.end()) {
+            partitions.mark_ready(p_it);
+            it->second->notify_ready();
+            notify_waiters(target.session);
+            ++_ready_notifications;
+        }
+    }
+}
+
+void fetch_session_cache::notify_waiters(fetch_session_id session_id) {
+    for (auto& [id, w] : _waiters) {
+        if (w.session == session_id) {
+            ++w.notifications;
+            w.notified.broadcast();
+        }
+    }
+}
+
 // we split whole range from 1 to max int32_t betewen all shards
 std::optional<fetch_session_id> fetch_session_cache::new_session_id() {
     if (unlikely(
@@ -173,6 +523,7 @@ void fetch_session_cache::gc_sessions() {
         } else {
             vlog(klog.debug, "evicting session {}", it->second->id());
             _sessions_mem_usage -= it->second->mem_usage();
+            drop_watchers({.session = it->second->id()});
             _sessions.erase(it++);
         }
     }
@@ -193,7 +544,19 @@ void fetch_session_cache::register_metrics() {
        sm::make_gauge(
          "sessions_count",
          [this] { return _sessions.size(); },
-         sm::description("Total number of fetch sessions"))});
+         sm::description("Total number of fetch sessions")),
+       sm::make_gauge(
+         "watched_partitions",
+         [this] { return watched_partitions(); },
+         sm::description(
+           "Number of partitions watched for new data on behalf of fetch "
+           "sessions")),
+       sm::make_derive(
+         "ready_notifications",
+         [this] { return _ready_notifications; },
+         sm::description(
+           "Number of session partitions marked ready after new data was "
+           "produced to them"))});
 }
 
 } // namespace kafka
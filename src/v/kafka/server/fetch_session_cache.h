@@ -10,13 +10,22 @@
  */
 #pragma once
 
+#include "cluster/fwd.h"
+#include "cluster/types.h"
 #include "kafka/server/fetch_session.h"
 #include "kafka/types.h"
+#include "model/fundamental.h"
+#include "model/timeout_clock.h"
 #include "units.h"
 
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/condition-variable.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/node_hash_map.h>
 
 #include <chrono>
 
@@ -31,14 +40,100 @@ struct fetch_request;
  * The cache evicts not used sessions after configurable period of inactivity.
  * Fetch session cache will stop adding new sessions after its max memory usage
  * is reached.
+ *
+ * Partitions of a session that were read up to their high watermark are parked
+ * by the fetch handler. The cache on the shard owning the partition watches
+ * its high watermark and marks the partition ready again in the session cache
+ * of the shard owning the session once there is something new to read. This
+ * way a fetch of an incremental session only reads the partitions that moved
+ * instead of all the partitions of the session, and a long polling fetch of
+ * the session waiting for data is woken up by the notification.
+ *
+ * Fetches that have to wait for more data register a fetch waiter on the
+ * shard handling the request. The partitions they read are watched the same
+ * way on behalf of the waiter, which is also woken up by the notifications of
+ * its session, if any.
  **/
-class fetch_session_cache {
+class fetch_session_cache
+  : public ss::peering_sharded_service<fetch_session_cache> {
 public:
+    // parked partition, the fetch offset is a kafka offset
+    struct watch_request {
+        model::ntp ntp;
+        model::offset fetch_offset;
+    };
+
+    // woken up once a watched partition moved, a session or a fetch waiter
+    struct watch_target {
+        fetch_session_id session{invalid_fetch_session_id};
+        uint64_t waiter{0};
+
+        bool operator==(const watch_target&) const = default;
+    };
+
     explicit fetch_session_cache(std::chrono::milliseconds);
     fetch_session_ctx maybe_get_session(const fetch_request& req);
     size_t size() const { return _sessions.size(); }
+    // partitions of this shard watched on behalf of sessions
+    size_t watched_partitions() const { return _watches.size(); }
+
+    /**
+     * Watch the partitions on behalf of the target, all of them are managed
+     * by `shard`. A partition is marked ready once its high watermark is
+     * above the fetch offset, its leadership or term changes or it is removed
+     * from the shard. The watchers of a session are dropped with the session,
+     * the ones of a fetch waiter when it is unregistered.
+     */
+    void watch_partitions(
+      ss::sharded<cluster::partition_manager>&,
+      ss::shard_id shard,
+      watch_target,
+      std::vector<watch_request>);
+
+    /**
+     * Registers a waiter of a fetch waiting for data. It is also woken up
+     * when a partition of the session is marked ready. Returns the waiter id.
+     */
+    uint64_t register_waiter(fetch_session_id = invalid_fetch_session_id);
+    void unregister_waiter(uint64_t waiter);
+    // number of times a partition watched on behalf of the waiter moved
+    uint64_t waiter_notifications(uint64_t waiter) const;
+    /**
+     * Resolves once the waiter was notified after the `seen` notification or
+     * on the deadline.
+     */
+    ss::future<> wait_for_waiter(
+      uint64_t waiter, uint64_t seen, model::timeout_clock::time_point);
+
+    ss::future<> stop();
 
 private:
+    using ready_partitions_t
+      = std::vector<std::pair<watch_target, model::topic_partition>>;
+
+    struct partition_watch {
+        struct watcher {
+            ss::shard_id home;
+            watch_target target;
+            model::offset fetch_offset;
+        };
+        // tells the watch apart from later watches of the same partition
+        uint64_t id{0};
+        std::vector<watcher> watchers;
+        // aborted to wake all the watchers, or to drop the watch
+        ss::abort_source as;
+        cluster::notification_id_type unmanage_notification;
+    };
+    using watches_t = absl::node_hash_map<model::ntp, partition_watch>;
+
+    struct fetch_waiter {
+        fetch_session_id session;
+        uint64_t notifications{0};
+        // set once partitions were watched on behalf of the waiter
+        bool watched{false};
+        ss::condition_variable notified;
+    };
+
     using underlying_t
       = absl::flat_hash_map<fetch_session_id, fetch_session_ptr>;
 
@@ -56,6 +151,24 @@ private:
     std::optional<fetch_session_id> new_session_id();
     void gc_sessions();
 
+    // executed on the shard of the watched partitions
+    void add_watchers(
+      cluster::partition_manager&,
+      ss::shard_id home,
+      watch_target,
+      std::vector<watch_request>);
+    ss::future<> watch_partition(model::ntp, uint64_t id);
+    // the watch wakes all its watchers, executed from notifications
+    void abort_watch(const model::ntp&);
+    void wake_all_watchers(watches_t::iterator);
+    void drop_watch(watches_t::iterator);
+    void remove_watchers(ss::shard_id home, watch_target);
+    void notify_ready(ss::shard_id home, ready_partitions_t);
+    // executed on the shard of the sessions and waiters
+    void mark_ready(const ready_partitions_t&);
+    void notify_waiters(fetch_session_id);
+    void drop_watchers(watch_target);
+
     size_t mem_usage() const {
         using debug = absl::container_internal::hashtable_debug_internal::
           HashtableDebugAccess<underlying_t>;
@@ -75,6 +188,18 @@ private:
 
     size_t _sessions_mem_usage = 0;
 
+    // partitions of this shard that are watched on behalf of sessions
+    watches_t _watches;
+    uint64_t _next_watch_id{0};
+    // set once the first partition of this shard is watched
+    cluster::partition_manager* _pm{nullptr};
+    cluster::notification_id_type _leadership_notification;
+    uint64_t _ready_notifications{0};
+    // fetches of this shard waiting for data
+    absl::node_hash_map<uint64_t, fetch_waiter> _waiters;
+    uint64_t _next_waiter_id{1};
+    ss::gate _gate;
+
     ss::metrics::metric_groups _metrics;
 };
 
@@ -22,6 +22,7 @@
 #include "kafka/server/handlers/fetch/fetch_planner.h"
 #include "kafka/server/materialized_partition.h"
 #include "kafka/server/partition_proxy.h"
+#include "kafka/server/replica_selector.h"
 #include "kafka/server/replicated_partition.h"
 #include "likely.h"
 #include "model/fundamental.h"
@@ -39,6 +40,7 @@
 #include <seastar/core/thread.hh>
 #include <seastar/util/log.hh>
 
+#include <absl/container/flat_hash_set.h>
 #include <boost/range/irange.hpp>
 #include <fmt/ostream.h>
 
@@ -100,7 +102,14 @@ static ss::future<read_result> read_from_partition(
         data = std::make_unique<iobuf>(std::move(result.data));
         part.probe().add_records_fetched(result.record_count);
         part.probe().add_bytes_fetched(data->size_bytes());
-        if (result.record_count > 0) {
+        /*
+         * aborted transactions are only used by read_committed consumers to
+         * filter batches of aborted transactions. for read_uncommitted
+         * consumers the list is ignored, so skip the rm_stm lookup.
+         */
+        if (
+          result.record_count > 0
+          && config.isolation_level == model::isolation_level::read_committed) {
             // Reader should live at least until this point to hold on to the
             // segment locks so that prefix truncation doesn't happen.
             aborted_transactions = co_await part.aborted_transactions(
@@ -139,7 +148,8 @@ static ss::future<read_result> do_read_from_ntp(
   coproc::partition_manager& coproc_pm,
   ntp_fetch_config ntp_config,
   bool foreign_read,
-  std::optional<model::timeout_clock::time_point> deadline) {
+  std::optional<model::timeout_clock::time_point> deadline,
+  const replica_selector& selector) {
     /*
      * lookup the ntp's partition
      */
@@ -149,7 +159,9 @@ static ss::future<read_result> do_read_from_ntp(
         return ss::make_ready_future<read_result>(
           error_code::unknown_topic_or_partition);
     }
-    if (unlikely(!kafka_partition->is_leader())) {
+    if (unlikely(
+          !kafka_partition->is_leader()
+          && !ntp_config.cfg.read_from_follower)) {
         return ss::make_ready_future<read_result>(
           error_code::not_leader_for_partition);
     }
@@ -187,6 +199,27 @@ static ss::future<read_result> do_read_from_ntp(
           error_code::offset_out_of_range);
     }
 
+    /**
+     * point the consumer to a replica closer to it, see KIP-392. The consumer
+     * only gets the offsets of the partition and fetches the data from the
+     * preferred replica.
+     */
+    if (ntp_config.cfg.client_rack && kafka_partition->is_leader()) {
+        auto info = kafka_partition->get_partition_info();
+        auto preferred = selector.select_replica(
+          client_info{.rack_id = ntp_config.cfg.client_rack},
+          info,
+          ntp_config.cfg.start_offset);
+        if (preferred && preferred != info.leader) {
+            read_result res(
+              kafka_partition->start_offset(),
+              kafka_partition->high_watermark(),
+              kafka_partition->last_stable_offset());
+            res.preferred_replica = preferred;
+            return ss::make_ready_future<read_result>(std::move(res));
+        }
+    }
+
     return read_from_partition(
       std::move(*kafka_partition), ntp_config.cfg, foreign_read, deadline);
 }
@@ -203,12 +236,18 @@ ss::future<read_result> read_from_ntp(
   fetch_config config,
   bool foreign_read,
   std::optional<model::timeout_clock::time_point> deadline) {
-    return do_read_from_ntp(
-      cluster_pm,
-      coproc_pm,
-      make_ntp_fetch_config(ntp, config),
-      foreign_read,
-      deadline);
+    return ss::do_with(
+      select_leader_replica{},
+      [&cluster_pm, &coproc_pm, &ntp, config, foreign_read, deadline](
+        const select_leader_replica& selector) {
+          return do_read_from_ntp(
+            cluster_pm,
+            coproc_pm,
+            make_ntp_fetch_config(ntp, config),
+            foreign_read,
+            deadline,
+            selector);
+      });
 }
 
 static void fill_fetch_responses(
@@ -252,6 +291,9 @@ static void fill_fetch_responses(
         resp.log_start_offset = res.start_offset;
         resp.high_watermark = res.high_watermark;
         resp.last_stable_offset = res.last_stable_offset;
+        if (res.preferred_replica) {
+            resp.preferred_read_replica = *res.preferred_replica;
+        }
 
         /**
          * According to KIP-74 we have to return first batch even if it would
@@ -293,7 +335,8 @@ static ss::future<std::vector<read_result>> fetch_ntps_in_parallel(
   coproc::partition_manager& coproc_pm,
   std::vector<ntp_fetch_config> ntp_fetch_configs,
   bool foreign_read,
-  std::optional<model::timeout_clock::time_point> deadline) {
+  std::optional<model::timeout_clock::time_point> deadline,
+  const replica_selector& selector) {
     size_t total_max_bytes = 0;
     for (const auto& c : ntp_fetch_configs) {
         total_max_bytes += c.cfg.max_bytes;
@@ -317,11 +360,16 @@ static ss::future<std::vector<read_result>> fetch_ntps_in_parallel(
 
     auto results = co_await ssx::parallel_transform(
       std::move(ntp_fetch_configs),
-      [&cluster_pm, &coproc_pm, deadline, foreign_read](
+      [&cluster_pm, &coproc_pm, deadline, foreign_read, &selector](
         const ntp_fetch_config& ntp_cfg) {
           auto p_id = ntp_cfg.ntp().tp.partition;
           return do_read_from_ntp(
-                   cluster_pm, coproc_pm, ntp_cfg, foreign_read, deadline)
+                   cluster_pm,
+                   coproc_pm,
+                   ntp_cfg,
+                   foreign_read,
+                   deadline,
+                   selector)
             .then([p_id](read_result res) {
                 res.partition = p_id;
                 return res;
@@ -361,27 +409,50 @@ handle_shard_fetch(ss::shard_id shard, op_context& octx, shard_fetch fetch) {
     bool foreign_read = shard != ss::this_shard_id();
 
     // dispatch to remote core
-    return octx.rctx.partition_manager()
-      .invoke_on(
-        shard,
-        octx.ssg,
-        [foreign_read,
-         &octx,
-         deadline = octx.deadline,
-         configs = std::move(fetch.requests)](
-          cluster::partition_manager& mgr) mutable {
-            return fetch_ntps_in_parallel(
-              mgr,
-              octx.rctx.coproc_partition_manager().local(),
-              std::move(configs),
-              foreign_read,
-              deadline);
-        })
-      .then([responses = std::move(fetch.responses),
-             metrics = std::move(fetch.metrics),
-             &octx](std::vector<read_result> results) mutable {
+    auto read = octx.rctx.partition_manager().invoke_on(
+      shard,
+      octx.ssg,
+      [foreign_read,
+       &octx,
+       deadline = octx.deadline,
+       configs = std::move(fetch.requests)](
+        cluster::partition_manager& mgr) mutable {
+          return ss::do_with(
+            rack_aware_replica_selector(
+              octx.rctx.sharded_metadata_cache().local()),
+            [&mgr, &octx, foreign_read, deadline, &configs](
+              const rack_aware_replica_selector& selector) {
+                return fetch_ntps_in_parallel(
+                  mgr,
+                  octx.rctx.coproc_partition_manager().local(),
+                  std::move(configs),
+                  foreign_read,
+                  deadline,
+                  selector);
+            });
+      });
+    // reads on other shards do not count against the request time quota of
+    // the client
+    if (foreign_read) {
+        read = octx.rctx.exclude_from_request_time(std::move(read));
+    }
+    return std::move(read).then(
+      [shard,
+       responses = std::move(fetch.responses),
+       metrics = std::move(fetch.metrics),
+       &octx](std::vector<read_result> results) mutable {
           fill_fetch_responses(
             octx, std::move(results), std::move(responses), std::move(metrics));
+          if (!octx.parked.empty()) {
+              octx.rctx.fetch_sessions().watch_partitions(
+                octx.rctx.partition_manager(),
+                shard,
+                {.session = octx.session_ctx.session()->id()},
+                std::exchange(octx.parked, {}));
+          }
+          if (!octx.read.empty()) {
+              octx.watched.emplace_back(shard, std::exchange(octx.read, {}));
+          }
       });
 }
 
@@ -410,14 +481,31 @@ class simple_fetch_planner final : public fetch_planner::impl {
         fetch_plan plan(ss::smp::count);
         auto resp_it = octx.response_begin();
         auto bytes_left_in_plan = octx.bytes_left;
+        /**
+         * consumers that know about preferred read replicas (KIP-392) may be
+         * served by followers, those reporting their rack are pointed to a
+         * replica in it by the leader
+         */
+        const bool read_from_follower
+          = config::shard_local_cfg().enable_follower_fetching()
+            && octx.rctx.header().version >= api_version(11);
+        std::optional<model::rack_id> client_rack;
+        if (read_from_follower && !octx.request.data.rack_id.empty()) {
+            client_rack = model::rack_id(octx.request.data.rack_id);
+        }
         /**
          * group fetch requests by shard
          */
         octx.for_each_fetch_partition(
-          [&resp_it, &octx, &plan, &bytes_left_in_plan](
-            const fetch_session_partition& fp) {
+          [&resp_it,
+           &octx,
+           &plan,
+           &bytes_left_in_plan,
+           read_from_follower,
+           &client_rack](const fetch_session_partition& fp) {
               // if this is not an initial fetch we are allowed to skip
-              // partions that aleready have an error or we have enough data
+              // partions that aleready have an error, we have enough data or
+              // that did not get new data since they were read
               if (!octx.initial_fetch) {
                   bool has_enough_data
                     = !resp_it->partition_response->records->empty()
@@ -425,7 +513,7 @@ class simple_fetch_planner final : public fetch_planner::impl {
 
                   if (
                     resp_it->partition_response->error_code != error_code::none
-                    || has_enough_data) {
+                    || has_enough_data || octx.is_parked(fp)) {
                       ++resp_it;
                       return;
                   }
@@ -486,6 +574,8 @@ class simple_fetch_planner final : public fetch_planner::impl {
                 .strict_max_bytes = octx.response_size > 0,
                 .skip_read = bytes_left_in_plan == 0 && max_bytes == 0,
                 .current_leader_epoch = fp.current_leader_epoch,
+                .read_from_follower = read_from_follower,
+                .client_rack = client_rack,
               };
 
               plan.fetches_per_shard[*shard].push_back(
@@ -522,7 +612,52 @@ class simple_fetch_planner final : public fetch_planner::impl {
  * order as the partitions in the request.
  */
 
+/**
+ * Wait before the fetch plan is executed again. The partitions read by the
+ * fetch are watched by the session cache on behalf of its waiter, parked
+ * partitions of a session are watched on behalf of the session which wakes
+ * the waiter too. The fetch sleeps until one of them moved instead of
+ * re-reading them.
+ *
+ * The debounce still applies after a wakeup, a partition whose high watermark
+ * is above what can be read, e.g. the last stable offset, is marked ready as
+ * soon as it is parked.
+ */
+static ss::future<>
+wait_for_new_data(op_context& octx, uint64_t seen_notifications) {
+    auto& sessions = octx.rctx.fetch_sessions();
+    for (auto& [shard, requests] : std::exchange(octx.watched, {})) {
+        sessions.watch_partitions(
+          octx.rctx.partition_manager(),
+          shard,
+          {.waiter = octx.waiter},
+          std::move(requests));
+    }
+    co_await sessions.wait_for_waiter(
+      octx.waiter,
+      seen_notifications,
+      octx.deadline.value_or(model::no_timeout));
+    // debounce next read retry
+    co_await ss::sleep(std::min(
+      config::shard_local_cfg().fetch_reads_debounce_timeout(),
+      octx.request.data.max_wait_ms));
+}
+
 static ss::future<> fetch_topic_partitions(op_context& octx) {
+    if (!octx.initial_fetch) {
+        octx.add_ready_partitions();
+    } else if (octx.deadline) {
+        // the fetch may wait for data
+        octx.waiter = octx.rctx.fetch_sessions().register_waiter(
+          octx.session_ctx.is_sessionless()
+            ? invalid_fetch_session_id
+            : octx.session_ctx.session()->id());
+    }
+    octx.watched.clear();
+    // partitions that become ready while the plan is executed wake up the
+    // next wait right away
+    const auto seen_notifications
+      = octx.rctx.fetch_sessions().waiter_notifications(octx.waiter);
     auto planner = make_fetch_planner<simple_fetch_planner>();
 
     auto fetch_plan = planner.create_plan(octx);
@@ -536,10 +671,8 @@ static ss::future<> fetch_topic_partitions(op_context& octx) {
     }
 
     octx.reset_context();
-    // debounce next read retry
-    co_await ss::sleep(std::min(
-      config::shard_local_cfg().fetch_reads_debounce_timeout(),
-      octx.request.data.max_wait_ms));
+    co_await octx.rctx.exclude_from_request_time(
+      wait_for_new_data(octx, seen_notifications));
 }
 
 template<>
@@ -560,6 +693,11 @@ fetch_handler::handle(request_context rctx, ss::smp_service_group ssg) {
                 [&octx] { return octx.should_stop_fetch(); },
                 [&octx] { return fetch_topic_partitions(octx); });
           })
+          .finally([&octx] {
+              if (octx.waiter) {
+                  octx.rctx.fetch_sessions().unregister_waiter(octx.waiter);
+              }
+          })
           .then([&octx] { return std::move(octx).send_response(); });
     });
 }
@@ -593,6 +731,9 @@ op_context::op_context(request_context&& ctx, ss::smp_service_group ssg)
       config::shard_local_cfg().fetch_max_bytes(),
       size_t(request.data.max_bytes));
     session_ctx = rctx.fetch_sessions().maybe_get_session(request);
+    if (!session_ctx.is_sessionless() && !session_ctx.is_full_fetch()) {
+        fetch_set = session_ctx.session()->partitions().ready_partitions();
+    }
     create_response_placeholders();
 }
 
@@ -625,25 +766,41 @@ void op_context::create_response_placeholders() {
               start_response_partition(*v.partition);
           });
     } else {
-        model::topic last_topic;
-        std::for_each(
-          session_ctx.session()->partitions().cbegin_insertion_order(),
-          session_ctx.session()->partitions().cend_insertion_order(),
-          [this, &last_topic](const fetch_session_partition& fp) {
-              if (last_topic != fp.topic) {
-                  response.data.topics.emplace_back(
-                    fetchable_topic_response{.name = fp.topic});
-                  last_topic = fp.topic;
-              }
-              fetch_response::partition_response p{
-                .partition_index = fp.partition,
-                .error_code = error_code::none,
-                .high_watermark = fp.high_watermark,
-                .last_stable_offset = fp.last_stable_offset,
-                .records = batch_reader()};
-
-              response.data.topics.back().partitions.push_back(std::move(p));
-          });
+        // partitions that are not ready have nothing to be included in the
+        // response of an incremental fetch
+        for (auto fp : fetch_set) {
+            start_response_partition(*fp);
+        }
+    }
+}
+
+void op_context::start_response_partition(const fetch_session_partition& fp) {
+    if (
+      response.data.topics.empty()
+      || response.data.topics.back().name != fp.topic) {
+        response.data.topics.emplace_back(
+          fetchable_topic_response{.name = fp.topic});
+    }
+    response.data.topics.back().partitions.push_back(
+      fetch_response::partition_response{
+        .partition_index = fp.partition,
+        .error_code = error_code::none,
+        .high_watermark = fp.high_watermark,
+        .last_stable_offset = fp.last_stable_offset,
+        .records = batch_reader()});
+}
+
+void op_context::add_ready_partitions() {
+    if (session_ctx.is_sessionless() || session_ctx.is_full_fetch()) {
+        return;
+    }
+    absl::flat_hash_set<const fetch_session_partition*> in_fetch_set(
+      fetch_set.begin(), fetch_set.end());
+    for (auto fp : session_ctx.session()->partitions().ready_partitions()) {
+        if (!in_fetch_set.contains(fp)) {
+            fetch_set.push_back(fp);
+            start_response_partition(*fp);
+        }
     }
 }
 
@@ -748,6 +905,7 @@ void op_context::response_iterator::set(
     }
     *_it->partition_response = std::move(response);
 
+    bool parked = false;
     // if we are not sessionless update session cache
     if (!_ctx->session_ctx.is_sessionless()) {
         auto& session_partitions = _ctx->session_ctx.session()->partitions();
@@ -774,10 +932,36 @@ void op_context::response_iterator::set(
               _it->partition_response->records
               && _it->partition_response->records->size_bytes() > 0) {
                 session_partitions.move_to_end(it);
+                session_partitions.mark_ready(it);
+            } else if (
+              _it->partition_response->error_code == error_code::none) {
+                // read up to the high watermark, wait for new data
+                session_partitions.park(it);
+                parked = true;
+                _ctx->parked.push_back(fetch_session_cache::watch_request{
+                  .ntp = model::ntp(
+                    model::kafka_namespace,
+                    _it->partition->name,
+                    _it->partition_response->partition_index),
+                  .fetch_offset = it->second->partition.fetch_offset});
+            } else {
+                session_partitions.mark_ready(it);
             }
             _it->partition_response->has_to_be_included = has_to_be_included;
         }
     }
+    // a fetch waiting for more data is woken up once any of the partitions it
+    // read moves past the high watermark it has seen
+    if (
+      _ctx->waiter && !parked
+      && _it->partition_response->error_code == error_code::none) {
+        _ctx->read.push_back(fetch_session_cache::watch_request{
+          .ntp = model::ntp(
+            model::kafka_namespace,
+            _it->partition->name,
+            _it->partition_response->partition_index),
+          .fetch_offset = _it->partition_response->high_watermark});
+    }
 }
 
 op_context::response_iterator& op_context::response_iterator::operator++() {
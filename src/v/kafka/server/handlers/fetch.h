@@ -10,8 +10,11 @@
  */
 #pragma once
 #include "kafka/protocol/fetch.h"
+#include "kafka/server/fetch_session_cache.h"
 #include "kafka/server/handlers/handler.h"
 #include "kafka/types.h"
+#include "model/metadata.h"
+#include "utils/to_string.h"
 
 namespace kafka {
 
@@ -60,9 +63,25 @@ struct op_context {
     // reserve space for new partition in the response
     void start_response_partition(const fetch_request::partition&);
 
+    // add a session partition to the response, starting a new topic if it is
+    // not the one of the last partition
+    void start_response_partition(const fetch_session_partition&);
+
     // create placeholder for response topics and partitions
     void create_response_placeholders();
 
+    // add the session partitions that became ready while the fetch was
+    // waiting for data to the fetch set
+    void add_ready_partitions();
+
+    // the partition was read up to its high watermark, there is no need to
+    // read it again until the session is notified about new data
+    bool is_parked(const fetch_session_partition& fp) const {
+        return !session_ctx.is_sessionless()
+               && !session_ctx.session()->partitions().is_ready(
+                 model::topic_partition_view(fp.topic, fp.partition));
+    }
+
     bool is_empty_request() const {
         /**
          * If request doesn't have a session or it is a full fetch request, we
@@ -114,10 +133,9 @@ struct op_context {
                   });
               });
         } else {
-            std::for_each(
-              session_ctx.session()->partitions().cbegin_insertion_order(),
-              session_ctx.session()->partitions().cend_insertion_order(),
-              std::forward<Func>(f));
+            for (auto fp : fetch_set) {
+                f(*fp);
+            }
         }
     }
 
@@ -137,6 +155,18 @@ struct op_context {
 
     bool initial_fetch = true;
     fetch_session_ctx session_ctx;
+    // partitions of an incremental session that are read, i.e. the ready ones
+    std::vector<const fetch_session_partition*> fetch_set;
+    // partitions parked by the last shard fetch, see fetch_session_cache
+    std::vector<fetch_session_cache::watch_request> parked;
+    // partitions read by the last shard fetch, watched on behalf of the
+    // waiter if the fetch has to wait for more data
+    std::vector<fetch_session_cache::watch_request> read;
+    std::vector<
+      std::pair<ss::shard_id, std::vector<fetch_session_cache::watch_request>>>
+      watched;
+    // registered with the session cache when the fetch may wait for data
+    uint64_t waiter{0};
 };
 
 struct fetch_config {
@@ -148,17 +178,24 @@ struct fetch_config {
     bool strict_max_bytes{false};
     bool skip_read{false};
     kafka::leader_epoch current_leader_epoch;
+    // the consumer may be served by a follower (KIP-392)
+    bool read_from_follower{false};
+    // rack of the consumer, set when the leader may point the consumer to a
+    // replica in its rack
+    std::optional<model::rack_id> client_rack;
 
     friend std::ostream& operator<<(std::ostream& o, const fetch_config& cfg) {
         fmt::print(
           o,
-          R"({{"start_offset": {}, "max_offset": {}, "isolation_lvl": {}, "max_bytes": {}, "strict_max_bytes": {}, "current_leader_epoch:" {}}})",
+          R"({{"start_offset": {}, "max_offset": {}, "isolation_lvl": {}, "max_bytes": {}, "strict_max_bytes": {}, "current_leader_epoch:" {}, "read_from_follower": {}, "client_rack": {}}})",
           cfg.start_offset,
           cfg.max_offset,
           cfg.isolation_level,
           cfg.max_bytes,
           cfg.strict_max_bytes,
-          cfg.current_leader_epoch);
+          cfg.current_leader_epoch,
+          cfg.read_from_follower,
+          cfg.client_rack);
         return o;
     }
 };
@@ -250,6 +287,8 @@ struct read_result {
     error_code error;
     model::partition_id partition;
     std::vector<cluster::rm_stm::tx_range> aborted_transactions;
+    // replica the consumer should fetch from instead of the leader
+    std::optional<model::node_id> preferred_replica;
 };
 // struct aggregating fetch requests and corresponding response iterators for
 // the same shard
@@ -14,6 +14,7 @@
 #include "cluster/partition_manager.h"
 #include "cluster/shard_table.h"
 #include "config/configuration.h"
+#include "config/validators.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/protocol/kafka_batch_adapter.h"
 #include "kafka/server/replicated_partition.h"
@@ -65,11 +66,33 @@ produce_response produce_request::make_error_response(error_code error) const {
     return response;
 }
 
+/**
+ * A batch that is appended to a partition on its home shard
+ */
+struct partition_write {
+    model::ntp ntp;
+    model::batch_identity bid;
+    model::record_batch_reader reader;
+    int32_t num_records;
+    int64_t batch_size;
+};
+
+/**
+ * Writes of a produce request to the partitions of a single shard. All of them
+ * are sent to the shard in one cross core call and their results come back in
+ * one vector, in the order of the writes.
+ */
+struct shard_writes {
+    std::vector<partition_write> writes;
+    std::vector<ss::promise<produce_response::partition>> results;
+};
+
 struct produce_ctx {
     request_context rctx;
     produce_request request;
     produce_response response;
     ss::smp_service_group ssg;
+    std::vector<shard_writes> writes_per_shard;
 
     produce_ctx(
       request_context&& rctx,
@@ -77,7 +100,8 @@ struct produce_ctx {
       ss::smp_service_group ssg)
       : rctx(std::move(rctx))
       , request(std::move(request))
-      , ssg(ssg) {}
+      , ssg(ssg)
+      , writes_per_shard(ss::smp::count) {}
 };
 
 struct partition_produce_stages {
@@ -199,7 +223,8 @@ static partition_produce_stages partition_append(
 }
 
 /**
- * \brief handle writing to a single topic partition.
+ * \brief queue the write to a single topic partition, it is dispatched to the
+ * shard of the partition together with the other writes for that shard.
  */
 static partition_produce_stages produce_topic_partition(
   produce_ctx& octx,
@@ -246,95 +271,160 @@ static partition_produce_stages produce_topic_partition(
     auto reader = reader_from_lcore_batch(std::move(batch));
     auto start = std::chrono::steady_clock::now();
 
+    auto& sw = octx.writes_per_shard[*shard];
+    sw.writes.push_back(partition_write{
+      .ntp = std::move(ntp),
+      .bid = bid,
+      .reader = std::move(reader),
+      .num_records = num_records,
+      .batch_size = batch_size});
+    auto f = sw.results.emplace_back().get_future().then(
+      [&octx, start, m = octx.rctx.probe().auto_produce_measurement()](
+        produce_response::partition p) {
+          if (p.error_code == error_code::none) {
+              auto dur = std::chrono::steady_clock::now() - start;
+              octx.rctx.connection()->server().update_produce_latency(dur);
+          } else {
+              m->set_trace(false);
+          }
+          return p;
+      });
+    // dispatched together with the other writes of the shard
+    return partition_produce_stages{
+      .dispatched = ss::now(),
+      .produced = std::move(f),
+    };
+}
+
+struct shard_produce_stages {
+    ss::future<> dispatched;
+    ss::future<std::vector<produce_response::partition>> produced;
+};
+
+/*
+ * Appends the batches to the partitions of the current shard, the results are
+ * in the order of the writes.
+ */
+static shard_produce_stages append_on_shard(
+  cluster::partition_manager& mgr,
+  std::vector<partition_write> writes,
+  int16_t acks) {
+    std::vector<ss::future<>> dispatched;
+    std::vector<ss::future<produce_response::partition>> produced;
+    dispatched.reserve(writes.size());
+    produced.reserve(writes.size());
+    for (auto& w : writes) {
+        auto partition = mgr.get(w.ntp);
+        if (!partition) {
+            produced.push_back(
+              ss::make_ready_future<produce_response::partition>(
+                produce_response::partition{
+                  .partition_index = w.ntp.tp.partition,
+                  .error_code = error_code::unknown_topic_or_partition}));
+            continue;
+        }
+        if (unlikely(!partition->is_leader())) {
+            produced.push_back(
+              ss::make_ready_future<produce_response::partition>(
+                produce_response::partition{
+                  .partition_index = w.ntp.tp.partition,
+                  .error_code = error_code::not_leader_for_partition}));
+            continue;
+        }
+        auto stages = partition_append(
+          w.ntp.tp.partition,
+          ss::make_lw_shared<replicated_partition>(std::move(partition)),
+          w.bid,
+          std::move(w.reader),
+          acks,
+          w.num_records,
+          w.batch_size);
+        dispatched.push_back(std::move(stages.dispatched));
+        produced.push_back(std::move(stages.produced));
+    }
+    return shard_produce_stages{
+      .dispatched = ss::when_all_succeed(dispatched.begin(), dispatched.end()),
+      .produced = ss::when_all_succeed(produced.begin(), produced.end()),
+    };
+}
+
+/**
+ * \brief send the writes queued for a shard in a single cross core call
+ *
+ * The returned future is resolved once all of the writes were enqueued on the
+ * shard, the result of every write is delivered to its promise.
+ */
+static ss::future<>
+dispatch_shard_writes(produce_ctx& octx, ss::shard_id shard, shard_writes sw) {
+    if (sw.writes.empty()) {
+        return ss::now();
+    }
     auto dispatch = std::make_unique<ss::promise<>>();
     auto dispatch_f = dispatch->get_future();
-    auto m = octx.rctx.probe().auto_produce_measurement();
-    auto f
-      = octx.rctx.partition_manager()
-          .invoke_on(
-            *shard,
-            octx.ssg,
-            [reader = std::move(reader),
-             ntp = std::move(ntp),
-             dispatch = std::move(dispatch),
-             num_records,
-             batch_size,
-             bid,
-             acks = octx.request.data.acks,
-             source_shard = ss::this_shard_id()](
-              cluster::partition_manager& mgr) mutable {
-                auto partition = mgr.get(ntp);
-                if (!partition) {
-                    // submit back to promise source shard
-                    (void)ss::smp::submit_to(
-                      source_shard, [dispatch = std::move(dispatch)]() mutable {
-                          dispatch->set_value();
-                          dispatch.reset();
-                      });
-                    return ss::make_ready_future<produce_response::partition>(
-                      produce_response::partition{
-                        .partition_index = ntp.tp.partition,
-                        .error_code = error_code::unknown_topic_or_partition});
-                }
-                if (unlikely(!partition->is_leader())) {
-                    // submit back to promise source shard
-                    (void)ss::smp::submit_to(
-                      source_shard, [dispatch = std::move(dispatch)]() mutable {
-                          dispatch->set_value();
-                          dispatch.reset();
-                      });
-                    return ss::make_ready_future<produce_response::partition>(
-                      produce_response::partition{
-                        .partition_index = ntp.tp.partition,
-                        .error_code = error_code::not_leader_for_partition});
-                }
-                auto stages = partition_append(
-                  ntp.tp.partition,
-                  ss::make_lw_shared<replicated_partition>(
-                    std::move(partition)),
-                  bid,
-                  std::move(reader),
-                  acks,
-                  num_records,
-                  batch_size);
-                return stages.dispatched
-                  .then_wrapped([source_shard, dispatch = std::move(dispatch)](
-                                  ss::future<> f) mutable {
-                      if (f.failed()) {
-                          (void)ss::smp::submit_to(
-                            source_shard,
-                            [dispatch = std::move(dispatch),
-                             e = f.get_exception()]() mutable {
-                                dispatch->set_exception(e);
-                                dispatch.reset();
-                            });
-                          return;
-                      }
+    (void)octx.rctx.partition_manager()
+      .invoke_on(
+        shard,
+        octx.ssg,
+        [writes = std::move(sw.writes),
+         dispatch = std::move(dispatch),
+         acks = octx.request.data.acks,
+         source_shard = ss::this_shard_id()](
+          cluster::partition_manager& mgr) mutable {
+            auto stages = append_on_shard(mgr, std::move(writes), acks);
+            return stages.dispatched
+              .then_wrapped([source_shard, dispatch = std::move(dispatch)](
+                              ss::future<> f) mutable {
+                  // submit back to promise source shard
+                  if (f.failed()) {
                       (void)ss::smp::submit_to(
                         source_shard,
-                        [dispatch = std::move(dispatch)]() mutable {
-                            dispatch->set_value();
+                        [dispatch = std::move(dispatch),
+                         e = f.get_exception()]() mutable {
+                            dispatch->set_exception(e);
                             dispatch.reset();
                         });
-                  })
-                  .then([f = std::move(stages.produced)]() mutable {
-                      return std::move(f);
-                  });
-            })
-          .then([&octx, start, m = std::move(m)](
-                  produce_response::partition p) {
-              if (p.error_code == error_code::none) {
-                  auto dur = std::chrono::steady_clock::now() - start;
-                  octx.rctx.connection()->server().update_produce_latency(dur);
-              } else {
-                  m->set_trace(false);
-              }
-              return p;
-          });
-    return partition_produce_stages{
-      .dispatched = std::move(dispatch_f),
-      .produced = std::move(f),
-    };
+                      return;
+                  }
+                  (void)ss::smp::submit_to(
+                    source_shard, [dispatch = std::move(dispatch)]() mutable {
+                        dispatch->set_value();
+                        dispatch.reset();
+                    });
+              })
+              .then([f = std::move(stages.produced)]() mutable {
+                  return std::move(f);
+              });
+        })
+      .then_wrapped(
+        [results = std::move(sw.results)](
+          ss::future<std::vector<produce_response::partition>> f) mutable {
+            if (f.failed()) {
+                auto e = f.get_exception();
+                for (auto& r : results) {
+                    r.set_exception(e);
+                }
+                return;
+            }
+            auto partitions = f.get0();
+            for (size_t i = 0; i < results.size(); ++i) {
+                results[i].set_value(std::move(partitions[i]));
+            }
+        });
+    return dispatch_f;
+}
+
+/**
+ * \brief send the queued writes to their shards, one call per shard
+ */
+static ss::future<> dispatch_writes(produce_ctx& octx) {
+    std::vector<ss::future<>> dispatched;
+    dispatched.reserve(octx.writes_per_shard.size());
+    for (ss::shard_id shard = 0; shard < octx.writes_per_shard.size();
+         ++shard) {
+        dispatched.push_back(dispatch_shard_writes(
+          octx, shard, std::move(octx.writes_per_shard[shard])));
+    }
+    return ss::when_all_succeed(dispatched.begin(), dispatched.end());
 }
 
 /**
@@ -457,15 +547,62 @@ static std::vector<topic_produce_stages> produce_topics(produce_ctx& octx) {
     return topics;
 }
 
+/*
+ * Validation level of the batches produced by the client, the level for its
+ * principal takes precedence over the one for its listener.
+ */
+static batch_validation_level produce_validation_level(request_context& ctx) {
+    auto find = [](
+                  const std::vector<ss::sstring>& overrides,
+                  std::string_view name) -> std::optional<batch_validation_level> {
+        for (const auto& o : overrides) {
+            auto parsed = config::parse_produce_validation_override(o);
+            if (parsed && parsed->first == name) {
+                return batch_validation_level_from_string(parsed->second);
+            }
+        }
+        return std::nullopt;
+    };
+
+    const auto& principals
+      = config::shard_local_cfg().kafka_produce_validation_principals();
+    if (!principals.empty() && ctx.sasl().has_mechanism()) {
+        if (auto l = find(principals, ctx.sasl().principal()); l) {
+            return *l;
+        }
+    }
+    const auto& listeners
+      = config::shard_local_cfg().kafka_produce_validation_listeners();
+    if (!listeners.empty()) {
+        if (auto l = find(listeners, ctx.listener()); l) {
+            return *l;
+        }
+    }
+    return batch_validation_level::full;
+}
+
 process_result_stages
 produce_handler::handle(request_context ctx, ss::smp_service_group ssg) {
     produce_request request;
     request.decode(ctx.reader(), ctx.header().version);
 
-    // determine if the request has transactional / idemponent batches
+    // validate the batches and determine if the request has transactional /
+    // idemponent batches
+    const auto validation = produce_validation_level(ctx);
+    auto& probe = ctx.produce_probe();
     for (auto& topic : request.data.topics) {
         for (auto& part : topic.partitions) {
             if (part.records) {
+                auto& adapter = part.records->adapter;
+                probe.add_decompressed_bytes(adapter.decompressed_bytes);
+                if (auto checksummed = adapter.validate(validation);
+                    checksummed) {
+                    if (*checksummed == 0) {
+                        probe.unverified_batch();
+                    } else {
+                        probe.add_crc_verified_bytes(*checksummed);
+                    }
+                }
                 if (part.records->adapter.batch) {
                     const auto& hdr = part.records->adapter.batch->header();
                     request.has_transactional = request.has_transactional
@@ -535,6 +672,7 @@ produce_handler::handle(request_context ctx, ss::smp_service_group ssg) {
               dispatched.push_back(std::move(s.dispatched));
               produced.push_back(std::move(s.produced));
           }
+          dispatched.push_back(dispatch_writes(octx));
           return seastar::when_all_succeed(dispatched.begin(), dispatched.end())
             .then_wrapped([&octx,
                            dispatched_promise = std::move(dispatched_promise),
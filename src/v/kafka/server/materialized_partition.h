@@ -87,6 +87,13 @@ public:
 
     cluster::partition_probe& probe() final { return _probe; }
 
+    partition_info get_partition_info() const final {
+        // materialized topics are only read from the leader
+        partition_info ret;
+        ret.leader = _partition->source_partition()->get_leader_id();
+        return ret;
+    }
+
 private:
     static model::offset offset_or_zero(model::offset o) {
         return o > model::offset(0) ? o : model::offset(0);
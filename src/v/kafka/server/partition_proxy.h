@@ -13,6 +13,7 @@
 #include "cluster/metadata_cache.h"
 #include "cluster/partition.h"
 #include "coproc/fwd.h"
+#include "kafka/server/replica_selector.h"
 #include "kafka/types.h"
 #include "model/fundamental.h"
 #include "storage/translating_reader.h"
@@ -52,6 +53,7 @@ public:
             ss::lw_shared_ptr<const storage::offset_translator_state>)
           = 0;
         virtual cluster::partition_probe& probe() = 0;
+        virtual partition_info get_partition_info() const = 0;
         virtual ~impl() noexcept = default;
     };
 
@@ -96,6 +98,10 @@ public:
 
     cluster::partition_probe& probe() { return _impl->probe(); }
 
+    partition_info get_partition_info() const {
+        return _impl->get_partition_info();
+    }
+
     kafka::leader_epoch leader_epoch() const { return _impl->leader_epoch(); }
 
     std::optional<model::offset>
@@ -82,6 +82,8 @@ protocol::protocol(
         _qdc_mon.emplace(*qdc_config);
     }
     _probe.setup_metrics();
+    _produce_probe.setup_metrics();
+    _pipeline_probe.setup_metrics();
 }
 
 coordinator_ntp_mapper& protocol::coordinator_mapper() {
@@ -132,7 +134,11 @@ ss::future<> protocol::apply(net::server::resources rs) {
           }
           return ss::make_exception_future(eptr);
       })
-      .finally([ctx] {});
+      .finally([ctx] {
+          // the connection is closed once the responses of the pipelined
+          // requests were written
+          return ctx->wait_for_inflight_requests();
+      });
 }
 
 } // namespace kafka
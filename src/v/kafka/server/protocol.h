@@ -15,6 +15,8 @@
 #include "config/configuration.h"
 #include "coproc/fwd.h"
 #include "kafka/latency_probe.h"
+#include "kafka/pipeline_probe.h"
+#include "kafka/produce_probe.h"
 #include "kafka/server/fetch_metadata_cache.hh"
 #include "kafka/server/fwd.h"
 #include "kafka/server/queue_depth_monitor.h"
@@ -77,6 +79,9 @@ public:
     cluster::metadata_cache& metadata_cache() {
         return _metadata_cache.local();
     }
+    ss::sharded<cluster::metadata_cache>& sharded_metadata_cache() {
+        return _metadata_cache;
+    }
     cluster::id_allocator_frontend& id_allocator_frontend() {
         return _id_allocator_frontend.local();
     }
@@ -135,6 +140,8 @@ public:
     }
 
     latency_probe& probe() { return _probe; }
+    kafka::produce_probe& produce_probe() { return _produce_probe; }
+    kafka::pipeline_probe& pipeline_probe() { return _pipeline_probe; }
 
 private:
     ss::smp_service_group _smp_group;
@@ -161,6 +168,8 @@ private:
     kafka::fetch_metadata_cache _fetch_metadata_cache;
 
     latency_probe _probe;
+    kafka::produce_probe _produce_probe;
+    kafka::pipeline_probe _pipeline_probe;
 };
 
 } // namespace kafka
@@ -11,97 +11,250 @@
 
 #include "config/configuration.h"
 #include "kafka/server/logger.h"
+#include "ssx/future-util.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/smp.hh>
+
 #include <fmt/chrono.h>
 
+#include <algorithm>
 #include <chrono>
 
 namespace kafka {
 using clock = quota_manager::clock;
 using throttle_delay = quota_manager::throttle_delay;
 
-quota_manager::~quota_manager() { _gc_timer.cancel(); }
+quota_manager::~quota_manager() {
+    _gc_timer.cancel();
+    _reduce_timer.cancel();
+}
 
 ss::future<> quota_manager::stop() {
     _gc_timer.cancel();
-    return ss::make_ready_future<>();
+    _reduce_timer.cancel();
+    return _gate.close();
 }
 
 ss::future<> quota_manager::start() {
     _gc_timer.arm_periodic(_gc_freq);
+    // the next reduction is armed when the previous one finished so that
+    // they do not pile up on a busy node
+    _reduce_timer.set_callback([this] {
+        ssx::spawn_with_gate(_gate, [this] {
+            return reduce().finally([this] {
+                if (!_gate.is_closed()) {
+                    _reduce_timer.arm(_reduce_freq);
+                }
+            });
+        });
+    });
+    if (ss::this_shard_id() == reduce_shard && ss::smp::count > 1) {
+        _reduce_timer.arm(_reduce_freq);
+    }
     return ss::make_ready_future<>();
 }
 
-// record a new observation and return <previous delay, new delay>
-throttle_delay quota_manager::record_tp_and_throttle(
-  std::optional<std::string_view> client_id,
-  uint64_t bytes,
-  clock::time_point now) {
-    // requests without a client id are grouped into an anonymous group that
-    // shares a default quota. the anonymous group is keyed on empty string.
-    auto cid = client_id ? *client_id : "";
-
-    // find or create the throughput tracker for this client
-    //
-    // c++20: heterogeneous lookup for unordered_map can avoid creation of
-    // an sstring here but std::unordered_map::find isn't using an
-    // equal_to<> overload. this is a general issue we'll be looking at. for
-    // now, these client-name strings are small. This will be solved in
-    // c++20 via Hash::transparent_key_equal.
+quota_manager::quota&
+quota_manager::find_or_create(quota_key key, clock::time_point now) {
+    auto tracker = [this] {
+        return rate_tracker(
+          static_cast<size_t>(_default_num_windows()), _default_window_width());
+    };
     auto [it, inserted] = _quotas.try_emplace(
-      ss::sstring(cid),
+      std::move(key),
       quota{
-        now,
-        clock::duration(0),
-        {static_cast<size_t>(_default_num_windows()),
-         _default_window_width()}});
+        .last_seen = now,
+        .delay = clock::duration(0),
+        .local = {tracker(), tracker(), tracker()}});
 
     // bump to prevent gc
     if (!inserted) {
         it->second.last_seen = now;
     }
+    return it->second;
+}
 
-    auto rate = it->second.tp_rate.record_and_measure(bytes, now);
+std::optional<double> quota_manager::target_rate(quota_type type) const {
+    switch (type) {
+    case quota_type::produce:
+        return _target_tp_rate();
+    case quota_type::fetch:
+        if (auto r = _target_fetch_tp_rate(); r) {
+            return *r;
+        }
+        return std::nullopt;
+    case quota_type::request_time:
+        // percentage of the time of one core, in microseconds per second
+        if (auto p = _target_request_time(); p) {
+            return *p * 10'000.0;
+        }
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
 
+throttle_delay quota_manager::throttle(quota& q, clock::time_point now) {
+    // the delay is the one of the most violated quota
     std::chrono::milliseconds delay_ms(0);
-    if (rate > _target_tp_rate()) {
-        auto diff = rate - _target_tp_rate();
-        double delay = (diff / _target_tp_rate())
-                       * (double)std::chrono::milliseconds(
-                           it->second.tp_rate.window_size())
-                           .count();
-        delay_ms = std::chrono::milliseconds(static_cast<uint64_t>(delay));
+    double violation = 0;
+    for (size_t i = 0; i < num_quota_types; ++i) {
+        auto target = target_rate(static_cast<quota_type>(i));
+        if (!target) {
+            continue;
+        }
+        auto rate = q.remote[i] + q.local[i].measure(now);
+        if (rate > *target) {
+            auto diff = rate - *target;
+            double delay = (diff / *target)
+                           * (double)std::chrono::milliseconds(
+                               q.local[i].window_size())
+                               .count();
+            delay_ms = std::max(
+              delay_ms,
+              std::chrono::milliseconds(static_cast<uint64_t>(delay)));
+            violation = std::max(violation, rate / *target);
+        }
     }
     std::chrono::milliseconds max_delay_ms(_max_delay());
     if (delay_ms > max_delay_ms) {
         vlog(
           klog.info,
-          "Found data rate for window of: {} bytes. Client:{}, Estimated "
-          "backpressure delay of {}. Limiting to {} backpressure delay",
-          rate,
-          cid,
+          "Found node wide rate of {:.2f}x the quota, Estimated backpressure "
+          "delay of {}. Limiting to {} backpressure delay",
+          violation,
           delay_ms,
           max_delay_ms);
         delay_ms = max_delay_ms;
     }
 
-    auto prev = it->second.delay;
-    it->second.delay = delay_ms;
+    auto prev = q.delay;
+    q.delay = delay_ms;
 
     throttle_delay res{};
     res.first_violation = prev.count() == 0;
-    res.duration = it->second.delay;
+    res.duration = q.delay;
     return res;
 }
+
+// record a new observation and return <previous delay, new delay>
+throttle_delay quota_manager::record_tp_and_throttle(
+  std::string_view principal,
+  std::optional<std::string_view> client_id,
+  quota_type type,
+  uint64_t amount,
+  clock::time_point now) {
+    // requests without a client id are grouped into an anonymous group that
+    // shares a default quota. the anonymous group is keyed on empty string,
+    // and so are the connections without an authenticated principal.
+    auto& q = find_or_create(
+      quota_key{
+        .principal = ss::sstring(principal),
+        .client_id = ss::sstring(client_id ? *client_id : "")},
+      now);
+    q.local[static_cast<size_t>(type)].record_and_measure(
+      static_cast<double>(amount), now);
+    return throttle(q, now);
+}
+
+void quota_manager::record(
+  std::string_view principal,
+  std::optional<std::string_view> client_id,
+  quota_type type,
+  uint64_t amount,
+  clock::time_point now) {
+    auto& q = find_or_create(
+      quota_key{
+        .principal = ss::sstring(principal),
+        .client_id = ss::sstring(client_id ? *client_id : "")},
+      now);
+    q.local[static_cast<size_t>(type)].record_and_measure(
+      static_cast<double>(amount), now);
+}
+
+quota_manager::node_rates quota_manager::local_deltas(clock::time_point now) {
+    node_rates ret;
+    for (auto& [key, q] : _quotas) {
+        rates delta{};
+        bool changed = false;
+        for (size_t i = 0; i < num_quota_types; ++i) {
+            const auto rate = q.local[i].measure(now);
+            delta[i] = rate - q.reported[i];
+            changed = changed || delta[i] != 0;
+            q.reported[i] = rate;
+        }
+        if (changed || q.fresh) {
+            q.fresh = false;
+            ret.emplace(key, delta);
+        }
+    }
+    return ret;
+}
+
+void quota_manager::apply_node_rates(const node_rates& totals) {
+    for (const auto& [key, total] : totals) {
+        auto it = _quotas.find(key);
+        if (it == _quotas.end()) {
+            continue;
+        }
+        auto& q = it->second;
+        for (size_t i = 0; i < num_quota_types; ++i) {
+            q.remote[i] = std::max(0., total[i] - q.reported[i]);
+        }
+    }
+}
+
+ss::future<> quota_manager::reduce() {
+    auto deltas = co_await container().map_reduce0(
+      [](quota_manager& qm) { return qm.local_deltas(clock::now()); },
+      node_rates{},
+      [](node_rates acc, node_rates shard) {
+          for (auto& [key, delta] : shard) {
+              auto& total = acc[key];
+              for (size_t i = 0; i < num_quota_types; ++i) {
+                  total[i] += delta[i];
+              }
+          }
+          return acc;
+      });
+    if (deltas.empty()) {
+        co_return;
+    }
+    // fold the changes into the node wide rates. every shard that reported a
+    // client gets its new total, including shards that just started tracking
+    // it
+    node_rates changed;
+    changed.reserve(deltas.size());
+    for (auto& [key, delta] : deltas) {
+        auto& total = _node_rates[key];
+        bool active = false;
+        for (size_t i = 0; i < num_quota_types; ++i) {
+            total[i] = std::max(0., total[i] + delta[i]);
+            active = active || total[i] >= 1;
+        }
+        changed.emplace(key, total);
+        // inactive clients are dropped. summing deltas leaves a rounding
+        // residue, which is why less than one unit per second is ignored
+        if (!active) {
+            _node_rates.erase(key);
+        }
+    }
+    co_await container().invoke_on_all([&changed](quota_manager& qm) {
+        qm.apply_node_rates(changed);
+    });
+}
+
 // erase inactive tracked quotas. windows are considered inactive if they
 // have not received any updates in ten window's worth of time.
 void quota_manager::gc(clock::duration full_window) {
     auto now = clock::now();
+    // the rates of the expired quotas measured zero for many windows, so
+    // their contribution was already withdrawn from the node wide rates
     auto expire_age = full_window * 10;
     // c++20: replace with std::erase_if
     absl::erase_if(
-      _quotas, [now, expire_age](const std::pair<ss::sstring, quota>& q) {
+      _quotas, [now, expire_age](const std::pair<const quota_key, quota>& q) {
           return (now - q.second.last_seen) > expire_age;
       });
 }
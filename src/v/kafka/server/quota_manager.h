@@ -15,12 +15,16 @@
 #include "seastarx.h"
 
 #include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/lowres_clock.hh>
+#include <seastar/core/sharded.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/timer.hh>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
 
+#include <array>
 #include <chrono>
 #include <optional>
 #include <string_view>
@@ -29,25 +33,36 @@ namespace kafka {
 
 // quota_manager tracks quota usage
 //
+// usage is tracked separately for produced bytes, fetched bytes and the time
+// spent handling requests, per principal and client_id. the rates are measured
+// on the shard handling the connection and periodically reduced across shards,
+// so that a client spread over the connections of many shards is throttled
+// against its node wide rate. the rate of the other shards is at most one
+// reduce interval old. a reduction only exchanges the rates of the clients
+// whose rates changed or that a shard started tracking since the previous one,
+// and every shard only updates the clients it already tracks.
+//
 // TODO:
 //   - we will want to eventually add support for configuring the quotas and
 //   quota settings as runtime through the kafka api and other mechanisms.
 //
-//   - currently only total throughput per client_id is tracked. in the future
-//   we will want to support additional quotas and accouting granularities to be
-//   at parity with kafka. for example:
-//
-//      - splitting out rates separately for produce and fetch
-//      - accounting per user vs per client (these are separate in kafka)
-//
-//   - it may eventually be beneficial to periodically reduce stats across
-//   shards or track stats globally to produce a more accurate per-node
-//   representation of a statistic (e.g. bandwidth).
-//
-class quota_manager {
+class quota_manager : public ss::peering_sharded_service<quota_manager> {
 public:
     using clock = ss::lowres_clock;
 
+    // shard running the periodic reduction of the rates
+    static constexpr ss::shard_id reduce_shard = 0;
+
+    enum class quota_type : uint8_t {
+        // bytes of produce requests
+        produce = 0,
+        // bytes of fetch responses
+        fetch,
+        // microseconds spent handling requests
+        request_time,
+    };
+    static constexpr size_t num_quota_types = 3;
+
     struct throttle_delay {
         bool first_violation;
         clock::duration duration;
@@ -59,7 +74,13 @@ public:
       , _default_window_width(
           config::shard_local_cfg().default_window_sec.bind())
       , _target_tp_rate(config::shard_local_cfg().target_quota_byte_rate.bind())
+      , _target_fetch_tp_rate(
+          config::shard_local_cfg().target_fetch_quota_byte_rate.bind())
+      , _target_request_time(
+          config::shard_local_cfg().target_request_time_quota_percent.bind())
       , _gc_freq(config::shard_local_cfg().quota_manager_gc_sec())
+      , _reduce_freq(
+          config::shard_local_cfg().quota_manager_reduce_interval_ms())
       , _max_delay(
           config::shard_local_cfg().max_kafka_throttle_delay_ms.bind()) {
         _gc_timer.set_callback([this] {
@@ -79,36 +100,89 @@ public:
 
     ss::future<> start();
 
-    // record a new observation and return <previous delay, new delay>
+    // record a new observation and return the delay of the client against
+    // the node wide rates of all of its quotas
     throttle_delay record_tp_and_throttle(
+      std::string_view principal,
       std::optional<std::string_view> client_id,
-      uint64_t bytes,
+      quota_type type,
+      uint64_t amount,
       clock::time_point now = clock::now());
 
-private:
-    // erase inactive tracked quotas. windows are considered inactive if they
-    // have not received any updates in ten window's worth of time.
-    void gc(clock::duration full_window);
+    // record a new observation, e.g. the size of a response, which is
+    // accounted for when throttling the next request of the client
+    void record(
+      std::string_view principal,
+      std::optional<std::string_view> client_id,
+      quota_type type,
+      uint64_t amount,
+      clock::time_point now = clock::now());
+
+    // gather the rates of all shards and distribute the node wide rates. runs
+    // periodically on the reduce shard.
+    ss::future<> reduce();
 
 private:
+    struct quota_key {
+        ss::sstring principal;
+        ss::sstring client_id;
+
+        template<typename H>
+        friend H AbslHashValue(H h, const quota_key& k) {
+            return H::combine(std::move(h), k.principal, k.client_id);
+        }
+        bool operator==(const quota_key&) const = default;
+    };
+
+    using rates = std::array<double, num_quota_types>;
+    using node_rates = absl::flat_hash_map<quota_key, rates>;
+
     // last_seen: used for gc keepalive
     // delay: last calculated delay
-    // tp_rate: throughput tracking
+    // local: rates measured on this shard
+    // reported: local rates at the time of the last reduction
+    // remote: rates of the other shards at the time of the last reduction
+    // fresh: not part of a reduction yet, the node wide rates are unknown
     struct quota {
         clock::time_point last_seen;
         clock::duration delay;
-        rate_tracker tp_rate;
+        std::array<rate_tracker, num_quota_types> local;
+        rates reported{};
+        rates remote{};
+        bool fresh{true};
     };
 
+    quota& find_or_create(quota_key, clock::time_point now);
+    throttle_delay throttle(quota&, clock::time_point now);
+    std::optional<double> target_rate(quota_type) const;
+
+    // measure the local rates of every tracked client and return the change
+    // since the last reduction of the fresh clients and of those that changed
+    node_rates local_deltas(clock::time_point now);
+    // update the clients tracked by this shard with their node wide rates
+    void apply_node_rates(const node_rates&);
+
+    // erase inactive tracked quotas. windows are considered inactive if they
+    // have not received any updates in ten window's worth of time.
+    void gc(clock::duration full_window);
+
+private:
     config::binding<int16_t> _default_num_windows;
     config::binding<clock::duration> _default_window_width;
 
     config::binding<uint32_t> _target_tp_rate;
-    absl::flat_hash_map<ss::sstring, quota> _quotas;
+    config::binding<std::optional<uint32_t>> _target_fetch_tp_rate;
+    config::binding<std::optional<uint32_t>> _target_request_time;
+    absl::flat_hash_map<quota_key, quota> _quotas;
+    // node wide rates of the active clients, kept on the reduce shard
+    node_rates _node_rates;
 
     ss::timer<> _gc_timer;
     clock::duration _gc_freq;
+    ss::timer<> _reduce_timer;
+    clock::duration _reduce_freq;
     config::binding<clock::duration> _max_delay;
+    ss::gate _gate;
 };
 
 } // namespace kafka
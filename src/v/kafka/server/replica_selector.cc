@@ -0,0 +1,51 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#include "kafka/server/replica_selector.h"
+
+#include "cluster/metadata_cache.h"
+
+namespace kafka {
+
+bool rack_aware_replica_selector::in_rack(
+  model::node_id id, const model::rack_id& rack) const {
+    auto broker = _md_cache.get_broker(id);
+    return broker && (*broker)->rack() == rack;
+}
+
+std::optional<model::node_id> rack_aware_replica_selector::select_replica(
+  const client_info& c,
+  const partition_info& p,
+  model::offset fetch_offset) const {
+    if (!c.rack_id) {
+        return p.leader;
+    }
+    if (p.leader && in_rack(*p.leader, *c.rack_id)) {
+        return p.leader;
+    }
+
+    const replica_info* selected = nullptr;
+    for (const auto& r : p.replicas) {
+        if (
+          !r.is_alive || r.high_watermark < fetch_offset
+          || !in_rack(r.id, *c.rack_id)) {
+            continue;
+        }
+        if (!selected || r.high_watermark > selected->high_watermark) {
+            selected = &r;
+        }
+    }
+    if (selected) {
+        return selected->id;
+    }
+    return p.leader;
+}
+
+} // namespace kafka
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+#include "cluster/fwd.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+
+#include <optional>
+#include <vector>
+
+namespace kafka {
+
+struct replica_info {
+    model::node_id id;
+    // kafka offset up to which the replica has the data
+    model::offset high_watermark;
+    bool is_alive;
+};
+
+struct partition_info {
+    std::vector<replica_info> replicas;
+    std::optional<model::node_id> leader;
+};
+
+struct client_info {
+    std::optional<model::rack_id> rack_id;
+};
+
+/**
+ * Chooses the replica a consumer should fetch from, see KIP-392. The
+ * selection is returned to the consumer as the preferred read replica of the
+ * partition.
+ */
+class replica_selector {
+public:
+    virtual std::optional<model::node_id> select_replica(
+      const client_info&, const partition_info&, model::offset fetch_offset)
+      const = 0;
+
+    virtual ~replica_selector() = default;
+};
+
+/// always the leader, the behavior without follower fetching
+class select_leader_replica final : public replica_selector {
+public:
+    std::optional<model::node_id> select_replica(
+      const client_info&, const partition_info& p, model::offset) const final {
+        return p.leader;
+    }
+};
+
+/**
+ * Prefers the replicas in the rack of the consumer, based on the rack of the
+ * brokers in the members table. The leader is kept if it is in the rack of the
+ * consumer, otherwise the most up to date live replica that has the requested
+ * offset is chosen. Falls back to the leader when no replica qualifies.
+ */
+class rack_aware_replica_selector final : public replica_selector {
+public:
+    explicit rack_aware_replica_selector(const cluster::metadata_cache& md)
+      : _md_cache(md) {}
+
+    std::optional<model::node_id> select_replica(
+      const client_info&,
+      const partition_info&,
+      model::offset fetch_offset) const final;
+
+private:
+    bool in_rack(model::node_id, const model::rack_id&) const;
+
+    const cluster::metadata_cache& _md_cache;
+};
+
+} // namespace kafka
@@ -208,4 +208,32 @@ std::optional<model::offset> replicated_partition::get_leader_epoch_last_offset(
     }
     return std::nullopt;
 }
+
+partition_info replicated_partition::get_partition_info() const {
+    partition_info ret;
+    ret.leader = _partition->get_leader_id();
+    if (!_partition->is_leader()) {
+        return ret;
+    }
+    const auto hw = high_watermark();
+    ret.replicas.push_back(replica_info{
+      .id = _partition->raft()->self().id(),
+      .high_watermark = hw,
+      .is_alive = true});
+    for (const auto& f : _partition->get_follower_metrics()) {
+        if (f.is_learner) {
+            continue;
+        }
+        // a follower exposes at most what the leader made visible
+        auto follower_hw = std::min(
+          hw,
+          _translator->from_log_offset(
+            raft::details::next_offset(f.match_index)));
+        ret.replicas.push_back(replica_info{
+          .id = f.id,
+          .high_watermark = follower_hw,
+          .is_alive = f.is_live && !f.under_replicated});
+    }
+    return ret;
+}
 } // namespace kafka
@@ -89,6 +89,8 @@ public:
 
     cluster::partition_probe& probe() final { return _partition->probe(); }
 
+    partition_info get_partition_info() const final;
+
     std::optional<model::offset>
       get_leader_epoch_last_offset(kafka::leader_epoch) const final;
 
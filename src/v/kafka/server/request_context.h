@@ -17,6 +17,7 @@
 #include "kafka/server/connection_context.h"
 #include "kafka/server/fetch_session_cache.h"
 #include "kafka/server/logger.h"
+#include "kafka/server/request_timer.h"
 #include "kafka/server/protocol.h"
 #include "kafka/server/response.h"
 #include "kafka/types.h"
@@ -58,7 +59,8 @@ public:
       : _conn(std::move(conn))
       , _header(std::move(header))
       , _reader(std::move(request))
-      , _throttle_delay(throttle_delay) {}
+      , _throttle_delay(throttle_delay)
+      , _timer(ss::make_lw_shared<request_timer>()) {}
 
     request_context(const request_context&) = delete;
     request_context& operator=(const request_context&) = delete;
@@ -74,6 +76,10 @@ public:
 
     latency_probe& probe() { return _conn->server().probe(); }
 
+    kafka::produce_probe& produce_probe() {
+        return _conn->server().produce_probe();
+    }
+
     const cluster::metadata_cache& metadata_cache() const {
         return _conn->server().metadata_cache();
     }
@@ -82,6 +88,10 @@ public:
         return _conn->server().metadata_cache();
     }
 
+    ss::sharded<cluster::metadata_cache>& sharded_metadata_cache() {
+        return _conn->server().sharded_metadata_cache();
+    }
+
     cluster::topics_frontend& topics_frontend() const {
         return _conn->server().topics_frontend();
     }
@@ -189,11 +199,24 @@ public:
         return _conn->server().controller_api();
     }
 
+    // shared with the connection, which records the time once the handler
+    // completed
+    const ss::lw_shared_ptr<request_timer>& timer() const { return _timer; }
+
+    // the handler is idle until `f` resolves, e.g. it waits for a long poll
+    // or for another shard
+    template<typename T>
+    ss::future<T> exclude_from_request_time(ss::future<T> f) {
+        _timer->begin_wait();
+        return f.finally([timer = _timer] { timer->end_wait(); });
+    }
+
 private:
     ss::lw_shared_ptr<connection_context> _conn;
     request_header _header;
     request_reader _reader;
     ss::lowres_clock::duration _throttle_delay;
+    ss::lw_shared_ptr<request_timer> _timer;
 };
 
 // Executes the API call identified by the specified request_context.
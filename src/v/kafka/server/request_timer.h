@@ -0,0 +1,57 @@
+/*
+ * Copyright 2021 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace kafka {
+
+/**
+ * Time a request counts against the request time quota of its client: the
+ * wall time since it was dispatched less the time its handler waited, e.g.
+ * for a long poll to end or for reads on other shards.
+ */
+class request_timer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    clock::duration handling_time() const {
+        auto waited = _waited;
+        if (_waiting > 0) {
+            waited += clock::now() - _wait_start;
+        }
+        return std::max(clock::now() - _start - waited, clock::duration(0));
+    }
+
+    // waits may overlap, e.g. reads on several shards, the time during which
+    // at least one of them is pending counts as waiting once
+    void begin_wait() {
+        if (_waiting++ == 0) {
+            _wait_start = clock::now();
+        }
+    }
+    void end_wait() {
+        if (--_waiting == 0) {
+            _waited += clock::now() - _wait_start;
+        }
+    }
+
+private:
+    clock::time_point _start{clock::now()};
+    clock::time_point _wait_start;
+    clock::duration _waited{0};
+    size_t _waiting{0};
+};
+
+} // namespace kafka
@@ -0,0 +1,96 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/server/fetch_session.h"
+#include "model/fundamental.h"
+#include "model/namespace.h"
+#include "units.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+/*
+ * Per request session work of an incremental fetch from a consumer of 10k
+ * partitions of which few or none have new data, e.g. a consumer group
+ * subscribed to many mostly idle topics. Every partition that is part of the
+ * fetch is turned into a read, the time reported per run is the time per
+ * fetch request.
+ */
+struct idle_session_bench {
+    static constexpr int topics = 100;
+    static constexpr int partitions_per_topic = 100;
+
+    idle_session_bench()
+      : session(kafka::fetch_session_id(1)) {
+        for (int t = 0; t < topics; ++t) {
+            model::topic topic(fmt::format("topic-{}", t));
+            for (int p = 0; p < partitions_per_topic; ++p) {
+                session.partitions().emplace(kafka::fetch_session_partition{
+                  .topic = topic,
+                  .partition = model::partition_id(p),
+                  .max_bytes = 1_MiB,
+                  .fetch_offset = model::offset(1000),
+                  .high_watermark = model::offset(1000)});
+            }
+        }
+    }
+
+    // park all the partitions, every `stride`th is ready
+    void park_all_but_every(size_t stride) {
+        size_t i = 0;
+        for (auto it = session.partitions().begin();
+             it != session.partitions().end();
+             ++it, ++i) {
+            if (stride == 0 || i % stride != 0) {
+                session.partitions().park(it);
+            } else {
+                session.partitions().mark_ready(it);
+            }
+        }
+    }
+
+    static void plan_read(const kafka::fetch_session_partition& fp) {
+        model::ntp ntp(model::kafka_namespace, fp.topic, fp.partition);
+        perf_tests::do_not_optimize(ntp);
+        perf_tests::do_not_optimize(fp.fetch_offset);
+    }
+
+    // what a fetch did before the readiness sets, read every partition
+    size_t fetch_all() {
+        perf_tests::start_measuring_time();
+        std::for_each(
+          session.partitions().cbegin_insertion_order(),
+          session.partitions().cend_insertion_order(),
+          [](const kafka::fetch_session_partition& fp) { plan_read(fp); });
+        perf_tests::stop_measuring_time();
+        return 1;
+    }
+
+    size_t fetch_ready() {
+        perf_tests::start_measuring_time();
+        for (auto fp : session.partitions().ready_partitions()) {
+            plan_read(*fp);
+        }
+        perf_tests::stop_measuring_time();
+        return 1;
+    }
+
+    kafka::fetch_session session;
+};
+
+PERF_TEST_F(idle_session_bench, fetch_all_partitions) { return fetch_all(); }
+
+PERF_TEST_F(idle_session_bench, fetch_idle) {
+    park_all_but_every(0);
+    return fetch_ready();
+}
+
+PERF_TEST_F(idle_session_bench, fetch_one_percent_ready) {
+    park_all_but_every(100);
+    return fetch_ready();
+}
@@ -221,3 +221,107 @@ FIXTURE_TEST(test_session_operations, fixture) {
         BOOST_REQUIRE(cache.size() == 0);
     }
 }
+
+FIXTURE_TEST(test_session_ready_partitions, fixture) {
+    kafka::fetch_session session(kafka::fetch_session_id(123));
+    auto& partitions = session.partitions();
+    for (int i = 0; i < 5; ++i) {
+        partitions.emplace(make_fetch_partition(
+          model::topic("test"), model::partition_id(i), model::offset(0)));
+    }
+    auto ready_ids = [&partitions] {
+        std::vector<model::partition_id> ret;
+        for (auto fp : partitions.ready_partitions()) {
+            ret.push_back(fp->partition);
+        }
+        return ret;
+    };
+    auto key = [](int p) {
+        return model::topic_partition(
+          model::topic("test"), model::partition_id(p));
+    };
+
+    BOOST_TEST_MESSAGE("new partitions are ready");
+    BOOST_REQUIRE_EQUAL(ready_ids().size(), 5);
+
+    BOOST_TEST_MESSAGE("parked partitions are not ready");
+    partitions.park(partitions.find(key(1)));
+    partitions.park(partitions.find(key(3)));
+    BOOST_REQUIRE(!partitions.is_ready(key(1)));
+    BOOST_REQUIRE(partitions.is_ready(key(2)));
+    BOOST_REQUIRE(
+      ready_ids()
+      == std::vector<model::partition_id>(
+        {model::partition_id(0),
+         model::partition_id(2),
+         model::partition_id(4)}));
+
+    BOOST_TEST_MESSAGE("ready partitions follow the insertion order");
+    partitions.move_to_end(partitions.find(key(0)));
+    partitions.mark_ready(partitions.find(key(3)));
+    partitions.mark_ready(partitions.find(key(3)));
+    BOOST_REQUIRE(
+      ready_ids()
+      == std::vector<model::partition_id>(
+        {model::partition_id(2),
+         model::partition_id(3),
+         model::partition_id(4),
+         model::partition_id(0)}));
+
+    BOOST_TEST_MESSAGE("erased partitions leave the ready list");
+    partitions.erase(key(2));
+    BOOST_REQUIRE_EQUAL(ready_ids().size(), 3);
+}
+
+FIXTURE_TEST(test_incremental_fetch_marks_ready, fixture) {
+    kafka::fetch_session_cache cache(120s);
+    kafka::fetch_request req;
+    req.data.session_epoch = kafka::initial_fetch_session_epoch;
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.topics = {make_fetch_request_topic(model::topic("test"), 3)};
+
+    auto ctx = cache.maybe_get_session(req);
+    auto& partitions = ctx.session()->partitions();
+    for (int i = 0; i < 3; ++i) {
+        partitions.park(partitions.find(model::topic_partition(
+          model::topic("test"), model::partition_id(i))));
+    }
+    BOOST_REQUIRE(partitions.ready_partitions().empty());
+
+    // consumer moved its position in partition 1
+    req.data.session_id = ctx.session()->id();
+    req.data.session_epoch = ctx.session()->epoch();
+    req.data.topics[0].fetch_partitions.erase(
+      req.data.topics[0].fetch_partitions.begin());
+    req.data.topics[0].fetch_partitions.pop_back();
+    req.data.topics[0].fetch_partitions[0].fetch_offset = model::offset(100);
+
+    ctx = cache.maybe_get_session(req);
+    BOOST_REQUIRE(!ctx.is_full_fetch());
+    auto ready = ctx.session()->partitions().ready_partitions();
+    BOOST_REQUIRE_EQUAL(ready.size(), 1);
+    BOOST_REQUIRE_EQUAL(ready[0]->partition, model::partition_id(1));
+    BOOST_REQUIRE_EQUAL(ready[0]->fetch_offset, model::offset(100));
+}
+
+FIXTURE_TEST(test_session_wait_for_ready, fixture) {
+    kafka::fetch_session session(kafka::fetch_session_id(123));
+    auto seen = session.ready_notifications();
+
+    BOOST_TEST_MESSAGE("waits for a notification");
+    auto f = session.wait_for_ready(seen, model::timeout_clock::now() + 10s);
+    BOOST_REQUIRE(!f.available());
+    session.notify_ready();
+    f.get();
+
+    BOOST_TEST_MESSAGE("notifications before the wait wake it up right away");
+    BOOST_REQUIRE(
+      session.wait_for_ready(seen, model::timeout_clock::now() + 10s)
+        .available());
+
+    BOOST_TEST_MESSAGE("gives up at the deadline");
+    session
+      .wait_for_ready(
+        session.ready_notifications(), model::timeout_clock::now() + 10ms)
+      .get();
+}
@@ -0,0 +1,168 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/partition_manager.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/server/fetch_session_cache.h"
+#include "model/fundamental.h"
+#include "model/namespace.h"
+#include "redpanda/tests/fixture.h"
+#include "storage/tests/utils/random_batch.h"
+#include "test_utils/async.h"
+
+#include <seastar/core/smp.hh>
+
+#include <chrono>
+#include <optional>
+
+using namespace std::chrono_literals;
+
+/*
+ * parked partitions of a session whose home is this shard, while the
+ * partitions are managed by another shard
+ */
+struct watch_fixture : public redpanda_thread_fixture {
+    static constexpr int partitions = 8;
+
+    watch_fixture() {
+        BOOST_REQUIRE_GT(ss::smp::count, 1u);
+        wait_for_controller_leadership().get0();
+        add_topic(tp_ns, partitions).get();
+        for (int i = 0; i < partitions; ++i) {
+            wait_for_partition_offset(ntp(i), model::offset(0)).get0();
+        }
+    }
+
+    model::ntp ntp(int i) const {
+        return model::ntp(tp_ns.ns, tp_ns.tp, model::partition_id(i));
+    }
+
+    // a partition managed by another shard than the session
+    std::pair<model::ntp, ss::shard_id> remote_partition() {
+        std::optional<std::pair<model::ntp, ss::shard_id>> remote;
+        for (int i = 0; i < partitions && !remote; ++i) {
+            auto shard = app.shard_table.local().shard_for(ntp(i));
+            if (shard && *shard != ss::this_shard_id()) {
+                remote.emplace(ntp(i), *shard);
+            }
+        }
+        // the partitions are spread over all the shards
+        BOOST_REQUIRE(remote);
+        return *remote;
+    }
+
+    kafka::fetch_session_cache& sessions() {
+        return app.fetch_session_cache.local();
+    }
+
+    ss::future<size_t> watched_partitions(ss::shard_id shard) {
+        return app.fetch_session_cache.invoke_on(
+          shard,
+          [](kafka::fetch_session_cache& c) { return c.watched_partitions(); });
+    }
+
+    void wait_for_watched_partitions(ss::shard_id shard, size_t n) {
+        tests::cooperative_spin_wait_with_timeout(5s, [this, shard, n] {
+            return watched_partitions(shard).then(
+              [n](size_t watched) { return watched == n; });
+        }).get();
+    }
+
+    // the partition was read up to its end, the session waits for new data
+    kafka::fetch_session_ptr
+    park(const model::ntp& ntp, ss::shard_id shard) {
+        kafka::fetch_request req;
+        req.data.session_id = kafka::invalid_fetch_session_id;
+        req.data.session_epoch = kafka::initial_fetch_session_epoch;
+        req.data.topics = {{
+          .name = ntp.tp.topic,
+          .fetch_partitions = {{
+            .partition_index = ntp.tp.partition,
+            .fetch_offset = model::offset(0),
+            .max_bytes = 1_MiB,
+          }},
+        }};
+        auto session = sessions().maybe_get_session(req).session();
+        auto& partitions = session->partitions();
+        partitions.park(partitions.find(ntp.tp));
+        sessions().watch_partitions(
+          app.partition_manager,
+          shard,
+          {.session = session->id()},
+          {{.ntp = ntp, .fetch_offset = model::offset(0)}});
+
+        wait_for_watched_partitions(shard, 1);
+        BOOST_REQUIRE(!partitions.is_ready(ntp.tp));
+        return session;
+    }
+
+    void wait_for_ready(
+      const kafka::fetch_session_ptr& session, const model::ntp& ntp) {
+        tests::cooperative_spin_wait_with_timeout(5s, [&session, &ntp] {
+            return session->partitions().is_ready(ntp.tp);
+        }).get();
+    }
+
+    model::topic_namespace tp_ns{model::kafka_namespace, model::topic("foo")};
+};
+
+FIXTURE_TEST(produce_marks_remote_partition_ready, watch_fixture) {
+    auto [ntp, shard] = remote_partition();
+    auto session = park(ntp, shard);
+    auto notifications = session->ready_notifications();
+
+    app.partition_manager
+      .invoke_on(
+        shard,
+        [ntp = ntp](cluster::partition_manager& mgr) {
+            auto batches = storage::test::make_random_batches(
+              model::offset(0), 1);
+            return mgr.get(ntp)->replicate(
+              model::make_memory_record_batch_reader(std::move(batches)),
+              raft::replicate_options(raft::consistency_level::quorum_ack));
+        })
+      .get();
+
+    wait_for_ready(session, ntp);
+    BOOST_REQUIRE_GT(session->ready_notifications(), notifications);
+    // the watch is done once all its watchers were woken up
+    BOOST_REQUIRE_EQUAL(watched_partitions(shard).get0(), size_t(0));
+}
+
+FIXTURE_TEST(term_change_wakes_all_watchers, watch_fixture) {
+    auto [ntp, shard] = remote_partition();
+    auto session = park(ntp, shard);
+
+    // the partition is idle, a new term wakes the watchers all the same
+    app.partition_manager
+      .invoke_on(
+        shard,
+        [ntp = ntp](cluster::partition_manager& mgr) {
+            auto p = mgr.get(ntp);
+            return p->raft()->step_down(p->term() + model::term_id(1));
+        })
+      .get();
+
+    wait_for_ready(session, ntp);
+    BOOST_REQUIRE_EQUAL(watched_partitions(shard).get0(), size_t(0));
+}
+
+FIXTURE_TEST(closed_session_drops_watchers, watch_fixture) {
+    auto [ntp, shard] = remote_partition();
+    auto session = park(ntp, shard);
+
+    // a full fetch with the final epoch closes the session
+    kafka::fetch_request req;
+    req.data.session_id = session->id();
+    req.data.session_epoch = kafka::final_fetch_session_epoch;
+    sessions().maybe_get_session(req);
+    BOOST_REQUIRE_EQUAL(sessions().size(), 0);
+
+    wait_for_watched_partitions(shard, 0);
+}
@@ -7,7 +7,9 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "config/configuration.h"
 #include "kafka/protocol/batch_consumer.h"
+#include "kafka/server/fetch_session_cache.h"
 #include "kafka/server/handlers/fetch.h"
 #include "kafka/types.h"
 #include "model/fundamental.h"
@@ -509,6 +511,188 @@ FIXTURE_TEST(fetch_one_debounce, redpanda_thread_fixture) {
     BOOST_REQUIRE(resp.data.topics[0].partitions[0].records->size_bytes() > 0);
 }
 
+FIXTURE_TEST(fetch_long_poll_request_time, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    model::partition_id pid(0);
+    auto ntp = make_default_ntp(topic, pid);
+
+    wait_for_controller_leadership().get0();
+    add_topic(model::topic_namespace_view(ntp)).get();
+    wait_for_partition_offset(ntp, model::offset(0)).get0();
+
+    kafka::fetch_request req;
+    req.data.max_bytes = std::numeric_limits<int32_t>::max();
+    req.data.min_bytes = 1;
+    req.data.max_wait_ms = std::chrono::milliseconds(500);
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.session_epoch = kafka::final_fetch_session_epoch;
+    req.data.topics = {{
+      .name = topic,
+      .fetch_partitions = {{
+        .partition_index = pid,
+        .fetch_offset = model::offset(0),
+      }},
+    }};
+
+    auto rctx = make_fetch_request_context(
+      std::move(req), kafka::api_version(4));
+    auto timer = rctx.timer();
+    auto start = std::chrono::steady_clock::now();
+    kafka::fetch_handler::handle(
+      std::move(rctx), ss::default_smp_service_group())
+      .get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // the fetch long polled until its deadline, the wait does not count
+    // against the request time quota of the client
+    BOOST_REQUIRE_GE(elapsed, 400ms);
+    BOOST_REQUIRE_LT(timer->handling_time(), elapsed / 2);
+}
+
+static void produce_to(redpanda_thread_fixture& f, const model::ntp& ntp) {
+    auto shard = f.app.shard_table.local().shard_for(ntp);
+    f.app.partition_manager
+      .invoke_on(
+        *shard,
+        [ntp](cluster::partition_manager& mgr) {
+            auto batches = storage::test::make_random_batches(
+              model::offset(0), 1);
+            return mgr.get(ntp)->replicate(
+              model::make_memory_record_batch_reader(std::move(batches)),
+              raft::replicate_options(raft::consistency_level::quorum_ack));
+        })
+      .get();
+}
+
+static kafka::fetch_request
+make_long_poll(const model::topic& topic, int partitions) {
+    kafka::fetch_request req;
+    req.data.max_bytes = std::numeric_limits<int32_t>::max();
+    req.data.min_bytes = 1;
+    req.data.max_wait_ms = std::chrono::milliseconds(10000);
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.session_epoch = kafka::final_fetch_session_epoch;
+    req.data.topics = {{.name = topic}};
+    for (int i = 0; i < partitions; ++i) {
+        kafka::fetch_request::partition p;
+        p.partition_index = model::partition_id(i);
+        p.log_start_offset = model::offset(0);
+        p.fetch_offset = model::offset(0);
+        p.max_bytes = std::numeric_limits<int32_t>::max();
+        req.data.topics[0].fetch_partitions.push_back(p);
+    }
+    return req;
+}
+
+FIXTURE_TEST(fetch_long_poll_wakes_on_produce, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    constexpr int partitions = 4;
+    wait_for_controller_leadership().get0();
+    add_topic(model::topic_namespace(model::kafka_namespace, topic), partitions)
+      .get();
+    for (int i = 0; i < partitions; ++i) {
+        wait_for_partition_offset(
+          make_default_ntp(topic, model::partition_id(i)), model::offset(0))
+          .get0();
+    }
+    auto& sessions = app.fetch_session_cache.local();
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+    auto start = std::chrono::steady_clock::now();
+    auto fresp = client.dispatch(
+      make_long_poll(topic, partitions), kafka::api_version(7));
+
+    // the sessionless fetch waits for any of the partitions it read to move
+    // instead of polling them
+    tests::cooperative_spin_wait_with_timeout(5s, [&sessions] {
+        return sessions.watched_partitions() == size_t(partitions);
+    }).get();
+    produce_to(*this, make_default_ntp(topic, model::partition_id(2)));
+
+    auto resp = fresp.get0();
+    BOOST_REQUIRE_LT(std::chrono::steady_clock::now() - start, 5s);
+    BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+    BOOST_REQUIRE(resp.data.topics[0].partitions[2].records);
+    BOOST_REQUIRE_GT(
+      resp.data.topics[0].partitions[2].records->size_bytes(), 0);
+
+    // the watchers of the fetch are dropped once it is done
+    tests::cooperative_spin_wait_with_timeout(5s, [&sessions] {
+        return sessions.watched_partitions() == 0;
+    }).get();
+    client.stop().then([&client] { client.shutdown(); }).get();
+}
+
+FIXTURE_TEST(
+  fetch_session_long_poll_reads_ready_partitions, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    constexpr int partitions = 4;
+    wait_for_controller_leadership().get0();
+    add_topic(model::topic_namespace(model::kafka_namespace, topic), partitions)
+      .get();
+    for (int i = 0; i < partitions; ++i) {
+        wait_for_partition_offset(
+          make_default_ntp(topic, model::partition_id(i)), model::offset(0))
+          .get0();
+    }
+    auto& sessions = app.fetch_session_cache.local();
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+
+    // the full fetch creates the session, the partitions are read up to
+    // their end and parked
+    auto req = make_long_poll(topic, partitions);
+    req.data.max_wait_ms = std::chrono::milliseconds(0);
+    req.data.session_epoch = kafka::initial_fetch_session_epoch;
+    auto full = client.dispatch(std::move(req), kafka::api_version(7)).get0();
+    BOOST_REQUIRE_NE(full.data.session_id, kafka::invalid_fetch_session_id);
+    tests::cooperative_spin_wait_with_timeout(5s, [&sessions] {
+        return sessions.watched_partitions() == size_t(partitions);
+    }).get();
+
+    // an incremental fetch without changes long polls
+    kafka::fetch_request incremental;
+    incremental.data.max_bytes = std::numeric_limits<int32_t>::max();
+    incremental.data.min_bytes = 1;
+    incremental.data.max_wait_ms = std::chrono::milliseconds(10000);
+    incremental.data.session_id = full.data.session_id;
+    incremental.data.session_epoch = kafka::fetch_session_epoch(1);
+    auto start = std::chrono::steady_clock::now();
+    auto fresp = client.dispatch(std::move(incremental), kafka::api_version(7));
+    produce_to(*this, make_default_ntp(topic, model::partition_id(1)));
+
+    auto resp = fresp.get0();
+    BOOST_REQUIRE_LT(std::chrono::steady_clock::now() - start, 5s);
+    // only the partition that moved is in the incremental response
+    BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+    BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+    BOOST_REQUIRE_EQUAL(
+      resp.data.topics[0].partitions[0].partition_index,
+      model::partition_id(1));
+    BOOST_REQUIRE(resp.data.topics[0].partitions[0].records);
+    BOOST_REQUIRE_GT(
+      resp.data.topics[0].partitions[0].records->size_bytes(), 0);
+
+    // the idle partitions were not read again, they are still parked and
+    // watched, the one that moved woke the fetch up once
+    kafka::fetch_request next;
+    next.data.session_id = full.data.session_id;
+    next.data.session_epoch = kafka::fetch_session_epoch(2);
+    auto session = sessions.maybe_get_session(next).session();
+    BOOST_REQUIRE(session);
+    BOOST_REQUIRE_EQUAL(session->ready_notifications(), 1);
+    for (int i = 0; i < partitions; ++i) {
+        BOOST_REQUIRE_EQUAL(
+          session->partitions().is_ready(
+            model::topic_partition_view(topic, model::partition_id(i))),
+          i == 1);
+    }
+    BOOST_REQUIRE_EQUAL(sessions.watched_partitions(), size_t(partitions - 1));
+    client.stop().then([&client] { client.shutdown(); }).get();
+}
+
 FIXTURE_TEST(fetch_multi_topics, redpanda_thread_fixture) {
     // create a topic partition with some data
     model::topic topic_1("foo");
@@ -665,3 +849,73 @@ FIXTURE_TEST(fetch_request_max_bytes, redpanda_thread_fixture) {
     BOOST_REQUIRE(
       fetch_one_byte.data.topics[0].partitions[0].records->size_bytes() > 0);
 }
+
+FIXTURE_TEST(fetch_with_client_rack, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    model::partition_id pid(0);
+    auto ntp = make_default_ntp(topic, pid);
+
+    wait_for_controller_leadership().get0();
+
+    add_topic(model::topic_namespace_view(ntp)).get();
+    wait_for_partition_offset(ntp, model::offset(0)).get0();
+    auto shard = app.shard_table.local().shard_for(ntp);
+    app.partition_manager
+      .invoke_on(
+        *shard,
+        [ntp](cluster::partition_manager& mgr) {
+            auto partition = mgr.get(ntp);
+            auto batches = storage::test::make_random_batches(
+              model::offset(0), 5);
+            auto rdr = model::make_memory_record_batch_reader(
+              std::move(batches));
+            return partition->replicate(
+              std::move(rdr),
+              raft::replicate_options(raft::consistency_level::quorum_ack));
+        })
+      .get();
+
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg()
+          .get("enable_follower_fetching")
+          .set_value(true);
+    }).get();
+
+    auto fetch = [this, &topic, &pid](ss::sstring rack) {
+        kafka::fetch_request req;
+        req.data.max_bytes = std::numeric_limits<int32_t>::max();
+        req.data.min_bytes = 1;
+        req.data.max_wait_ms = std::chrono::milliseconds(0);
+        req.data.session_id = kafka::invalid_fetch_session_id;
+        req.data.rack_id = std::move(rack);
+        req.data.topics = {{
+          .name = topic,
+          .fetch_partitions = {{
+            .partition_index = pid,
+            .fetch_offset = model::offset(0),
+          }},
+        }};
+
+        auto client = make_kafka_client().get();
+        client.connect().get();
+        auto resp = client.dispatch(req, kafka::api_version(11)).get();
+        client.stop().then([&client] { client.shutdown(); }).get();
+        return resp;
+    };
+
+    // the leader is the only replica, it serves consumers from any rack
+    for (auto rack : {ss::sstring(rack_name), ss::sstring("other-rack")}) {
+        auto resp = fetch(rack);
+        BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+        BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+        const auto& p = resp.data.topics[0].partitions[0];
+        BOOST_REQUIRE(p.error_code == kafka::error_code::none);
+        BOOST_REQUIRE_EQUAL(p.preferred_read_replica, model::node_id(-1));
+        BOOST_REQUIRE(p.records);
+        BOOST_REQUIRE_GT(p.records->size_bytes(), 0);
+    }
+
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg().get("enable_follower_fetching").reset();
+    }).get();
+}
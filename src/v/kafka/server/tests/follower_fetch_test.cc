@@ -0,0 +1,145 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/tests/cluster_test_fixture.h"
+#include "cluster/topics_frontend.h"
+#include "kafka/client/transport.h"
+#include "kafka/protocol/fetch.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "model/namespace.h"
+#include "ssx/sformat.h"
+#include "test_utils/async.h"
+
+#include <seastar/core/sleep.hh>
+
+#include <chrono>
+#include <optional>
+
+using namespace std::chrono_literals;
+
+/*
+ * three brokers, each in its own rack, and a partition replicated to all of
+ * them
+ */
+struct follower_fetch_fixture : public cluster_test_fixture {
+    static constexpr int nodes = 3;
+    static constexpr int kafka_port = 9092;
+
+    follower_fetch_fixture() {
+        for (int i = 0; i < nodes; ++i) {
+            create_node_application(
+              model::node_id(i),
+              kafka_port,
+              11000,
+              8082,
+              8081,
+              43189,
+              rack(model::node_id(i)));
+        }
+        wait_for_all_members(5s).get();
+        set_configuration("enable_follower_fetching", true);
+    }
+
+    ~follower_fetch_fixture() override {
+        ss::smp::invoke_on_all([] {
+            config::shard_local_cfg().get("enable_follower_fetching").reset();
+        }).get();
+    }
+
+    static model::rack_id rack(model::node_id id) {
+        return model::rack_id(ssx::sformat("rack-{}", id()));
+    }
+
+    model::node_id create_replicated_topic() {
+        std::optional<model::node_id> controller;
+        tests::cooperative_spin_wait_with_timeout(5s, [this, &controller] {
+            controller = get_local_cache(model::node_id(0))
+                           .get_controller_leader_id();
+            return controller.has_value();
+        }).get();
+
+        std::vector<cluster::topic_configuration> topics;
+        topics.emplace_back(ntp.ns, ntp.tp.topic, 1, nodes);
+        auto res = get_node_application(*controller)
+                     ->controller->get_topics_frontend()
+                     .local()
+                     .create_topics(
+                       cluster::without_custom_assignments(std::move(topics)),
+                       model::timeout_clock::now() + 5s)
+                     .get0();
+        BOOST_REQUIRE_EQUAL(res.size(), size_t(1));
+        BOOST_REQUIRE(res[0].ec == cluster::errc::success);
+
+        std::optional<model::node_id> leader;
+        tests::cooperative_spin_wait_with_timeout(10s, [this, &leader] {
+            leader = get_local_cache(model::node_id(0)).get_leader_id(ntp);
+            return leader.has_value();
+        }).get();
+        return *leader;
+    }
+
+    kafka::fetch_response
+    fetch(model::node_id broker, const model::rack_id& client_rack) {
+        kafka::fetch_request req;
+        req.data.max_bytes = std::numeric_limits<int32_t>::max();
+        req.data.min_bytes = 1;
+        req.data.max_wait_ms = 0ms;
+        req.data.session_id = kafka::invalid_fetch_session_id;
+        req.data.rack_id = client_rack;
+        req.data.topics = {{
+          .name = ntp.tp.topic,
+          .fetch_partitions = {{
+            .partition_index = ntp.tp.partition,
+            .fetch_offset = model::offset(0),
+          }},
+        }};
+
+        kafka::client::transport client(net::base_transport::configuration{
+          .server_addr = net::unresolved_address(
+            "127.0.0.1", kafka_port + broker()),
+        });
+        client.connect().get();
+        auto resp
+          = client.dispatch(std::move(req), kafka::api_version(11)).get0();
+        client.stop().then([&client] { client.shutdown(); }).get();
+        return resp;
+    }
+
+    model::ntp ntp{
+      model::kafka_namespace, model::topic("foo"), model::partition_id(0)};
+};
+
+FIXTURE_TEST(preferred_replica_is_in_client_rack, follower_fetch_fixture) {
+    auto leader = create_replicated_topic();
+    auto follower = model::node_id((leader() + 1) % nodes);
+
+    // the leader points the consumer to the follower of its rack once the
+    // follower is known to be alive and caught up
+    auto deadline = model::timeout_clock::now() + 10s;
+    std::optional<model::node_id> preferred;
+    while (preferred != follower && model::timeout_clock::now() < deadline) {
+        auto resp = fetch(leader, rack(follower));
+        const auto& p = resp.data.topics[0].partitions[0];
+        // the partition may not be ready on the leader yet
+        if (p.error_code == kafka::error_code::none) {
+            preferred = p.preferred_read_replica;
+        }
+        if (preferred != follower) {
+            ss::sleep(100ms).get();
+        }
+    }
+    BOOST_REQUIRE(preferred == follower);
+
+    // a consumer in the rack of the leader is served by the leader
+    auto resp = fetch(leader, rack(leader));
+    BOOST_REQUIRE_EQUAL(
+      resp.data.topics[0].partitions[0].preferred_read_replica,
+      model::node_id(-1));
+}
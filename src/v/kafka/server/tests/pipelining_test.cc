@@ -0,0 +1,267 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "config/configuration.h"
+#include "kafka/client/transport.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/protocol/metadata.h"
+#include "kafka/protocol/produce.h"
+#include "kafka/server/protocol_utils.h"
+#include "redpanda/tests/fixture.h"
+#include "storage/record_batch_builder.h"
+#include "test_utils/async.h"
+#include "units.h"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/util/defer.hh>
+
+#include <chrono>
+#include <optional>
+
+using namespace std::chrono_literals;
+
+/*
+ * writes requests back to back, without waiting for the responses of the
+ * earlier ones
+ */
+class pipelining_client : public kafka::client::transport {
+public:
+    using kafka::client::transport::transport;
+
+    struct response {
+        kafka::correlation_id correlation;
+        iobuf data;
+    };
+
+    template<typename T>
+    void add(T request, kafka::api_version version) {
+        iobuf body;
+        kafka::response_writer writer(body);
+        request.encode(writer, version);
+        add(T::api_type::key, version, std::move(body));
+    }
+
+    void add(kafka::api_key key, kafka::api_version version, iobuf body) {
+        iobuf buf;
+        auto ph = buf.reserve(sizeof(int32_t));
+        kafka::response_writer writer(buf);
+        writer.write(int16_t(key()));
+        writer.write(int16_t(version()));
+        writer.write(int32_t(_correlation()));
+        writer.write(std::string_view("pipelining_client"));
+        _correlation = _correlation + kafka::correlation_id(1);
+        buf.append(std::move(body));
+
+        auto size = ss::cpu_to_be(
+          int32_t(buf.size_bytes() - sizeof(int32_t)));
+        ph.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        _pending.append(std::move(buf));
+    }
+
+    ss::future<> flush() {
+        return _out.write(iobuf_as_scattered(std::exchange(_pending, {})));
+    }
+
+    // std::nullopt once the server closed the connection
+    ss::future<std::optional<response>> receive() {
+        auto size = co_await kafka::parse_size(_in);
+        if (!size) {
+            co_return std::nullopt;
+        }
+        auto correlation = co_await _in.read_exactly(sizeof(int32_t));
+        auto data = co_await read_iobuf_exactly(
+          _in, *size - sizeof(int32_t));
+        co_return response{
+          .correlation = kafka::correlation_id(
+            ss::read_be<int32_t>(correlation.get())),
+          .data = std::move(data)};
+    }
+
+private:
+    kafka::correlation_id _correlation{0};
+    iobuf _pending;
+};
+
+struct pipelining_fixture : public redpanda_thread_fixture {
+    pipelining_fixture() { wait_for_controller_leadership().get0(); }
+
+    model::ntp add_empty_topic(ss::sstring name) {
+        auto ntp = make_default_ntp(
+          model::topic(std::move(name)), model::partition_id(0));
+        add_topic(model::topic_namespace_view(ntp)).get();
+        wait_for_partition_offset(ntp, model::offset(0)).get0();
+        return ntp;
+    }
+
+    static pipelining_client make_client() {
+        return pipelining_client(net::base_transport::configuration{
+          .server_addr = config::node().kafka_api()[0].address,
+        });
+    }
+
+    // long polls until the deadline, the partition has no data
+    static kafka::fetch_request
+    long_poll(const model::ntp& ntp, std::chrono::milliseconds max_wait) {
+        kafka::fetch_request::partition partition;
+        partition.partition_index = ntp.tp.partition;
+        partition.fetch_offset = model::offset(0);
+        partition.log_start_offset = model::offset(0);
+        partition.max_bytes = 1_MiB;
+        kafka::fetch_request::topic topic;
+        topic.name = ntp.tp.topic;
+        topic.fetch_partitions.push_back(partition);
+
+        kafka::fetch_request req;
+        req.data.min_bytes = 1;
+        req.data.max_bytes = 10_MiB;
+        req.data.max_wait_ms = max_wait;
+        req.data.topics.push_back(std::move(topic));
+        return req;
+    }
+
+    void wait_for_probe(std::function<bool(const kafka::pipeline_probe&)> p) {
+        tests::cooperative_spin_wait_with_timeout(5s, [this, p] {
+            return p(kafka_pipeline_probe());
+        }).get();
+    }
+
+    static void require_next(
+      pipelining_client& client, kafka::correlation_id correlation) {
+        auto r = client.receive().get0();
+        BOOST_REQUIRE(r);
+        BOOST_REQUIRE_EQUAL(r->correlation, correlation);
+    }
+};
+
+static constexpr auto fetch_version = kafka::api_version(4);
+static constexpr auto metadata_version = kafka::api_version(7);
+static constexpr auto produce_version = kafka::api_version(7);
+
+FIXTURE_TEST(metadata_completes_during_long_poll, pipelining_fixture) {
+    auto ntp = add_empty_topic("foo");
+    auto client = make_client();
+    client.connect().get();
+    auto inflight = kafka_pipeline_probe().inflight_requests();
+
+    client.add(long_poll(ntp, 3s), fetch_version);
+    client.add(kafka::metadata_request{}, metadata_version);
+    client.flush().get();
+
+    // the metadata response is ready while the fetch still waits for data
+    wait_for_probe([inflight](const kafka::pipeline_probe& probe) {
+        return probe.inflight_requests() == inflight + 2
+               && probe.blocked_responses() == 1;
+    });
+
+    // and is written in order
+    require_next(client, kafka::correlation_id(0));
+    require_next(client, kafka::correlation_id(1));
+    wait_for_probe([inflight](const kafka::pipeline_probe& probe) {
+        return probe.inflight_requests() == inflight
+               && probe.blocked_responses() == 0;
+    });
+    client.stop().get();
+}
+
+FIXTURE_TEST(window_bounds_inflight_requests, pipelining_fixture) {
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg()
+          .get("kafka_max_inflight_requests_per_connection")
+          .set_value(uint32_t(2));
+    }).get();
+    auto reset = ss::defer([] {
+        ss::smp::invoke_on_all([] {
+            config::shard_local_cfg()
+              .get("kafka_max_inflight_requests_per_connection")
+              .reset();
+        }).get();
+    });
+
+    auto ntp = add_empty_topic("foo");
+    auto client = make_client();
+    client.connect().get();
+    auto inflight = kafka_pipeline_probe().inflight_requests();
+    auto window_full = kafka_pipeline_probe().window_full_requests();
+
+    for (int i = 0; i < 3; ++i) {
+        client.add(long_poll(ntp, 1s), fetch_version);
+    }
+    client.flush().get();
+
+    // the third request waits until the first response was written
+    wait_for_probe([inflight, window_full](const kafka::pipeline_probe& probe) {
+        return probe.window_full_requests() == window_full + 1;
+    });
+    BOOST_REQUIRE_EQUAL(
+      kafka_pipeline_probe().inflight_requests(), inflight + 2);
+
+    for (int i = 0; i < 3; ++i) {
+        require_next(client, kafka::correlation_id(i));
+    }
+    client.stop().get();
+}
+
+FIXTURE_TEST(produce_ordered_behind_pipelined_fetch, pipelining_fixture) {
+    auto fetched = add_empty_topic("foo");
+    auto produced = add_empty_topic("bar");
+    auto client = make_client();
+    client.connect().get();
+
+    storage::record_batch_builder builder(
+      model::record_batch_type::raft_data, model::offset(0));
+    builder.add_raw_kv(iobuf{}, iobuf{});
+    kafka::produce_request::partition partition;
+    partition.partition_index = produced.tp.partition;
+    partition.records.emplace(std::move(builder).build());
+    kafka::produce_request::topic topic;
+    topic.name = produced.tp.topic;
+    topic.partitions.push_back(std::move(partition));
+    std::vector<kafka::produce_request::topic> topics;
+    topics.push_back(std::move(topic));
+    kafka::produce_request produce(std::nullopt, 1, std::move(topics));
+    produce.data.timeout_ms = 2s;
+
+    client.add(long_poll(fetched, 500ms), fetch_version);
+    client.add(std::move(produce), produce_version);
+    client.flush().get();
+
+    require_next(client, kafka::correlation_id(0));
+    auto r = client.receive().get0();
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(r->correlation, kafka::correlation_id(1));
+    kafka::produce_response resp;
+    resp.decode(std::move(r->data), produce_version);
+    BOOST_REQUIRE_EQUAL(
+      resp.data.responses.begin()->partitions.begin()->error_code,
+      kafka::error_code::none);
+    client.stop().get();
+}
+
+FIXTURE_TEST(failed_first_stage_releases_window, pipelining_fixture) {
+    auto ntp = add_empty_topic("foo");
+    auto client = make_client();
+    client.connect().get();
+    auto inflight = kafka_pipeline_probe().inflight_requests();
+
+    client.add(long_poll(ntp, 500ms), fetch_version);
+    // a metadata request without a body fails to decode in the handler
+    client.add(kafka::metadata_api::key, metadata_version, iobuf{});
+    client.flush().get();
+
+    // the earlier response is still written, then the connection is closed
+    require_next(client, kafka::correlation_id(0));
+    BOOST_REQUIRE(!client.receive().get0());
+    wait_for_probe([inflight](const kafka::pipeline_probe& probe) {
+        return probe.inflight_requests() == inflight
+               && probe.blocked_responses() == 0;
+    });
+    client.stop().get();
+}
@@ -0,0 +1,92 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "kafka/client/transport.h"
+#include "kafka/protocol/produce.h"
+#include "model/fundamental.h"
+#include "redpanda/tests/fixture.h"
+#include "storage/record_batch_builder.h"
+#include "test_utils/async.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/testing/perf_tests.hh>
+
+using namespace std::chrono_literals; // NOLINT
+
+/*
+ * Produce requests of a producer writing a small batch to each of the 256
+ * partitions of a topic, spread over all the shards of the node. The time
+ * reported per run is the time per produce request.
+ */
+struct produce_fan_out_bench : redpanda_thread_fixture {
+    static constexpr int partitions = 256;
+    static constexpr int records_per_batch = 10;
+
+    produce_fan_out_bench() {
+        wait_for_controller_leadership().get();
+        producer = std::make_unique<kafka::client::transport>(
+          make_kafka_client().get0());
+        producer->connect().get();
+        model::topic_namespace tp_ns(model::kafka_namespace, topic);
+        add_topic(tp_ns, partitions).get();
+        for (int i = 0; i < partitions; ++i) {
+            model::ntp ntp(tp_ns.ns, tp_ns.tp, model::partition_id(i));
+            tests::cooperative_spin_wait_with_timeout(10s, [this, ntp] {
+                auto shard = app.shard_table.local().shard_for(ntp);
+                if (!shard) {
+                    return ss::make_ready_future<bool>(false);
+                }
+                return app.partition_manager.invoke_on(
+                  *shard, [ntp](cluster::partition_manager& pm) {
+                      auto p = pm.get(ntp);
+                      return p && p->is_leader();
+                  });
+            }).get();
+        }
+    }
+
+    kafka::produce_request make_request() {
+        kafka::produce_request::topic tp;
+        tp.name = topic;
+        for (int i = 0; i < partitions; ++i) {
+            storage::record_batch_builder builder(
+              model::record_batch_type::raft_data, model::offset(0));
+            for (int r = 0; r < records_per_batch; ++r) {
+                builder.add_raw_kv(iobuf{}, iobuf{});
+            }
+            kafka::produce_request::partition partition;
+            partition.partition_index = model::partition_id(i);
+            partition.records.emplace(std::move(builder).build());
+            tp.partitions.push_back(std::move(partition));
+        }
+        std::vector<kafka::produce_request::topic> topics;
+        topics.push_back(std::move(tp));
+        kafka::produce_request req(std::nullopt, 1, std::move(topics));
+        req.data.timeout_ms = std::chrono::seconds(10);
+        req.has_idempotent = false;
+        req.has_transactional = false;
+        return req;
+    }
+
+    ss::future<size_t> produce() {
+        auto req = make_request();
+        perf_tests::start_measuring_time();
+        auto resp = co_await producer->dispatch(std::move(req));
+        perf_tests::stop_measuring_time();
+        perf_tests::do_not_optimize(resp);
+        co_return 1;
+    }
+
+    std::unique_ptr<kafka::client::transport> producer;
+    const model::topic topic = model::topic("fan-out");
+};
+
+PERF_TEST_F(produce_fan_out_bench, produce_256_partitions) {
+    return produce();
+}
@@ -0,0 +1,133 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "kafka/server/quota_manager.h"
+#include "units.h"
+
+#include <seastar/core/sharded.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+using quota_type = kafka::quota_manager::quota_type;
+using namespace std::chrono_literals;
+
+static void set_fetch_quota(std::optional<uint32_t> rate) {
+    ss::smp::invoke_on_all([rate] {
+        config::shard_local_cfg()
+          .get("target_fetch_quota_byte_rate")
+          .set_value(rate);
+    }).get0();
+}
+
+static ss::lowres_clock::duration throttle_on(
+  ss::sharded<kafka::quota_manager>& qm,
+  ss::shard_id shard,
+  ss::sstring principal,
+  ss::sstring client_id) {
+    return qm
+      .invoke_on(
+        shard,
+        [principal, client_id](kafka::quota_manager& q) {
+            return q
+              .record_tp_and_throttle(
+                principal, client_id, quota_type::fetch, 0)
+              .duration;
+        })
+      .get0();
+}
+
+/*
+ * a client fetching from every shard stays below its quota on each of them,
+ * the node wide rate exceeds it once the rates were reduced
+ */
+SEASTAR_THREAD_TEST_CASE(quota_manager_node_wide_fetch_rate) {
+    BOOST_REQUIRE_GE(ss::smp::count, 2);
+    set_fetch_quota(1_MiB);
+    ss::sharded<kafka::quota_manager> qm;
+    qm.start().get();
+
+    // the rate is measured over at least nine windows of a second
+    const uint64_t per_shard = 1_MiB * 9 * 3 / 4;
+    qm.invoke_on_all([per_shard](kafka::quota_manager& q) {
+          q.record("alice", "consumer", quota_type::fetch, per_shard);
+      })
+      .get();
+
+    for (auto s = 0U; s < ss::smp::count; ++s) {
+        BOOST_REQUIRE(throttle_on(qm, s, "alice", "consumer") == 0ms);
+    }
+
+    qm.invoke_on(kafka::quota_manager::reduce_shard, [](auto& q) {
+          return q.reduce();
+      })
+      .get();
+
+    for (auto s = 0U; s < ss::smp::count; ++s) {
+        BOOST_REQUIRE(throttle_on(qm, s, "alice", "consumer") > 0ms);
+        // quotas are separate per principal and client id
+        BOOST_REQUIRE(throttle_on(qm, s, "bob", "consumer") == 0ms);
+        BOOST_REQUIRE(throttle_on(qm, s, "alice", "other") == 0ms);
+    }
+
+    qm.stop().get();
+    set_fetch_quota(std::nullopt);
+}
+
+/*
+ * a shard learns the node wide rate of a client once it tracks the client,
+ * even if the rate did not change since the previous reduction
+ */
+SEASTAR_THREAD_TEST_CASE(quota_manager_node_wide_rate_of_new_client) {
+    BOOST_REQUIRE_GE(ss::smp::count, 2);
+    set_fetch_quota(1_MiB);
+    ss::sharded<kafka::quota_manager> qm;
+    qm.start().get();
+
+    auto reduce = [&qm] {
+        qm.invoke_on(kafka::quota_manager::reduce_shard, [](auto& q) {
+              return q.reduce();
+          })
+          .get();
+    };
+
+    // the client is only active on shard 1
+    qm.invoke_on(1, [](kafka::quota_manager& q) {
+          q.record("alice", "consumer", quota_type::fetch, 1_MiB * 9 * 2);
+      })
+      .get();
+    reduce();
+
+    // shard 0 did not track the client during the reduction
+    BOOST_REQUIRE(throttle_on(qm, 0, "alice", "consumer") == 0ms);
+    reduce();
+    BOOST_REQUIRE(throttle_on(qm, 0, "alice", "consumer") > 0ms);
+
+    qm.stop().get();
+    set_fetch_quota(std::nullopt);
+}
+
+SEASTAR_THREAD_TEST_CASE(quota_manager_separate_produce_and_fetch) {
+    set_fetch_quota(1_MiB);
+    ss::sharded<kafka::quota_manager> qm;
+    qm.start().get();
+
+    // produced bytes do not count against the fetch quota
+    auto delay = qm.local().record_tp_and_throttle(
+      "alice", "producer", quota_type::produce, 100_MiB);
+    BOOST_REQUIRE(delay.duration == 0ms);
+
+    delay = qm.local().record_tp_and_throttle(
+      "alice", "producer", quota_type::fetch, 100_MiB);
+    BOOST_REQUIRE(delay.first_violation);
+    BOOST_REQUIRE(delay.duration > 0ms);
+
+    qm.stop().get();
+    set_fetch_quota(std::nullopt);
+}
@@ -0,0 +1,123 @@
+// Copyright 2021 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "cluster/health_monitor_frontend.h"
+#include "cluster/members_table.h"
+#include "cluster/metadata_cache.h"
+#include "cluster/partition_leaders_table.h"
+#include "cluster/topic_table.h"
+#include "kafka/server/replica_selector.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+
+#include <seastar/core/sharded.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <optional>
+
+/*
+ * brokers 0 and 1 are in rack a, broker 2 in rack b and broker 3 has no rack.
+ * Only the members table backs the metadata cache.
+ */
+struct selector_fixture {
+    selector_fixture()
+      : cache(topics, members, leaders, health_monitor)
+      , selector(cache) {
+        members.start().get();
+        std::vector<model::broker> brokers;
+        brokers.push_back(make_broker(0, model::rack_id("a")));
+        brokers.push_back(make_broker(1, model::rack_id("a")));
+        brokers.push_back(make_broker(2, model::rack_id("b")));
+        brokers.push_back(make_broker(3, std::nullopt));
+        members.local().update_brokers(model::offset(0), brokers);
+    }
+
+    ~selector_fixture() { members.stop().get(); }
+
+    static model::broker
+    make_broker(int id, std::optional<model::rack_id> rack) {
+        return model::broker(
+          model::node_id(id),
+          net::unresolved_address("localhost", 9092),
+          net::unresolved_address("localhost", 33145),
+          std::move(rack),
+          model::broker_properties{.cores = 1});
+    }
+
+    static kafka::replica_info
+    replica(int id, int64_t high_watermark, bool is_alive = true) {
+        return kafka::replica_info{
+          .id = model::node_id(id),
+          .high_watermark = model::offset(high_watermark),
+          .is_alive = is_alive};
+    }
+
+    std::optional<model::node_id> select(
+      std::optional<ss::sstring> rack,
+      const kafka::partition_info& p,
+      int64_t fetch_offset = 0) {
+        std::optional<model::rack_id> rack_id;
+        if (rack) {
+            rack_id = model::rack_id(*rack);
+        }
+        return selector.select_replica(
+          kafka::client_info{.rack_id = rack_id},
+          p,
+          model::offset(fetch_offset));
+    }
+
+    ss::sharded<cluster::topic_table> topics;
+    ss::sharded<cluster::members_table> members;
+    ss::sharded<cluster::partition_leaders_table> leaders;
+    ss::sharded<cluster::health_monitor_frontend> health_monitor;
+    cluster::metadata_cache cache;
+    kafka::rack_aware_replica_selector selector;
+};
+
+SEASTAR_THREAD_TEST_CASE(selects_follower_in_client_rack) {
+    selector_fixture f;
+    kafka::partition_info p{
+      .replicas = {f.replica(2, 10), f.replica(0, 8), f.replica(1, 10)},
+      .leader = model::node_id(2)};
+
+    // the most up to date replica of the rack
+    BOOST_REQUIRE(f.select("a", p, 5) == model::node_id(1));
+    // the leader in the rack of the client is kept
+    BOOST_REQUIRE(f.select("b", p, 5) == model::node_id(2));
+}
+
+SEASTAR_THREAD_TEST_CASE(excludes_stale_and_dead_followers) {
+    selector_fixture f;
+    kafka::partition_info p{
+      .replicas
+      = {f.replica(2, 10), f.replica(0, 4), f.replica(1, 10, false)},
+      .leader = model::node_id(2)};
+
+    // follower 0 does not have the fetch offset yet and 1 is not alive
+    BOOST_REQUIRE(f.select("a", p, 5) == model::node_id(2));
+    // once the fetch offset is replicated follower 0 qualifies
+    BOOST_REQUIRE(f.select("a", p, 4) == model::node_id(0));
+}
+
+SEASTAR_THREAD_TEST_CASE(falls_back_to_leader) {
+    selector_fixture f;
+    kafka::partition_info p{
+      .replicas = {f.replica(0, 10), f.replica(1, 10), f.replica(3, 10)},
+      .leader = model::node_id(0)};
+    kafka::partition_info leaderless{
+      .replicas = {f.replica(2, 10)}, .leader = std::nullopt};
+
+    // client without a rack
+    BOOST_REQUIRE(f.select(std::nullopt, p) == model::node_id(0));
+    // no replica in the rack of the client
+    BOOST_REQUIRE(f.select("c", p) == model::node_id(0));
+    // unknown leader
+    BOOST_REQUIRE(!f.select("a", leaderless));
+    BOOST_REQUIRE(f.select("b", leaderless) == model::node_id(2));
+}
@@ -14,19 +14,29 @@
 #include "reflection/adl.h"
 #include "utils/vint.h"
 
+#include <array>
+#include <cstring>
 #include <type_traits>
 
 namespace model {
 
-template<typename T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
-void crc_extend_cpu_to_le(crc::crc32c& crc, T i) {
-    auto j = ss::cpu_to_le(i);
-    crc.extend(j);
+/*
+ * The header fields are hashed with a single crc extend call over a stack
+ * buffer. crc32c is hardware accelerated, and for inputs this small the cost
+ * is dominated by the per call overhead rather than by the bytes hashed.
+ */
+template<typename... T>
+void crc_extend_all(crc::crc32c& crc, T... t) {
+    static_assert((std::is_integral_v<T> && ...));
+    std::array<char, (sizeof(T) + ...)> buf;
+    char* out = buf.data();
+    ((std::memcpy(out, &t, sizeof(t)), out += sizeof(t)), ...);
+    crc.extend(buf.data(), buf.size());
 }
 
 template<typename... T>
 void crc_extend_all_cpu_to_le(crc::crc32c& crc, T... t) {
-    ((crc_extend_cpu_to_le(crc, t)), ...);
+    crc_extend_all(crc, ss::cpu_to_le(t)...);
 }
 
 /// \brief uint32_t because that's what crc32c uses
@@ -54,15 +64,9 @@ uint32_t internal_header_only_crc(const record_batch_header& header) {
     return c.value();
 }
 
-template<typename T, typename = std::enable_if_t<std::is_integral_v<T>, T>>
-void crc_extend_cpu_to_be(crc::crc32c& crc, T i) {
-    auto j = ss::cpu_to_be(i);
-    crc.extend(j);
-}
-
 template<typename... T>
 void crc_extend_all_cpu_to_be(crc::crc32c& crc, T... t) {
-    ((crc_extend_cpu_to_be(crc, t)), ...);
+    crc_extend_all(crc, ss::cpu_to_be(t)...);
 }
 
 void crc_record_batch_header(
@@ -78,3 +78,38 @@ SEASTAR_THREAD_TEST_CASE(set_max_timestamp) {
     BOOST_TEST(crc == batch.header().crc);
     BOOST_TEST(hdr_crc == batch.header().header_crc);
 }
+
+/*
+ * checksums of fixed batches. the expected values were computed with an
+ * independent crc32c implementation following the on-disk and kafka
+ * encodings, and must never change.
+ */
+BOOST_AUTO_TEST_CASE(crc_of_empty_batch) {
+    model::record_batch_header hdr;
+    BOOST_REQUIRE_EQUAL(model::crc_record_batch(hdr, iobuf{}), 1499445213);
+    BOOST_REQUIRE_EQUAL(model::internal_header_only_crc(hdr), 0x6cb857abU);
+}
+
+BOOST_AUTO_TEST_CASE(crc_of_known_batch) {
+    const std::string_view data = "redpanda record data";
+    iobuf records;
+    records.append(data.data(), data.size());
+
+    model::record_batch_header hdr;
+    hdr.size_bytes = model::packed_record_batch_header_size
+                     + records.size_bytes();
+    hdr.base_offset = model::offset(1000);
+    hdr.type = model::record_batch_type::raft_data;
+    hdr.attrs = model::record_batch_attributes(0x11);
+    hdr.last_offset_delta = 9;
+    hdr.first_timestamp = model::timestamp(1600000000000);
+    hdr.max_timestamp = model::timestamp(1600000000042);
+    hdr.producer_id = -1;
+    hdr.producer_epoch = -1;
+    hdr.base_sequence = -1;
+    hdr.record_count = 10;
+
+    hdr.crc = model::crc_record_batch(hdr, records);
+    BOOST_REQUIRE_EQUAL(hdr.crc, 105454015);
+    BOOST_REQUIRE_EQUAL(model::internal_header_only_crc(hdr), 0x36b951b8U);
+}
@@ -11,7 +11,9 @@
 #include <seastar/util/later.hh>
 #include <seastar/util/variant_utils.hh>
 
+#include <algorithm>
 #include <exception>
+#include <optional>
 #include <variant>
 #include <vector>
 namespace raft {
@@ -91,16 +93,24 @@ ss::future<> append_entries_buffer::flush() {
 
 ss::future<> append_entries_buffer::do_flush(
   request_t requests, response_t response_promises, ss::semaphore_units<> u) {
-    bool needs_flush = false;
+    const bool needs_flush = std::any_of(
+      requests.begin(), requests.end(), [](const append_entries_request& r) {
+          return bool(r.flush);
+      });
     std::vector<reply_t> replies;
     auto f = ss::now();
     {
         ss::semaphore_units<> op_lock_units = std::move(u);
+        // let the flushes of other groups wait for these appends, so that a
+        // single group commit round covers them
+        std::optional<group_commit::append_guard> append_guard;
+        if (
+          needs_flush && _consensus._group_commit
+          && _consensus._group_commit->get().enabled()) {
+            append_guard.emplace(_consensus._group_commit->get().start_append());
+        }
         replies.reserve(requests.size());
         for (auto& req : requests) {
-            if (req.flush) {
-                needs_flush = true;
-            }
             try {
                 // NOTE: do_append_entries do not flush
                 auto reply = co_await _consensus.do_append_entries(
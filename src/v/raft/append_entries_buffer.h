@@ -111,6 +111,11 @@ class consensus;
  * Described approach allows us to reduce number of expensive log::flush
  * operations.
  *
+ * Buffers of different groups on the same shard append at the same time on a
+ * follower with many groups. While appending requests that have to be flushed
+ * a buffer holds a group_commit::append_guard, so that the flushes of all the
+ * groups wait for each other and are issued in a single group commit round.
+ *
  * The class is taking additional advantage by setting all replies committed
  * offset to the latest value updated by log::flush. Since all the requests were
  * already sent by the leader it means that leader already appendend all
@@ -9,7 +9,9 @@
 
 #include "raft/consensus.h"
 
+#include "bytes/utils.h"
 #include "config/configuration.h"
+#include "hashing/crc32c.h"
 #include "likely.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
@@ -21,6 +23,7 @@
 #include "raft/errc.h"
 #include "raft/group_configuration.h"
 #include "raft/logger.h"
+#include "raft/node_liveness.h"
 #include "raft/prevote_stm.h"
 #include "raft/recovery_stm.h"
 #include "raft/replicate_entries_stm.h"
@@ -69,7 +72,8 @@ consensus::consensus(
   consensus::leader_cb_t cb,
   storage::api& storage,
   std::optional<std::reference_wrapper<recovery_throttle>> recovery_throttle,
-  recovery_memory_quota& recovery_mem_quota)
+  recovery_memory_quota& recovery_mem_quota,
+  std::optional<std::reference_wrapper<group_commit>> log_group_commit)
   : _self(nid, initial_cfg.revision_id())
   , _group(group)
   , _jit(std::move(jit))
@@ -99,6 +103,7 @@ consensus::consensus(
   , _storage(storage)
   , _recovery_throttle(recovery_throttle)
   , _recovery_mem_quota(recovery_mem_quota)
+  , _group_commit(log_group_commit)
   , _snapshot_mgr(
       std::filesystem::path(_log.config().work_directory()),
       storage::simple_snapshot_manager::default_snapshot_filename,
@@ -138,6 +143,18 @@ void consensus::setup_metrics() {
          },
          sm::description("Indicates if current raft group configuration is in "
                          "joint state i.e. configuration is being changed"),
+         labels),
+       sm::make_gauge(
+         "append_entries_in_flight",
+         [this] { return _fstats.append_entries_in_flight(); },
+         sm::description("Number of append entries requests sent to the "
+                         "followers waiting for a reply"),
+         labels),
+       sm::make_derive(
+         "append_entries_pipeline_stalls",
+         [this] { return _fstats.append_entries_pipeline_stalls(); },
+         sm::description("Number of append entries requests delayed as the "
+                         "maximum number of requests were in flight"),
          labels)});
 }
 
@@ -205,6 +222,7 @@ ss::future<> consensus::stop() {
     for (auto& idx : _fstats) {
         idx.second.follower_state_change.broken();
     }
+    _recovery_mem_quota.read_cache().invalidate(_group);
     return _event_manager.stop()
       .then([this] { return _append_requests_buffer.stop(); })
       .then([this] { return _batcher.stop(); })
@@ -721,6 +739,7 @@ bool consensus::should_skip_vote(bool ignore_heartbeat) {
     if (likely(!ignore_heartbeat)) {
         auto last_election = clock_type::now() - _jit.base_duration();
         skip_vote |= (_hbeat > last_election); // nothing to do.
+        skip_vote |= quiescent_leader_alive(last_election);
     }
 
     skip_vote |= _vstate == vote_state::leader; // already a leader
@@ -1348,6 +1367,8 @@ ss::future<vote_reply> consensus::do_vote(vote_request&& r) {
     // and an <= present term), reset their RPC backoff to get
     // a heartbeat sent out sooner.
     if (is_leader() and r.term <= _term) {
+        // the requester may have missed the heartbeat that made it quiescent
+        reset_follower_quiescence(r.node_id);
         // Look up follower stats for the requester
         if (auto it = _fstats.find(r.node_id); it != _fstats.end()) {
             auto& fstats = it->second;
@@ -1376,8 +1397,8 @@ ss::future<vote_reply> consensus::do_vote(vote_request&& r) {
     // transfer grant the vote immediately.
     auto prev_election = clock_type::now() - _jit.base_duration();
     if (
-      _hbeat > prev_election && !r.leadership_transfer
-      && r.node_id != _voted_for) {
+      (_hbeat > prev_election || quiescent_leader_alive(prev_election))
+      && !r.leadership_transfer && r.node_id != _voted_for) {
         vlog(
           _ctxlog.trace,
           "Already heard from the leader, not granting vote to node {}",
@@ -1507,6 +1528,8 @@ consensus::do_append_entries(append_entries_request&& r) {
         reply.result = append_entries_reply::status::failure;
         return ss::make_ready_future<append_entries_reply>(std::move(reply));
     }
+    // only an idle heartbeat keeps the group quiescent, see below
+    _quiescent_since = std::nullopt;
     /**
      * When the current leader is alive, whenever a follower receives heartbeat,
      * it updates its target priority to the initial value
@@ -1594,9 +1617,18 @@ consensus::do_append_entries(append_entries_request&& r) {
           lstats.dirty_offset, r.meta.last_visible_index);
         // on the follower leader control visibility of entries in the log
         maybe_update_last_visible_index(last_visible);
+        // same condition the leader checks in update_follower_quiescence
+        const bool quiescent = r.meta.commit_index == r.meta.prev_log_index
+                               && reply.last_dirty_log_index
+                                    == r.meta.prev_log_index
+                               && reply.last_flushed_log_index
+                                    == r.meta.prev_log_index;
         return maybe_update_follower_commit_idx(
                  model::offset(r.meta.commit_index))
-          .then([reply = std::move(reply)]() mutable {
+          .then([this, quiescent, reply = std::move(reply)]() mutable {
+              if (quiescent) {
+                  _quiescent_since = clock_type::now();
+              }
               reply.result = append_entries_reply::status::success;
               return ss::make_ready_future<append_entries_reply>(
                 std::move(reply));
@@ -1701,10 +1733,10 @@ consensus::do_append_entries(append_entries_request&& r) {
       });
 }
 
-ss::future<install_snapshot_reply>
-consensus::install_snapshot(install_snapshot_request&& r) {
-    return _op_lock.with([this, r = std::move(r)]() mutable {
-        return do_install_snapshot(std::move(r));
+ss::future<install_snapshot_reply> consensus::install_snapshot(
+  install_snapshot_request&& r, std::optional<uint32_t> chunk_crc) {
+    return _op_lock.with([this, r = std::move(r), chunk_crc]() mutable {
+        return do_install_snapshot(std::move(r), chunk_crc);
     });
 }
 
@@ -1791,12 +1823,12 @@ ss::future<> consensus::do_hydrate_snapshot(storage::snapshot_reader& reader) {
     });
 }
 
-ss::future<install_snapshot_reply>
-consensus::do_install_snapshot(install_snapshot_request&& r) {
+ss::future<install_snapshot_reply> consensus::do_install_snapshot(
+  install_snapshot_request&& r, std::optional<uint32_t> chunk_crc) {
     vlog(_ctxlog.trace, "Install snapshot request: {}", r);
 
     install_snapshot_reply reply{
-      .term = _term, .bytes_stored = r.chunk.size_bytes(), .success = false};
+      .term = _term, .bytes_stored = 0, .success = false};
     reply.target_node_id = r.node_id;
 
     if (unlikely(is_request_target_node_invalid("install_snapshot", r))) {
@@ -1817,7 +1849,40 @@ consensus::do_install_snapshot(install_snapshot_request&& r) {
         _term = r.term;
         _voted_for = {};
         do_step_down();
-        return do_install_snapshot(std::move(r));
+        return do_install_snapshot(std::move(r), chunk_crc);
+    }
+
+    // bytes of the snapshot being transferred that were already written, the
+    // leader resumes from there when the chunk is rejected
+    const bool same_snapshot = _snapshot_writer
+                               && r.last_included_index
+                                    == _received_snapshot_index
+                               && r.term == _received_snapshot_term;
+    const uint64_t bytes_stored = same_snapshot ? _received_snapshot_bytes
+                                                : 0;
+    if (chunk_crc) {
+        crc::crc32c crc;
+        crc_extend_iobuf(crc, r.chunk);
+        if (crc.value() != *chunk_crc) {
+            vlog(
+              _ctxlog.warn,
+              "Snapshot chunk at offset {} does not match its checksum",
+              r.file_offset);
+            reply.bytes_stored = bytes_stored;
+            return ss::make_ready_future<install_snapshot_reply>(reply);
+        }
+    }
+    // a leader that starts the transfer of the same snapshot over, e.g. after
+    // a reconnect, resumes from the received bytes instead of discarding them
+    if (r.file_offset != bytes_stored) {
+        vlog(
+          _ctxlog.debug,
+          "Snapshot chunk at offset {} does not continue the received {} "
+          "bytes",
+          r.file_offset,
+          bytes_stored);
+        reply.bytes_stored = bytes_stored;
+        return ss::make_ready_future<install_snapshot_reply>(reply);
     }
 
     auto f = ss::now();
@@ -1825,32 +1890,41 @@ consensus::do_install_snapshot(install_snapshot_request&& r) {
     if (r.file_offset == 0) {
         // discard old chunks, previous snaphost wasn't finished
         if (_snapshot_writer) {
-            f = _snapshot_writer->close().then(
-              [this] { return _snapshot_mgr.remove_partial_snapshots(); });
+            f = _snapshot_writer->close().then([this] {
+                _snapshot_writer.reset();
+                return _snapshot_mgr.remove_partial_snapshots();
+            });
         }
-        f = f.then([this] {
+        f = f.then([this, idx = r.last_included_index, term = r.term] {
             return _snapshot_mgr.start_snapshot().then(
-              [this](storage::snapshot_writer w) {
+              [this, idx, term](storage::snapshot_writer w) {
                   _snapshot_writer.emplace(std::move(w));
+                  _received_snapshot_index = idx;
+                  _received_snapshot_term = term;
+                  _received_snapshot_bytes = 0;
               });
         });
     }
 
     // Write data into snapshot file at given offset (§7.3)
     f = f.then([this, chunk = std::move(r.chunk)]() mutable {
+        auto size = chunk.size_bytes();
         return write_iobuf_to_output_stream(
-          std::move(chunk), _snapshot_writer->output());
+                 std::move(chunk), _snapshot_writer->output())
+          .then([this, size] { _received_snapshot_bytes += size; });
     });
 
     // Reply and wait for more data chunks if done is false (§7.4)
     if (!is_done) {
-        return f.then([reply]() mutable {
+        return f.then([this, reply]() mutable {
+            reply.bytes_stored = _received_snapshot_bytes;
             reply.success = true;
             return reply;
         });
     }
     // Last chunk, finish storing snapshot
     return f.then([this, r = std::move(r), reply]() mutable {
+        reply.bytes_stored = _received_snapshot_bytes;
         return finish_snapshot(std::move(r), reply);
     });
 }
@@ -2068,7 +2142,8 @@ append_entries_reply consensus::make_append_entries_reply(
 ss::future<> consensus::flush_log() {
     _probe.log_flushed();
     auto flushed_up_to = _log.offsets().dirty_offset;
-    return _log.flush().then([this, flushed_up_to] {
+    auto f = _group_commit ? _group_commit->get().flush(_log) : _log.flush();
+    return f.then([this, flushed_up_to] {
         auto lstats = _log.offsets();
         /**
          * log flush may be interleaved with trucation, hence we need to check
@@ -2955,6 +3030,70 @@ void consensus::update_heartbeat_status(vnode id, bool success) {
     }
 }
 
+bool consensus::is_follower_quiescent(vnode id) const {
+    if (!is_leader()) {
+        return false;
+    }
+    auto it = _fstats.find(id);
+    if (it == _fstats.end() || !it->second.quiescent_offset) {
+        return false;
+    }
+    const auto& f = it->second;
+    const auto dirty_offset = _log.offsets().dirty_offset;
+    const auto refresh_after
+      = config::shard_local_cfg().raft_quiescent_group_lease_ms() / 2;
+    return f.quiescent_term == _term && *f.quiescent_offset == dirty_offset
+           && _commit_index == dirty_offset && !f.is_recovering
+           && f.quiescent_since + refresh_after > clock_type::now();
+}
+
+void consensus::update_follower_quiescence(
+  vnode id, const protocol_metadata& sent, const append_entries_reply& reply) {
+    auto it = _fstats.find(id);
+    if (it == _fstats.end()) {
+        return;
+    }
+    auto& f = it->second;
+    if (
+      reply.result == append_entries_reply::status::success
+      && sent.term == _term && sent.commit_index == sent.prev_log_index
+      && reply.last_dirty_log_index == sent.prev_log_index
+      && reply.last_flushed_log_index == sent.prev_log_index) {
+        f.quiescent_offset = sent.prev_log_index;
+        f.quiescent_term = sent.term;
+        f.quiescent_since = clock_type::now();
+    } else {
+        f.quiescent_offset = std::nullopt;
+    }
+}
+
+void consensus::reset_follower_quiescence(vnode id) {
+    if (auto it = _fstats.find(id); it != _fstats.end()) {
+        it->second.quiescent_offset = std::nullopt;
+    }
+}
+
+void consensus::quiescent_follower_alive(vnode id) {
+    if (auto it = _fstats.find(id); it != _fstats.end()) {
+        it->second.heartbeats_failed = 0;
+        it->second.last_received_append_entries_reply_timestamp
+          = clock_type::now();
+    }
+}
+
+bool consensus::quiescent_leader_alive(clock_type::time_point since) const {
+    if (!_quiescent_since || !_leader_id) {
+        return false;
+    }
+    const auto lease
+      = config::shard_local_cfg().raft_quiescent_group_lease_ms();
+    if (*_quiescent_since + lease < clock_type::now()) {
+        return false;
+    }
+    return local_node_liveness().last_seen(_leader_id->id(), *_quiescent_since)
+           > since;
+}
+
 bool consensus::should_reconnect_follower(vnode id) {
     if (_heartbeat_disconnect_failures == 0) {
         // Force disconnection is disabled
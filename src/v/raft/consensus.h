@@ -20,6 +20,7 @@
 #include "raft/consensus_utils.h"
 #include "raft/event_manager.h"
 #include "raft/follower_stats.h"
+#include "raft/group_commit.h"
 #include "raft/group_configuration.h"
 #include "raft/logger.h"
 #include "raft/mutex_buffer.h"
@@ -94,7 +95,8 @@ public:
       leader_cb_t,
       storage::api&,
       std::optional<std::reference_wrapper<recovery_throttle>>,
-      recovery_memory_quota&);
+      recovery_memory_quota&,
+      std::optional<std::reference_wrapper<group_commit>>);
 
     /// Initial call. Allow for internal state recovery
     ss::future<> start();
@@ -107,8 +109,10 @@ public:
 
     ss::future<vote_reply> vote(vote_request&& r);
     ss::future<append_entries_reply> append_entries(append_entries_request&& r);
-    ss::future<install_snapshot_reply>
-    install_snapshot(install_snapshot_request&& r);
+    /// `chunk_crc` is the crc32c of the chunk, if the leader sent one
+    ss::future<install_snapshot_reply> install_snapshot(
+      install_snapshot_request&& r,
+      std::optional<uint32_t> chunk_crc = std::nullopt);
 
     ss::future<timeout_now_reply> timeout_now(timeout_now_request&& r);
 
@@ -322,9 +326,28 @@ public:
 
     bool should_reconnect_follower(vnode);
 
+    /**
+     * Quiescent groups, see node_liveness. A follower is quiescent once it
+     * acknowledged a heartbeat saying that the whole log of the leader is
+     * committed, and stays so until anything is appended. Its heartbeats are
+     * skipped in favour of node heartbeats, except for a refresh every half
+     * of `raft_quiescent_group_lease_ms`.
+     */
+    bool is_follower_quiescent(vnode) const;
+    /// updates the quiescence of a follower from the reply to a heartbeat
+    void update_follower_quiescence(
+      vnode, const protocol_metadata&, const append_entries_reply&);
+    void reset_follower_quiescence(vnode);
+    /// a node heartbeat from the node of a quiescent follower succeeded
+    void quiescent_follower_alive(vnode);
+
     std::vector<follower_metrics> get_follower_metrics() const;
     result<follower_metrics> get_follower_metrics(model::node_id) const;
     bool has_followers() const { return _fstats.size() > 0; }
+    /// append entries requests, replicate and recovery, waiting for a reply
+    size_t append_entries_in_flight() const {
+        return _fstats.append_entries_in_flight();
+    }
 
     offset_monitor& visible_offset_monitor() {
         return _consumable_offset_monitor;
@@ -364,7 +387,7 @@ private:
     ss::future<append_entries_reply>
     do_append_entries(append_entries_request&&);
     ss::future<install_snapshot_reply>
-    do_install_snapshot(install_snapshot_request&& r);
+    do_install_snapshot(install_snapshot_request&&, std::optional<uint32_t>);
     ss::future<> do_start();
 
     ss::future<result<replicate_result>> dispatch_replicate(
@@ -421,6 +444,9 @@ private:
     void dispatch_vote(bool leadership_transfer);
     ss::future<bool> dispatch_prevote(bool leadership_transfer);
     bool should_skip_vote(bool ignore_heartbeat);
+    /// true if this follower is quiescent and heard from the node of its
+    /// leader after `since`
+    bool quiescent_leader_alive(clock_type::time_point since) const;
 
     /// Replicates configuration to other nodes,
     //  caller have to pass in _op_sem semaphore units
@@ -559,6 +585,9 @@ private:
 
     /// useful for when we are not the leader
     clock_type::time_point _hbeat = clock_type::now();
+    /// follower of a quiescent group: time of the last heartbeat saying that
+    /// the whole log of the leader is committed
+    std::optional<clock_type::time_point> _quiescent_since;
     clock_type::time_point _became_leader_at = clock_type::now();
     /// used to keep track if we are a leader, or transitioning
     vote_state _vstate = vote_state::follower;
@@ -591,8 +620,14 @@ private:
     storage::api& _storage;
     std::optional<std::reference_wrapper<recovery_throttle>> _recovery_throttle;
     recovery_memory_quota& _recovery_mem_quota;
+    std::optional<std::reference_wrapper<group_commit>> _group_commit;
     storage::simple_snapshot_manager _snapshot_mgr;
     std::optional<storage::snapshot_writer> _snapshot_writer;
+    // snapshot being received, the leader resumes an interrupted transfer
+    // from the bytes already written
+    model::offset _received_snapshot_index;
+    model::term_id _received_snapshot_term;
+    uint64_t _received_snapshot_bytes = 0;
     model::offset _last_snapshot_index;
     model::term_id _last_snapshot_term;
     configuration_manager _configuration_manager;
@@ -37,6 +37,10 @@ public:
         virtual ss::future<result<heartbeat_reply>>
         heartbeat(model::node_id, heartbeat_request&&, rpc::client_opts) = 0;
 
+        virtual ss::future<result<node_heartbeat_reply>> node_heartbeat(
+          model::node_id, node_heartbeat_request&&, rpc::client_opts)
+          = 0;
+
         virtual ss::future<result<install_snapshot_reply>> install_snapshot(
           model::node_id, install_snapshot_request&&, rpc::client_opts)
           = 0;
@@ -80,6 +84,14 @@ public:
         return _impl->heartbeat(target_node, std::move(r), std::move(opts));
     }
 
+    ss::future<result<node_heartbeat_reply>> node_heartbeat(
+      model::node_id target_node,
+      node_heartbeat_request&& r,
+      rpc::client_opts opts) {
+        return _impl->node_heartbeat(
+          target_node, std::move(r), std::move(opts));
+    }
+
     ss::future<result<install_snapshot_reply>> install_snapshot(
       model::node_id target_node,
       install_snapshot_request&& r,
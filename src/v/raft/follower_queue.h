@@ -31,6 +31,15 @@ public:
 
     ss::future<> stop();
 
+    /// number of append entries requests holding a unit
+    size_t in_flight() const {
+        return _max_concurrent_append_entries - _sem->available_units();
+    }
+
+    /// true if the next request has to wait for one of the in flight
+    /// requests to finish
+    bool is_full() const { return _sem->available_units() <= 0; }
+
     bool is_idle() const {
         return _sem->waiters() == 0
                && _sem->available_units() == _max_concurrent_append_entries;
@@ -50,6 +50,9 @@ void follower_stats::update_with_configuration(const group_configuration& cfg) {
 ss::future<ss::semaphore_units<>>
 follower_stats::get_append_entries_unit(vnode id) {
     if (auto it = _queues.find(id); it != _queues.end()) {
+        if (it->second.is_full()) {
+            ++_pipeline_stalls;
+        }
         return it->second.get_append_entries_unit();
     }
     auto [it, _] = _queues.emplace(id, _max_concurrent_append_entries);
@@ -64,6 +67,14 @@ void follower_stats::return_append_entries_units(vnode id) {
     }
 }
 
+size_t follower_stats::append_entries_in_flight() const {
+    size_t ret = 0;
+    for (const auto& [_, q] : _queues) {
+        ret += q.in_flight();
+    }
+    return ret;
+}
+
 std::ostream& operator<<(std::ostream& o, const follower_stats& s) {
     o << "{followers:" << s._followers.size() << ", [";
     for (auto& f : s) {
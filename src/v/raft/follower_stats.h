@@ -73,6 +73,13 @@ public:
 
     void return_append_entries_units(vnode);
 
+    /// append entries requests, replicate and recovery, currently in flight to
+    /// all the followers
+    size_t append_entries_in_flight() const;
+
+    /// number of requests that had to wait as the follower pipeline was full
+    uint64_t append_entries_pipeline_stalls() const { return _pipeline_stalls; }
+
     void update_with_configuration(const group_configuration&);
 
 private:
@@ -81,6 +88,7 @@ private:
     uint32_t _max_concurrent_append_entries;
     container_t _followers;
     absl::node_hash_map<vnode, follower_queue> _queues;
+    uint64_t _pipeline_stalls{0};
 };
 
 } // namespace raft
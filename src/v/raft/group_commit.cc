@@ -0,0 +1,164 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/group_commit.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "raft/logger.h"
+#include "ssx/future-util.h"
+#include "vlog.h"
+
+#include <seastar/core/metrics.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace raft {
+
+group_commit::group_commit(config::binding<uint32_t> window_us)
+  : _window_us(std::move(window_us))
+  , _window_timer([this] { dispatch(); }) {}
+
+ss::future<> group_commit::flush(storage::log log) {
+    if (!enabled() || _gate.is_closed()) {
+        return log.flush();
+    }
+    ++_requests;
+    if (_pending.empty()) {
+        _round_open_seq = _next_append_seq;
+    }
+    auto& r = _pending.emplace_back(request{
+      .log = std::move(log),
+      .requested = std::chrono::steady_clock::now()});
+    auto f = r.done.get_future();
+    if (!_window_timer.armed()) {
+        _window_timer.arm(std::chrono::microseconds(_window_us()));
+    }
+    return f;
+}
+
+group_commit::append_guard group_commit::start_append() {
+    auto seq = _next_append_seq++;
+    _appends.insert(seq);
+    return append_guard(this, seq);
+}
+
+bool group_commit::waits_for_appends() const {
+    return !_appends.empty() && *_appends.begin() < _round_open_seq;
+}
+
+void group_commit::end_append(uint64_t seq) {
+    _appends.erase(seq);
+    if (_pending.empty() || waits_for_appends() || _gate.is_closed()) {
+        return;
+    }
+    // all the appends the round waited for are done, no need to wait for the
+    // window to close
+    _window_timer.cancel();
+    ++_append_rounds;
+    dispatch();
+}
+
+void group_commit::dispatch() {
+    if (_pending.empty()) {
+        return;
+    }
+    ssx::spawn_with_gate(
+      _gate, [this] { return flush_round(std::exchange(_pending, {})); });
+}
+
+ss::future<> group_commit::flush_round(std::vector<request> round) {
+    ++_rounds;
+    _last_round_size = round.size();
+    const auto now = std::chrono::steady_clock::now();
+    // one flush per log, shared by all of its waiters
+    absl::flat_hash_map<model::ntp, std::vector<size_t>> by_log;
+    for (size_t i = 0; i < round.size(); ++i) {
+        _wait_time_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                           now - round[i].requested)
+                           .count();
+        by_log[round[i].log.config().ntp()].push_back(i);
+    }
+    _log_flushes += by_log.size();
+    vlog(
+      raftlog.trace,
+      "group commit of {} flush requests over {} logs",
+      round.size(),
+      by_log.size());
+
+    return ss::do_with(
+      std::move(round),
+      std::move(by_log),
+      [](std::vector<request>& round, auto& by_log) {
+          return ss::parallel_for_each(by_log, [&round](auto& entry) {
+              auto& waiters = entry.second;
+              return round[waiters.front()].log.flush().then_wrapped(
+                [&round, &waiters](ss::future<> f) {
+                    if (f.failed()) {
+                        auto e = f.get_exception();
+                        for (auto i : waiters) {
+                            round[i].done.set_exception(e);
+                        }
+                        return;
+                    }
+                    for (auto i : waiters) {
+                        round[i].done.set_value();
+                    }
+                });
+          });
+      });
+}
+
+ss::future<> group_commit::stop() {
+    _window_timer.cancel();
+    // serve whatever is pending rather than failing it
+    auto round = std::exchange(_pending, {});
+    auto f = round.empty() ? ss::now() : flush_round(std::move(round));
+    return f.then([this] { return _gate.close(); });
+}
+
+void group_commit::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("raft:group_commit"),
+      {
+        sm::make_derive(
+          "requests",
+          [this] { return _requests; },
+          sm::description("Log flushes requested by raft groups")),
+        sm::make_derive(
+          "rounds",
+          [this] { return _rounds; },
+          sm::description("Group commit rounds, requests / rounds is the "
+                          "average batch size")),
+        sm::make_derive(
+          "append_rounds",
+          [this] { return _append_rounds; },
+          sm::description("Group commit rounds started when the appends of "
+                          "followers they waited for completed")),
+        sm::make_gauge(
+          "last_round_size",
+          [this] { return _last_round_size; },
+          sm::description("Number of requests served by the last round")),
+        sm::make_derive(
+          "log_flushes",
+          [this] { return _log_flushes; },
+          sm::description("Distinct logs flushed by group commit rounds")),
+        sm::make_derive(
+          "wait_time_us",
+          [this] { return _wait_time_us; },
+          sm::description("Total time requests waited for their round to "
+                          "start, in microseconds")),
+      });
+}
+
+} // namespace raft
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+#include "config/property.h"
+#include "seastarx.h"
+#include "storage/log.h"
+
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
+
+#include <absl/container/btree_set.h>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace raft {
+
+/**
+ * Shard wide group commit of raft log flushes.
+ *
+ * Every raft group flushes its own log when an acks=all replication or an
+ * append_entries request with the flush flag completes, so the number of
+ * flushes grows with the number of partitions on a shard. Instead, groups
+ * hand their flushes to this service. The first request opens a window of
+ * `window_us` microseconds; all requests made until it closes are served by
+ * one round that flushes every distinct log once, concurrently, and then
+ * resolves all waiters. Requests made while a round is running open the next
+ * window.
+ *
+ * Followers append the buffered append_entries requests of a group and flush
+ * its log afterwards (see append_entries_buffer). Many groups do that at the
+ * same time on a follower with heavy fan-in, so a round does not start while
+ * appends that began before it was opened are still running, they mark
+ * themselves with an `append_guard`. A round is then dispatched as soon as
+ * the last of those appends completes, before the window closes, and the
+ * replies of all the groups are released together.
+ *
+ * With a zero window logs are flushed directly, a flush never waits for the
+ * appends of other groups.
+ */
+class group_commit {
+public:
+    class append_guard {
+    public:
+        append_guard(append_guard&& o) noexcept
+          : _gc(std::exchange(o._gc, nullptr))
+          , _seq(o._seq) {}
+        append_guard& operator=(append_guard&&) = delete;
+        append_guard(const append_guard&) = delete;
+        append_guard& operator=(const append_guard&) = delete;
+        ~append_guard() noexcept {
+            if (_gc) {
+                _gc->end_append(_seq);
+            }
+        }
+
+    private:
+        friend group_commit;
+        append_guard(group_commit* gc, uint64_t seq)
+          : _gc(gc)
+          , _seq(seq) {}
+
+        group_commit* _gc;
+        uint64_t _seq;
+    };
+
+    explicit group_commit(config::binding<uint32_t> window_us);
+
+    ss::future<> flush(storage::log);
+
+    /// flushes are grouped only with a window
+    bool enabled() const { return _window_us() > 0; }
+
+    /// marks appends that are followed by a flush of the log. The guard must
+    /// be released after that flush was requested.
+    append_guard start_append();
+
+    ss::future<> stop();
+
+    void setup_metrics();
+
+private:
+    struct request {
+        storage::log log;
+        ss::promise<> done;
+        std::chrono::steady_clock::time_point requested;
+    };
+
+    void dispatch();
+    ss::future<> flush_round(std::vector<request>);
+    void end_append(uint64_t seq);
+    bool waits_for_appends() const;
+
+    config::binding<uint32_t> _window_us;
+    std::vector<request> _pending;
+    ss::timer<> _window_timer;
+    ss::gate _gate;
+    // sequence numbers of the running appends
+    absl::btree_set<uint64_t> _appends;
+    uint64_t _next_append_seq{0};
+    // appends started before the pending round was opened
+    uint64_t _round_open_seq{0};
+
+    uint64_t _requests{0};
+    uint64_t _rounds{0};
+    uint64_t _append_rounds{0};
+    uint64_t _log_flushes{0};
+    uint64_t _wait_time_us{0};
+    size_t _last_round_size{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace raft
@@ -37,7 +37,9 @@ group_manager::group_manager(
   , _heartbeats(heartbeat_interval, _client, _self, heartbeat_timeout)
   , _storage(storage.local())
   , _recovery_throttle(recovery_throttle.local())
-  , _recovery_mem_quota(std::move(recovery_mem_cfg)) {
+  , _recovery_mem_quota(std::move(recovery_mem_cfg))
+  , _group_commit(
+      config::shard_local_cfg().raft_group_commit_window_us.bind()) {
     setup_metrics();
 }
 
@@ -52,11 +54,13 @@ ss::future<> group_manager::stop() {
         f = f.then([this] { return _heartbeats.stop(); });
     }
 
-    return f.then([this] {
-        return ss::parallel_for_each(
-          _groups,
-          [](ss::lw_shared_ptr<consensus> raft) { return raft->stop(); });
-    });
+    return f
+      .then([this] {
+          return ss::parallel_for_each(
+            _groups,
+            [](ss::lw_shared_ptr<consensus> raft) { return raft->stop(); });
+      })
+      .then([this] { return _group_commit.stop(); });
 }
 
 ss::future<> group_manager::stop_heartbeats() { return _heartbeats.stop(); }
@@ -79,7 +83,8 @@ ss::future<ss::lw_shared_ptr<raft::consensus>> group_manager::create_group(
       },
       _storage,
       _recovery_throttle,
-      _recovery_mem_quota);
+      _recovery_mem_quota,
+      _group_commit);
 
     return ss::with_gate(_gate, [this, raft] {
         return _heartbeats.register_group(raft).then([this, raft] {
@@ -135,6 +140,8 @@ void group_manager::setup_metrics() {
         "group_count",
         [this] { return _groups.size(); },
         sm::description("Number of raft groups"))});
+    _group_commit.setup_metrics();
+    _recovery_mem_quota.read_cache().setup_metrics();
 }
 
 } // namespace raft
@@ -13,6 +13,7 @@
 #include "cluster/types.h"
 #include "model/metadata.h"
 #include "raft/consensus_client_protocol.h"
+#include "raft/group_commit.h"
 #include "raft/heartbeat_manager.h"
 #include "raft/recovery_memory_quota.h"
 #include "raft/rpc_client_protocol.h"
@@ -101,6 +102,7 @@ private:
     storage::api& _storage;
     recovery_throttle& _recovery_throttle;
     recovery_memory_quota _recovery_mem_quota;
+    group_commit _group_commit;
 };
 
 } // namespace raft
@@ -16,6 +16,7 @@
 #include "raft/consensus_client_protocol.h"
 #include "raft/errc.h"
 #include "raft/group_configuration.h"
+#include "raft/node_liveness.h"
 #include "raft/raftgen_service.h"
 #include "raft/types.h"
 #include "rpc/reconnect_transport.h"
@@ -43,16 +44,17 @@ struct heartbeat_requests {
     /// These nodes' heartbeat status indicates they need
     /// a transport reconnection before sending next heartbeat
     absl::flat_hash_set<model::node_id> reconnect_nodes;
+
+    /// Followers left out of the requests, per node
+    heartbeat_manager::quiescent_followers quiescent;
 };
 
 heartbeat_manager::follower_request_meta::follower_request_meta(
-  consensus_ptr ptr,
-  follower_req_seq seq,
-  model::offset dirty_offset,
-  vnode target)
+  consensus_ptr ptr, follower_req_seq seq, protocol_metadata meta, vnode target)
   : c(std::move(ptr))
   , seq(seq)
-  , dirty_offset(dirty_offset)
+  , dirty_offset(meta.prev_log_index)
+  , meta(meta)
   , follower_vnode(target) {
     if (c->self() != follower_vnode) {
         c->update_suppress_heartbeats(
@@ -70,7 +72,11 @@ heartbeat_manager::follower_request_meta::~follower_request_meta() noexcept {
 }
 
 static heartbeat_requests requests_for_range(
-  const consensus_set& c, clock_type::duration heartbeat_interval) {
+  const consensus_set& c,
+  clock_type::duration heartbeat_interval,
+  bool quiescent_heartbeats,
+  const absl::flat_hash_map<model::node_id, clock_type::time_point>&
+    no_node_heartbeats) {
     absl::btree_map<
       model::node_id,
       std::vector<std::pair<
@@ -84,6 +90,7 @@ static heartbeat_requests requests_for_range(
     // Set of follower nodes whose heartbeat_failed status indicates
     // that we should tear down their TCP connection before next heartbeat
     absl::flat_hash_set<model::node_id> reconnect_nodes;
+    heartbeat_manager::quiescent_followers quiescent;
 
     auto last_heartbeat = clock_type::now() - heartbeat_interval;
     for (auto& ptr : c) {
@@ -93,8 +100,11 @@ static heartbeat_requests requests_for_range(
 
         auto maybe_create_follower_request = [ptr,
                                               last_heartbeat,
+                                              quiescent_heartbeats,
+                                              &no_node_heartbeats,
                                               &pending_beats,
-                                              &reconnect_nodes](
+                                              &reconnect_nodes,
+                                              &quiescent](
                                                const vnode& rni) mutable {
             // special case self beat
             // self beat is used to make sure that the protocol will make
@@ -104,7 +114,16 @@ static heartbeat_requests requests_for_range(
                 pending_beats[rni.id()].emplace_back(
                   heartbeat_metadata{hb_metadata, rni},
                   heartbeat_manager::follower_request_meta(
-                    ptr, follower_req_seq(0), hb_metadata.prev_log_index, rni));
+                    ptr, follower_req_seq(0), hb_metadata, rni));
+                return;
+            }
+
+            if (
+              quiescent_heartbeats && !no_node_heartbeats.contains(rni.id())
+              && ptr->is_follower_quiescent(rni)) {
+                quiescent[rni.id()].push_back(
+                  heartbeat_manager::quiescent_follower{
+                    .c = ptr, .follower_vnode = rni});
                 return;
             }
 
@@ -136,7 +155,7 @@ static heartbeat_requests requests_for_range(
             pending_beats[rni.id()].emplace_back(
               heartbeat_metadata{hb_meta, ptr->self(), rni},
               heartbeat_manager::follower_request_meta(
-                ptr, seq_id, hb_meta.prev_log_index, rni));
+                ptr, seq_id, hb_meta, rni));
 
             if (ptr->should_reconnect_follower(rni)) {
                 reconnect_nodes.insert(rni.id());
@@ -165,7 +184,9 @@ static heartbeat_requests requests_for_range(
     }
 
     return heartbeat_requests{
-      .requests{std::move(reqs)}, .reconnect_nodes{reconnect_nodes}};
+      .requests{std::move(reqs)},
+      .reconnect_nodes{reconnect_nodes},
+      .quiescent{std::move(quiescent)}};
 }
 
 heartbeat_manager::heartbeat_manager(
@@ -176,7 +197,9 @@ heartbeat_manager::heartbeat_manager(
   : _heartbeat_interval(interval)
   , _heartbeat_timeout(heartbeat_timeout)
   , _client_protocol(std::move(proto))
-  , _self(self) {
+  , _self(self)
+  , _quiescent_heartbeats(
+      config::shard_local_cfg().raft_quiescent_heartbeats.bind()) {
     _heartbeat_timer.set_callback([this] { dispatch_heartbeats(); });
 }
 
@@ -200,16 +223,29 @@ heartbeat_manager::send_heartbeats(std::vector<node_heartbeat> reqs) {
 }
 
 ss::future<> heartbeat_manager::do_dispatch_heartbeats() {
-    auto reqs = requests_for_range(_consensus_groups, _heartbeat_interval);
+    absl::erase_if(
+      _no_node_heartbeats, [now = clock_type::now()](const auto& e) {
+          return e.second <= now;
+      });
+    auto reqs = requests_for_range(
+      _consensus_groups,
+      _heartbeat_interval,
+      _quiescent_heartbeats(),
+      _no_node_heartbeats);
 
     for (const auto& node_id : reqs.reconnect_nodes) {
         if (co_await _client_protocol.ensure_disconnect(node_id)) {
             vlog(
               hbeatlog.info, "Closed unresponsive connection to {}", node_id);
+            // the node may come back with a version that knows node
+            // heartbeats
+            _no_node_heartbeats.erase(node_id);
         };
     }
 
-    co_await send_heartbeats(std::move(reqs.requests));
+    co_await ss::when_all_succeed(
+      send_heartbeats(std::move(reqs.requests)),
+      send_node_heartbeats(std::move(reqs.quiescent)));
 }
 
 ss::future<> heartbeat_manager::do_self_heartbeat(node_heartbeat&& r) {
@@ -286,6 +322,7 @@ void heartbeat_manager::process_reply(
             }
 
             (*it)->update_heartbeat_status(req_meta.follower_vnode, false);
+            (*it)->reset_follower_quiescence(req_meta.follower_vnode);
 
             // propagate error
             (*it)->process_append_entries_reply(
@@ -309,6 +346,7 @@ void heartbeat_manager::process_reply(
         vlog(hbeatlog.trace, "Heartbeat reply from node: {} - {}", n, m);
         auto meta = std::move(groups.find(m.group)->second);
         (*it)->update_heartbeat_status(meta.follower_vnode, true);
+        (*it)->update_follower_quiescence(meta.follower_vnode, meta.meta, m);
 
         (*it)->process_append_entries_reply(
           n,
@@ -318,6 +356,92 @@ void heartbeat_manager::process_reply(
     }
 }
 
+ss::future<>
+heartbeat_manager::send_node_heartbeats(quiescent_followers followers) {
+    std::vector<ss::future<>> futures;
+    futures.reserve(followers.size());
+    for (auto& [node, node_followers] : followers) {
+        futures.push_back(do_node_heartbeat(node, std::move(node_followers)));
+    }
+    return ss::when_all_succeed(futures.begin(), futures.end());
+}
+
+ss::future<> heartbeat_manager::do_node_heartbeat(
+  model::node_id target, std::vector<quiescent_follower> followers) {
+    auto gate = _bghbeats.hold();
+    vlog(
+      hbeatlog.trace,
+      "Dispatching node heartbeat for {} quiescent groups to node: {}",
+      followers.size(),
+      target);
+
+    auto f = _client_protocol
+               .node_heartbeat(
+                 target,
+                 node_heartbeat_request{
+                   .node_id = _self,
+                   .target_node_id = target,
+                   .incarnation = node_incarnation()},
+                 rpc::client_opts(clock_type::now() + _heartbeat_timeout))
+               .then([this,
+                      target,
+                      followers = std::move(followers),
+                      gate = std::move(gate)](
+                       result<node_heartbeat_reply> ret) mutable {
+                   process_node_reply(
+                     target, std::move(followers), std::move(ret));
+               });
+    return ss::with_timeout(next_heartbeat_timeout(), std::move(f))
+      .handle_exception_type([target](const ss::timed_out_error&) {
+          vlog(hbeatlog.trace, "Node heartbeat timeout, node: {}", target);
+      })
+      .handle_exception_type([](const ss::gate_closed_exception&) {})
+      .handle_exception([target](const std::exception_ptr& e) {
+          vlog(
+            hbeatlog.trace, "Node heartbeat exception, node: {} - {}", target, e);
+      });
+}
+
+void heartbeat_manager::process_node_reply(
+  model::node_id n,
+  std::vector<quiescent_follower> followers,
+  result<node_heartbeat_reply> r) {
+    // the followers go back to regular heartbeats unless the node is alive
+    // and still the process they became quiescent with
+    bool alive = r.has_value();
+    if (!r) {
+        vlog(
+          hbeatlog.debug,
+          "Received error when sending node heartbeat to node {} - {}",
+          n,
+          r.error().message());
+        if (r.error() == rpc::errc::method_not_found) {
+            vlog(
+              hbeatlog.info,
+              "Node {} does not support node heartbeats, groups it follows "
+              "will not be quiescent",
+              n);
+            _no_node_heartbeats.insert_or_assign(
+              n, clock_type::now() + no_node_heartbeats_retry);
+        }
+    } else {
+        auto [it, inserted] = _node_incarnations.try_emplace(
+          n, r.value().incarnation);
+        if (inserted || it->second != r.value().incarnation) {
+            it->second = r.value().incarnation;
+            alive = false;
+        }
+    }
+
+    for (auto& f : followers) {
+        if (alive) {
+            f.c->quiescent_follower_alive(f.follower_vnode);
+        } else {
+            f.c->reset_follower_quiescence(f.follower_vnode);
+        }
+    }
+}
+
 void heartbeat_manager::dispatch_heartbeats() {
     ssx::background = ssx::spawn_with_gate_then(_bghbeats, [this] {
                           return _lock.with([this] {
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "config/property.h"
 #include "model/metadata.h"
 #include "outcome.h"
 #include "raft/consensus.h"
@@ -25,6 +26,8 @@
 #include <seastar/util/log.hh>
 
 #include <absl/container/btree_map.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 #include <boost/container/flat_set.hpp>
 
 namespace raft::details {
@@ -82,6 +85,13 @@ extern ss::logger hbeatlog;
  *
  *    heartbeat({L0, L1}) -> {F0, F1}(node-b)
  *    heartbeat({L0, L1}) -> {F0, F1}(node-c)
+ *
+ * With `raft_quiescent_heartbeats` groups whose followers are up to date and
+ * that had nothing appended are left out of the batches (see
+ * consensus::is_follower_quiescent). Instead a single node_heartbeat is sent
+ * to every node that follows such groups; its followers rely on it to know
+ * that the node of their leader is alive, and its replies keep the leader
+ * from stepping down.
  */
 class heartbeat_manager {
 public:
@@ -91,7 +101,7 @@ public:
 
     struct follower_request_meta {
         follower_request_meta(
-          consensus_ptr, follower_req_seq, model::offset, vnode);
+          consensus_ptr, follower_req_seq, protocol_metadata, vnode);
         ~follower_request_meta() noexcept;
 
         follower_request_meta(const follower_request_meta&) = delete;
@@ -103,8 +113,16 @@ public:
         consensus_ptr c;
         follower_req_seq seq;
         model::offset dirty_offset;
+        protocol_metadata meta;
+        vnode follower_vnode;
+    };
+    // Follower of a group that is left out of the heartbeats
+    struct quiescent_follower {
+        consensus_ptr c;
         vnode follower_vnode;
     };
+    using quiescent_followers
+      = absl::btree_map<model::node_id, std::vector<quiescent_follower>>;
     // Heartbeats from all groups for single node
     struct node_heartbeat {
         node_heartbeat(
@@ -137,6 +155,11 @@ public:
     bool is_stopped() const { return _bghbeats.is_closed(); }
 
 private:
+    /// \brief how long nodes that rejected node heartbeats get regular
+    /// heartbeats for all their groups before node heartbeats are tried again
+    static constexpr duration_type no_node_heartbeats_retry
+      = std::chrono::minutes(5);
+
     void dispatch_heartbeats();
 
     clock_type::time_point next_heartbeat_timeout();
@@ -151,6 +174,15 @@ private:
     /// \brief handle heartbeat at local node
     ss::future<> do_self_heartbeat(node_heartbeat&&);
 
+    ss::future<> send_node_heartbeats(quiescent_followers);
+    /// \brief sends a node heartbeat on behalf of quiescent followers
+    ss::future<>
+      do_node_heartbeat(model::node_id, std::vector<quiescent_follower>);
+    void process_node_reply(
+      model::node_id,
+      std::vector<quiescent_follower>,
+      result<node_heartbeat_reply>);
+
     /// \brief notifies the consensus groups about append_entries log offsets
     /// \param n the physical node that owns heart beats
     /// \param groups raft groups managed by \param n
@@ -174,5 +206,12 @@ private:
     consensus_set _consensus_groups;
     consensus_client_protocol _client_protocol;
     model::node_id _self;
+    config::binding<bool> _quiescent_heartbeats;
+    /// last incarnation seen in the node heartbeat replies of each node
+    absl::flat_hash_map<model::node_id, uint64_t> _node_incarnations;
+    /// nodes that did not know node heartbeats and when to try them again,
+    /// the node may have been upgraded in the meantime
+    absl::flat_hash_map<model::node_id, clock_type::time_point>
+      _no_node_heartbeats;
 };
 } // namespace raft
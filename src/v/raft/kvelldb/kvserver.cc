@@ -186,7 +186,8 @@ private:
           },
           _storage,
           std::nullopt,
-          _recovery_memory_quota);
+          _recovery_memory_quota,
+          std::nullopt);
         return _consensus->start().then(
           [this] { return _hbeats.register_group(_consensus); });
     }
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/metadata.h"
+#include "random/generators.h"
+#include "raft/types.h"
+
+#include <absl/container/flat_hash_map.h>
+
+#include <cstdint>
+
+namespace raft {
+
+/**
+ * Per-shard record of the node level heartbeats received from other nodes.
+ *
+ * With `raft_quiescent_heartbeats` a leader stops sending heartbeats for idle
+ * groups whose followers are up to date and instead sends a single
+ * node_heartbeat per node pair. A follower of such a group does not start an
+ * election as long as the node of its leader keeps beating.
+ *
+ * Every beat carries the incarnation of the sender, a random number drawn at
+ * startup. A follower only trusts beats of the incarnation its group became
+ * quiescent with: a restarted leader node does not lead anything anymore.
+ */
+class node_liveness {
+public:
+    void mark_alive(
+      model::node_id n,
+      uint64_t incarnation,
+      clock_type::time_point now = clock_type::now()) {
+        auto [it, inserted] = _nodes.try_emplace(
+          n, node_state{.incarnation = incarnation, .since = now});
+        if (!inserted && it->second.incarnation != incarnation) {
+            it->second = node_state{.incarnation = incarnation, .since = now};
+        }
+        it->second.last_seen = now;
+    }
+
+    /// last beat of `n` if its incarnation was already running at `since`,
+    /// otherwise time_point::min()
+    clock_type::time_point
+    last_seen(model::node_id n, clock_type::time_point since) const {
+        auto it = _nodes.find(n);
+        if (it == _nodes.end() || it->second.since > since) {
+            return clock_type::time_point::min();
+        }
+        return it->second.last_seen;
+    }
+
+    /// last beat of `n` of any incarnation
+    clock_type::time_point last_seen(model::node_id n) const {
+        auto it = _nodes.find(n);
+        return it == _nodes.end() ? clock_type::time_point::min()
+                                  : it->second.last_seen;
+    }
+
+private:
+    struct node_state {
+        uint64_t incarnation;
+        clock_type::time_point since;
+        clock_type::time_point last_seen = clock_type::time_point::min();
+    };
+
+    absl::flat_hash_map<model::node_id, node_state> _nodes;
+};
+
+inline node_liveness& local_node_liveness() {
+    static thread_local node_liveness l;
+    return l;
+}
+
+/// identifies this run of the process in node heartbeats
+inline uint64_t node_incarnation() {
+    static const uint64_t incarnation
+      = random_generators::get_int<uint64_t>();
+    return incarnation;
+}
+
+} // namespace raft
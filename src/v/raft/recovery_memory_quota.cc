@@ -23,14 +23,29 @@ recovery_memory_quota::recovery_memory_quota(
   : _cfg(config_provider())
   , _current_max_recovery_mem(
       _cfg.max_recovery_memory().value_or(memory_groups::recovery_max_memory()))
-  , _memory(_current_max_recovery_mem) {
+  , _memory(_current_max_recovery_mem)
+  , _read_cache(*this) {
     _cfg.max_recovery_memory.watch([this] { on_max_memory_changed(); });
 }
 
 ss::future<ss::semaphore_units<>> recovery_memory_quota::acquire_read_memory() {
-    return ss::get_units(
-      _memory,
-      std::min(_current_max_recovery_mem, _cfg.default_read_buffer_size()));
+    const auto size = std::min(
+      _current_max_recovery_mem, _cfg.default_read_buffer_size());
+    // reads take precedence over cached ranges
+    const auto available = _memory.available_units();
+    if (available < static_cast<ssize_t>(size)) {
+        _read_cache.reclaim(size - std::max<ssize_t>(available, 0));
+    }
+    return ss::get_units(_memory, size);
+}
+
+std::optional<ss::semaphore_units<>>
+recovery_memory_quota::try_acquire_cache_memory(size_t size) {
+    // do not let cache jump the queue of waiting reads
+    if (_memory.waiters() > 0) {
+        return std::nullopt;
+    }
+    return ss::try_get_units(_memory, size);
 }
 
 void recovery_memory_quota::on_max_memory_changed() {
@@ -46,6 +61,10 @@ void recovery_memory_quota::on_max_memory_changed() {
         _memory.signal(diff);
     }
     _current_max_recovery_mem = new_size;
+    if (const auto max_cached = _current_max_recovery_mem / 2;
+        _read_cache.cached_bytes() > max_cached) {
+        _read_cache.reclaim(_read_cache.cached_bytes() - max_cached);
+    }
 }
 
 } // namespace raft
@@ -10,6 +10,7 @@
  */
 #pragma once
 #include "config/property.h"
+#include "raft/recovery_read_cache.h"
 #include "seastarx.h"
 
 #include <seastar/core/semaphore.hh>
@@ -17,7 +18,8 @@
 
 namespace raft {
 /**
- * Thread local memory quota for raft recovery
+ * Thread local memory quota for raft recovery, shared by the reads and the
+ * recovery read cache
  */
 class recovery_memory_quota {
 public:
@@ -31,12 +33,20 @@ public:
 
     ss::future<ss::semaphore_units<>> acquire_read_memory();
 
+    /// memory for caching a range, never waits
+    std::optional<ss::semaphore_units<>> try_acquire_cache_memory(size_t);
+
+    size_t max_memory() const { return _current_max_recovery_mem; }
+
+    recovery_read_cache& read_cache() { return _read_cache; }
+
 private:
     void on_max_memory_changed();
 
     configuration _cfg;
     size_t _current_max_recovery_mem;
     ss::semaphore _memory;
+    recovery_read_cache _read_cache;
 };
 
 } // namespace raft
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#include "raft/recovery_read_cache.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "raft/recovery_memory_quota.h"
+#include "vassert.h"
+
+#include <seastar/core/metrics.hh>
+
+namespace raft {
+
+recovery_read_cache::recovery_read_cache(recovery_memory_quota& quota)
+  : _quota(quota) {}
+
+std::optional<ss::circular_buffer<model::record_batch>>
+recovery_read_cache::get(
+  group_id group, model::term_id term, model::offset start, size_t max_bytes) {
+    auto git = _groups.find(group);
+    if (git == _groups.end()) {
+        ++_misses;
+        return std::nullopt;
+    }
+    auto& ranges = git->second;
+    // range with the greatest base offset not greater than start
+    auto it = ranges.upper_bound(start);
+    if (it == ranges.begin()) {
+        ++_misses;
+        return std::nullopt;
+    }
+    --it;
+    if (it->second.term != term) {
+        invalidate(group);
+        ++_misses;
+        return std::nullopt;
+    }
+    if (it->second.last < start) {
+        ++_misses;
+        return std::nullopt;
+    }
+
+    auto& r = it->second;
+    ss::circular_buffer<model::record_batch> ret;
+    size_t bytes = 0;
+    for (auto& b : r.batches) {
+        if (b.last_offset() < start) {
+            continue;
+        }
+        if (!ret.empty() && bytes + b.size_bytes() > max_bytes) {
+            break;
+        }
+        bytes += b.size_bytes();
+        ret.push_back(b.share());
+    }
+    r._hook.unlink();
+    _lru.push_back(r);
+    ++_hits;
+    return ret;
+}
+
+void recovery_read_cache::put(
+  group_id group,
+  model::term_id term,
+  ss::circular_buffer<model::record_batch>& batches) {
+    if (batches.empty()) {
+        return;
+    }
+    const auto base = batches.front().base_offset();
+    const auto last = batches.back().last_offset();
+
+    if (auto git = _groups.find(group); git != _groups.end()) {
+        auto& ranges = git->second;
+        if (ranges.begin()->second.term != term) {
+            invalidate(group);
+        } else if (overlaps(ranges, base, last)) {
+            return;
+        }
+    }
+
+    size_t size = 0;
+    for (const auto& b : batches) {
+        size += b.size_bytes();
+    }
+    const auto max_cached = _quota.max_memory() / 2;
+    if (size > max_cached) {
+        return;
+    }
+    while (_cached_bytes + size > max_cached && !_lru.empty()) {
+        evict_lru();
+    }
+    auto units = _quota.try_acquire_cache_memory(size);
+    if (!units) {
+        return;
+    }
+
+    ss::circular_buffer<model::record_batch> shared;
+    shared.reserve(batches.size());
+    for (auto& b : batches) {
+        shared.push_back(b.share());
+    }
+    auto [it, _] = _groups[group].emplace(
+      base,
+      range{
+        .group = group,
+        .term = term,
+        .last = last,
+        .batches = std::move(shared),
+        .size = size,
+        .units = std::move(*units)});
+    _lru.push_back(it->second);
+    _cached_bytes += size;
+}
+
+bool recovery_read_cache::overlaps(
+  const ranges_t& ranges, model::offset base, model::offset last) {
+    if (auto it = ranges.lower_bound(base);
+        it != ranges.end() && it->first <= last) {
+        return true;
+    }
+    if (auto it = ranges.upper_bound(base); it != ranges.begin()) {
+        return std::prev(it)->second.last >= base;
+    }
+    return false;
+}
+
+void recovery_read_cache::invalidate(group_id group) {
+    auto git = _groups.find(group);
+    if (git == _groups.end()) {
+        return;
+    }
+    auto& ranges = git->second;
+    for (auto it = ranges.begin(); it != ranges.end();) {
+        erase(ranges, it++);
+    }
+    _groups.erase(git);
+}
+
+void recovery_read_cache::reclaim(size_t bytes) {
+    const auto target = _cached_bytes > bytes ? _cached_bytes - bytes : 0;
+    while (_cached_bytes > target && !_lru.empty()) {
+        evict_lru();
+    }
+}
+
+void recovery_read_cache::erase(ranges_t& ranges, ranges_t::iterator it) {
+    _cached_bytes -= it->second.size;
+    ranges.erase(it);
+}
+
+void recovery_read_cache::evict_lru() {
+    auto& r = _lru.front();
+    auto git = _groups.find(r.group);
+    vassert(
+      git != _groups.end(), "group {} of a cached range not found", r.group);
+    auto& ranges = git->second;
+    erase(ranges, ranges.find(r.batches.front().base_offset()));
+    if (ranges.empty()) {
+        _groups.erase(git);
+    }
+    ++_evictions;
+}
+
+void recovery_read_cache::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("raft:recovery_read_cache"),
+      {sm::make_derive(
+         "hits",
+         [this] { return _hits; },
+         sm::description("Number of recovery reads served from the cache")),
+       sm::make_derive(
+         "misses",
+         [this] { return _misses; },
+         sm::description("Number of recovery reads that missed the cache")),
+       sm::make_derive(
+         "evictions",
+         [this] { return _evictions; },
+         sm::description("Number of cached ranges evicted")),
+       sm::make_gauge(
+         "cached_bytes",
+         [this] { return _cached_bytes; },
+         sm::description("Bytes of the ranges held by the cache")),
+       sm::make_gauge(
+         "hit_ratio",
+         [this] {
+             const auto lookups = _hits + _misses;
+             return lookups == 0 ? 0.0 : double(_hits) / double(lookups);
+         },
+         sm::description("Ratio of recovery reads served from the cache"))});
+}
+
+} // namespace raft
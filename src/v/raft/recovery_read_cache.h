@@ -0,0 +1,102 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "model/record.h"
+#include "raft/types.h"
+#include "seastarx.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/semaphore.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <map>
+#include <optional>
+
+namespace raft {
+
+class recovery_memory_quota;
+
+/**
+ * Ranges of the log read for the recovery of a follower, shared with the
+ * recoveries of the other followers of the same group. When more than one
+ * follower lags behind they usually need the same ranges and without the
+ * cache each of them re-reads the ranges from disk.
+ *
+ * Memory of the cached ranges is taken from the recovery memory quota without
+ * waiting. At most half of the quota is used for caching, ranges are evicted
+ * in LRU order when that is exceeded or when recovery reads wait for memory.
+ * A range is tagged with the term of the leader that read it; a lookup in a
+ * newer term drops the ranges of the group as the log may have been truncated.
+ */
+class recovery_read_cache {
+public:
+    explicit recovery_read_cache(recovery_memory_quota&);
+    recovery_read_cache(recovery_read_cache&&) = delete;
+    recovery_read_cache(const recovery_read_cache&) = delete;
+    recovery_read_cache& operator=(recovery_read_cache&&) = delete;
+    recovery_read_cache& operator=(const recovery_read_cache&) = delete;
+    ~recovery_read_cache() noexcept = default;
+
+    /// batches starting with the one containing `start` of the range cached
+    /// for the group in the given term, up to `max_bytes` but at least one
+    std::optional<ss::circular_buffer<model::record_batch>> get(
+      group_id, model::term_id, model::offset start, size_t max_bytes);
+
+    /// caches batches read from the log, in order and without gaps, sharing
+    /// their buffers. Ranges overlapping one that is already cached are
+    /// ignored
+    void put(
+      group_id, model::term_id, ss::circular_buffer<model::record_batch>&);
+
+    /// drops all the ranges of the group
+    void invalidate(group_id);
+
+    /// evicts ranges until `bytes` were released or the cache is empty
+    void reclaim(size_t bytes);
+
+    size_t cached_bytes() const { return _cached_bytes; }
+
+    void setup_metrics();
+
+private:
+    struct range {
+        group_id group;
+        model::term_id term;
+        model::offset last;
+        ss::circular_buffer<model::record_batch> batches;
+        size_t size;
+        ss::semaphore_units<> units;
+        intrusive_list_hook _hook;
+    };
+    // std::map as the ranges are linked in the lru list
+    using ranges_t = std::map<model::offset, range>;
+
+    static bool overlaps(const ranges_t&, model::offset, model::offset);
+    void erase(ranges_t&, ranges_t::iterator);
+    void evict_lru();
+
+    recovery_memory_quota& _quota;
+    absl::flat_hash_map<group_id, ranges_t> _groups;
+    intrusive_list<range, &range::_hook> _lru;
+    size_t _cached_bytes{0};
+
+    uint64_t _hits{0};
+    uint64_t _misses{0};
+    uint64_t _evictions{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace raft
@@ -9,6 +9,7 @@
 
 #include "raft/recovery_stm.h"
 
+#include "config/configuration.h"
 #include "model/fundamental.h"
 #include "model/record_batch_reader.h"
 #include "outcome_future_utils.h"
@@ -26,6 +27,7 @@
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
 #include <seastar/core/with_scheduling_group.hh>
+#include <seastar/util/defer.hh>
 
 #include <chrono>
 #include <optional>
@@ -79,9 +81,18 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
         co_return;
     }
 
+    if (_pipeline_broken) {
+        // wait for the requests dispatched before the failure, next round
+        // starts from the rewound next index
+        co_return co_await drain_pipeline();
+    }
+
     auto lstats = _ptr->_log.offsets();
     // follower last index was already evicted at the leader, use snapshot
     if (meta.value()->next_index <= _ptr->_last_snapshot_index) {
+        if (_in_flight > 0) {
+            co_return co_await drain_pipeline();
+        }
         co_return co_await install_snapshot();
     }
 
@@ -117,7 +128,11 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
      */
     _committed_offset = _ptr->committed_offset();
 
-    auto follower_next_offset = meta.value()->next_index;
+    // next index is only updated by replies, continue after the requests that
+    // are in flight
+    auto follower_next_offset = _in_flight > 0
+                                  ? details::next_offset(_last_dispatched_offset)
+                                  : meta.value()->next_index;
     auto follower_committed_match_index = meta.value()->match_committed_index();
     auto is_learner = meta.value()->is_learner;
 
@@ -134,6 +149,9 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
 
     // wait for another round
     if (meta.value()->last_sent_offset >= lstats.dirty_offset) {
+        if (_in_flight > 0) {
+            co_return co_await drain_pipeline();
+        }
         co_await meta.value()
           ->follower_state_change.wait()
           .handle_exception_type([this](const ss::broken_condition_variable&) {
@@ -141,6 +159,16 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
           });
         co_return;
     }
+    // wait for a free slot in the follower pipeline
+    auto pipeline_unit = co_await _ptr->_fstats.get_append_entries_unit(
+      _node_id);
+    auto return_unit = ss::defer([this, &pipeline_unit] {
+        pipeline_unit.return_all();
+        _ptr->_fstats.return_append_entries_units(_node_id);
+    });
+    if (_pipeline_broken || is_recovery_finished()) {
+        co_return;
+    }
     // acquire read memory:
     auto read_memory_units = co_await _memory_quota.acquire_read_memory();
     auto reader = co_await read_range_for_recovery(
@@ -150,12 +178,17 @@ ss::future<> recovery_stm::do_recover(ss::io_priority_class iopc) {
         co_return;
     }
 
+    return_unit.cancel();
     co_await replicate(
       std::move(*reader),
       should_flush(follower_committed_match_index),
-      std::move(read_memory_units));
+      std::move(read_memory_units),
+      std::move(pipeline_unit));
+}
 
-    meta = get_follower_meta();
+ss::future<> recovery_stm::drain_pipeline() {
+    co_await std::exchange(_pending_replies, ss::now());
+    _pipeline_broken = false;
 }
 
 bool recovery_stm::state_changed() {
@@ -220,10 +253,21 @@ recovery_stm::read_range_for_recovery(
 
     vlog(_ctxlog.trace, "Reading batches, starting from: {}", start_offset);
 
-    // TODO: add timeout of maybe 1minute?
-    auto reader = co_await _ptr->_log.make_reader(cfg);
-    auto batches = co_await model::consume_reader_to_memory(
-      std::move(reader), model::no_timeout);
+    auto& cache = _memory_quota.read_cache();
+    ss::circular_buffer<model::record_batch> batches;
+    if (auto cached = cache.get(_ptr->group(), _term, start_offset, read_size)) {
+        batches = std::move(*cached);
+    } else {
+        // TODO: add timeout of maybe 1minute?
+        auto reader = co_await _ptr->_log.make_reader(cfg);
+        batches = co_await model::consume_reader_to_memory(
+          std::move(reader), model::no_timeout);
+        // other followers recovering the same range will find it in the cache,
+        // learners usually read from the beginning of the log by themselves
+        if (!is_learner) {
+            cache.put(_ptr->group(), _term, batches);
+        }
+    }
 
     if (batches.empty()) {
         vlog(_ctxlog.trace, "Read no batches for recovery, stopping");
@@ -261,11 +305,13 @@ recovery_stm::read_range_for_recovery(
 }
 
 ss::future<> recovery_stm::open_snapshot_reader() {
+    auto last_included_index = _ptr->_last_snapshot_index;
     return _ptr->_snapshot_mgr.open_snapshot().then(
-      [this](std::optional<storage::snapshot_reader> rdr) {
+      [this, last_included_index](std::optional<storage::snapshot_reader> rdr) {
           if (rdr) {
               _snapshot_reader = std::make_unique<storage::snapshot_reader>(
                 std::move(*rdr));
+              _snapshot_last_included_index = last_included_index;
               return _snapshot_reader->get_snapshot_size().then(
                 [this](size_t sz) { _snapshot_size = sz; });
           }
@@ -274,42 +320,54 @@ ss::future<> recovery_stm::open_snapshot_reader() {
 }
 
 ss::future<> recovery_stm::send_install_snapshot_request() {
-    // send 32KB at a time
-    return read_iobuf_exactly(_snapshot_reader->input(), 32_KiB)
-      .then([this](iobuf chunk) mutable {
-          auto chunk_size = chunk.size_bytes();
-          install_snapshot_request req{
-            .target_node_id = _node_id,
-            .term = _ptr->term(),
-            .group = _ptr->group(),
-            .node_id = _ptr->_self,
-            .last_included_index = _ptr->_last_snapshot_index,
-            .file_offset = _sent_snapshot_bytes,
-            .chunk = std::move(chunk),
-            .done = (_sent_snapshot_bytes + chunk_size) == _snapshot_size};
-
-          vlog(
-            _ctxlog.trace,
-            "Sending install snapshot request, last included index: {}",
-            req.last_included_index);
-          auto seq = _ptr->next_follower_sequence(_node_id);
-          _ptr->update_suppress_heartbeats(
-            _node_id, seq, heartbeats_suppressed::yes);
-          return _ptr->_client_protocol
-            .install_snapshot(
-              _node_id.id(),
-              std::move(req),
-              rpc::client_opts(append_entries_timeout()))
-            .then([this](result<install_snapshot_reply> reply) {
-                return handle_install_snapshot_reply(
-                  _ptr->validate_reply_target_node(
-                    "install_snapshot", std::move(reply)));
-            })
-            .finally([this, seq] {
-                _ptr->update_suppress_heartbeats(
-                  _node_id, seq, heartbeats_suppressed::no);
-            });
-      });
+    // a chunk the follower did not acknowledge is sent again
+    auto read = _unacked_chunk.empty()
+                  ? read_iobuf_exactly(
+                    _snapshot_reader->input(),
+                    config::shard_local_cfg().raft_install_snapshot_chunk_size())
+                  : ss::make_ready_future<iobuf>(
+                    _unacked_chunk.share(0, _unacked_chunk.size_bytes()));
+    return std::move(read).then([this](iobuf chunk) mutable {
+        auto chunk_size = chunk.size_bytes();
+        if (_unacked_chunk.empty()) {
+            _unacked_chunk = chunk.share(0, chunk_size);
+        }
+        install_snapshot_request req{
+          .target_node_id = _node_id,
+          .term = _ptr->term(),
+          .group = _ptr->group(),
+          .node_id = _ptr->_self,
+          .last_included_index = _snapshot_last_included_index,
+          .file_offset = _sent_snapshot_bytes,
+          .chunk = std::move(chunk),
+          .done = (_sent_snapshot_bytes + chunk_size) == _snapshot_size};
+
+        vlog(
+          _ctxlog.trace,
+          "Sending install snapshot request, last included index: {}, file "
+          "offset: {}",
+          req.last_included_index,
+          req.file_offset);
+        auto seq = _ptr->next_follower_sequence(_node_id);
+        _ptr->update_suppress_heartbeats(
+          _node_id, seq, heartbeats_suppressed::yes);
+        return _ptr->_client_protocol
+          .install_snapshot(
+            _node_id.id(),
+            std::move(req),
+            rpc::client_opts(append_entries_timeout()))
+          .then([this, end = _sent_snapshot_bytes + chunk_size](
+                  result<install_snapshot_reply> reply) {
+              return handle_install_snapshot_reply(
+                _ptr->validate_reply_target_node(
+                  "install_snapshot", std::move(reply)),
+                end);
+          })
+          .finally([this, seq] {
+              _ptr->update_suppress_heartbeats(
+                _node_id, seq, heartbeats_suppressed::no);
+          });
+    });
 }
 
 ss::future<> recovery_stm::close_snapshot_reader() {
@@ -317,23 +375,76 @@ ss::future<> recovery_stm::close_snapshot_reader() {
         _snapshot_reader.reset();
         _snapshot_size = 0;
         _sent_snapshot_bytes = 0;
+        _unacked_chunk.clear();
     });
 }
 
+ss::future<> recovery_stm::resume_snapshot(uint64_t offset) {
+    co_await close_snapshot_reader();
+    co_await open_snapshot_reader();
+    if (!_snapshot_reader) {
+        co_return;
+    }
+    // the leader may have taken a new snapshot in the meantime, the follower
+    // then rejects the next chunk and the transfer starts over
+    if (offset < _snapshot_size) {
+        co_await _snapshot_reader->input().skip(offset);
+        _sent_snapshot_bytes = offset;
+    } else {
+        _sent_snapshot_bytes = 0;
+    }
+}
+
 ss::future<> recovery_stm::handle_install_snapshot_reply(
-  result<install_snapshot_reply> reply) {
+  result<install_snapshot_reply> reply, uint64_t chunk_end) {
     // snapshot delivery failed
-    if (reply.has_error() || !reply.value().success) {
-        // if snapshot delivery failed, stop recovery to update follower state
-        // and retry
-        _stop_requested = true;
-        return close_snapshot_reader();
+    if (reply.has_error()) {
+        // the follower may have stored the chunk or not, it is sent again from
+        // the same offset and a follower that stored it tells so. Recovery
+        // stops when the follower keeps failing, the follower keeps the
+        // bytes it received for the next recovery to resume from.
+        if (++_snapshot_chunk_failures > max_snapshot_chunk_failures) {
+            _stop_requested = true;
+            return close_snapshot_reader();
+        }
+        vlog(
+          _ctxlog.debug,
+          "Install snapshot chunk at {} failed, retrying - {}",
+          _sent_snapshot_bytes,
+          reply.error().message());
+        return ss::now();
     }
     if (reply.value().term > _ptr->_term) {
         return close_snapshot_reader().then(
           [this, term = reply.value().term] { return _ptr->step_down(term); });
     }
-    _sent_snapshot_bytes = reply.value().bytes_stored;
+    const auto bytes_stored = reply.value().bytes_stored;
+    // a follower that stored the chunk before the reply to it was lost
+    // rejects it when it is sent again, the transfer just continues
+    if (
+      !reply.value().success
+      && (bytes_stored != chunk_end || chunk_end == _snapshot_size)) {
+        // the chunk was rejected, i.e. it didn't match its checksum or the
+        // follower holds a different part of the transfer. Continue from the
+        // bytes the follower stored, unless it keeps rejecting chunks.
+        if (++_snapshot_chunk_failures > max_snapshot_chunk_failures) {
+            _stop_requested = true;
+            return close_snapshot_reader();
+        }
+        vlog(
+          _ctxlog.debug,
+          "Install snapshot chunk ending at {} rejected, resuming from {}",
+          chunk_end,
+          bytes_stored);
+        if (bytes_stored == _sent_snapshot_bytes) {
+            // the reader is still positioned after the unacknowledged chunk
+            return ss::now();
+        }
+        return resume_snapshot(bytes_stored);
+    }
+    _snapshot_chunk_failures = 0;
+    _sent_snapshot_bytes = chunk_end;
+    _unacked_chunk.clear();
 
     // we will send next chunk as a part of recovery loop
     if (_sent_snapshot_bytes != _snapshot_size) {
@@ -348,9 +459,9 @@ ss::future<> recovery_stm::handle_install_snapshot_reply(
     }
 
     // snapshot received by the follower, continue with recovery
-    (*meta)->match_index = _ptr->_last_snapshot_index;
-    (*meta)->next_index = details::next_offset(_ptr->_last_snapshot_index);
-    (*meta)->last_sent_offset = _ptr->_last_snapshot_index;
+    (*meta)->match_index = _snapshot_last_included_index;
+    (*meta)->next_index = details::next_offset(_snapshot_last_included_index);
+    (*meta)->last_sent_offset = _snapshot_last_included_index;
     return close_snapshot_reader();
 }
 
@@ -373,7 +484,12 @@ ss::future<> recovery_stm::install_snapshot() {
 ss::future<> recovery_stm::replicate(
   model::record_batch_reader&& reader,
   append_entries_request::flush_after_append flush,
-  ss::semaphore_units<> mem_units) {
+  ss::semaphore_units<> mem_units,
+  ss::semaphore_units<> pipeline_unit) {
+    auto return_unit = [this](ss::semaphore_units<> u) {
+        u.return_all();
+        _ptr->_fstats.return_append_entries_units(_node_id);
+    };
     // collect metadata for append entries request
     // last persisted offset is last_offset of batch before the first one in the
     // reader
@@ -388,7 +504,12 @@ ss::future<> recovery_stm::replicate(
     } else if (prev_log_idx == _ptr->_last_snapshot_index) {
         prev_log_term = _ptr->_last_snapshot_term;
     } else {
-        // no entry for prev_log_idx, fallback to install snapshot
+        return_unit(std::move(pipeline_unit));
+        // no entry for prev_log_idx, fallback to install snapshot once the
+        // requests in flight returned
+        if (_in_flight > 0) {
+            return drain_pipeline();
+        }
         return install_snapshot();
     }
 
@@ -412,10 +533,12 @@ ss::future<> recovery_stm::replicate(
     auto meta = get_follower_meta();
 
     if (!meta) {
+        return_unit(std::move(pipeline_unit));
         _stop_requested = true;
         return ss::now();
     }
     meta.value()->last_sent_offset = _last_batch_offset;
+    _last_dispatched_offset = _last_batch_offset;
     _ptr->update_node_append_timestamp(_node_id);
 
     auto seq = _ptr->next_follower_sequence(_node_id);
@@ -423,56 +546,104 @@ ss::future<> recovery_stm::replicate(
     auto lstats = _ptr->_log.offsets();
     std::vector<ss::semaphore_units<>> units;
     units.push_back(std::move(mem_units));
-    return dispatch_append_entries(std::move(r), std::move(units))
-      .finally([this, seq] {
-          _ptr->update_suppress_heartbeats(
-            _node_id, seq, heartbeats_suppressed::no);
-      })
-      .then([this, seq, dirty_offset = lstats.dirty_offset](auto r) {
-          if (!r) {
-              vlog(
-                _ctxlog.error,
-                "recovery append entries error: {}",
-                r.error().message());
-              _stop_requested = true;
-              _ptr->get_probe().recovery_request_error();
-          }
-          _ptr->process_append_entries_reply(
-            _node_id.id(), r.value(), seq, dirty_offset);
-          // If follower stats aren't present we have to stop recovery as
-          // follower was removed from configuration
-          if (!_ptr->_fstats.contains(_node_id)) {
-              _stop_requested = true;
-              return;
-          }
-          // If request was reordered we have to stop recovery as follower state
-          // is not known
-          if (seq < _ptr->_fstats.get(_node_id).last_received_seq) {
-              _stop_requested = true;
-              return;
-          }
-          // move the follower next index backward if recovery were not
-          // successfull
-          //
-          // Raft paper:
-          // If AppendEntries fails because of log inconsistency: decrement
-          // nextIndex and retry(§5.3)
-
-          if (r.value().result == append_entries_reply::status::failure) {
-              auto meta = get_follower_meta();
-              if (!meta) {
-                  _stop_requested = true;
-                  return;
-              }
-              meta.value()->next_index = std::max(
-                model::offset(0), details::prev_offset(_base_batch_offset));
-              meta.value()->last_sent_offset = model::offset{};
-              vlog(
-                _ctxlog.trace,
-                "Move next index {} backward",
-                meta.value()->next_index);
-          }
+    ++_in_flight;
+    auto reply = dispatch_append_entries(std::move(r), std::move(units))
+                   .handle_exception([this](const std::exception_ptr& e) {
+                       vlog(_ctxlog.warn, "Error while recovering {}", e);
+                       return result<append_entries_reply>(
+                         errc::append_entries_dispatch_error);
+                   });
+    // the request is on its way, its reply is processed after the replies of
+    // all the requests dispatched before it. When processing an earlier reply
+    // failed the reply is dropped, its units are returned all the same and
+    // the failure is passed on.
+    _pending_replies = _pending_replies.then_wrapped(
+      [this,
+       reply = std::move(reply),
+       seq,
+       dirty_offset = lstats.dirty_offset,
+       base_offset = _base_batch_offset,
+       pipeline_unit = std::move(pipeline_unit),
+       return_unit](ss::future<> prev) mutable {
+          const bool failed = prev.failed();
+          return std::move(reply)
+            .then([this, seq, dirty_offset, base_offset, failed](
+                    result<append_entries_reply> r) {
+                --_in_flight;
+                _ptr->update_suppress_heartbeats(
+                  _node_id, seq, heartbeats_suppressed::no);
+                if (!failed) {
+                    process_reply(
+                      std::move(r), seq, dirty_offset, base_offset);
+                }
+            })
+            .finally([pipeline_unit = std::move(pipeline_unit),
+                      return_unit]() mutable {
+                return_unit(std::move(pipeline_unit));
+            })
+            .then([prev = std::move(prev)]() mutable {
+                return std::move(prev);
+            });
       });
+    return ss::now();
+}
+
+void recovery_stm::process_reply(
+  result<append_entries_reply> r,
+  follower_req_seq seq,
+  model::offset dirty_offset,
+  model::offset base_batch_offset) {
+    if (!r) {
+        vlog(
+          _ctxlog.error,
+          "recovery append entries error: {}",
+          r.error().message());
+        _stop_requested = true;
+        _pipeline_broken = true;
+        _ptr->get_probe().recovery_request_error();
+        return;
+    }
+    _ptr->process_append_entries_reply(
+      _node_id.id(), r.value(), seq, dirty_offset);
+    // If follower stats aren't present we have to stop recovery as
+    // follower was removed from configuration
+    if (!_ptr->_fstats.contains(_node_id)) {
+        _stop_requested = true;
+        return;
+    }
+    // If request was reordered we have to stop recovery as follower state
+    // is not known
+    if (seq < _ptr->_fstats.get(_node_id).last_received_seq) {
+        _stop_requested = true;
+        return;
+    }
+    // move the follower next index backward if recovery were not
+    // successfull
+    //
+    // Raft paper:
+    // If AppendEntries fails because of log inconsistency: decrement
+    // nextIndex and retry(§5.3)
+
+    if (r.value().result == append_entries_reply::status::failure) {
+        if (_pipeline_broken) {
+            // request was dispatched after the one that already failed, its
+            // base offset is further ahead than the rewound next index
+            return;
+        }
+        _pipeline_broken = true;
+        auto meta = get_follower_meta();
+        if (!meta) {
+            _stop_requested = true;
+            return;
+        }
+        meta.value()->next_index = std::max(
+          model::offset(0), details::prev_offset(base_batch_offset));
+        meta.value()->last_sent_offset = model::offset{};
+        vlog(
+          _ctxlog.trace,
+          "Move next index {} backward",
+          meta.value()->next_index);
+    }
 }
 
 clock_type::time_point recovery_stm::append_entries_timeout() {
@@ -526,11 +697,13 @@ ss::future<> recovery_stm::apply() {
     return ss::with_gate(
              _ptr->_bg,
              [this] {
-                 return recover().then([this] {
-                     return ss::do_until(
-                       [this] { return is_recovery_finished(); },
-                       [this] { return recover(); });
-                 });
+                 return recover()
+                   .then([this] {
+                       return ss::do_until(
+                         [this] { return is_recovery_finished(); },
+                         [this] { return recover(); });
+                   })
+                   .finally([this] { return drain_pipeline(); });
              })
       .finally([this] {
           vlog(_ctxlog.trace, "Finished recovery");
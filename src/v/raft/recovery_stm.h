@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "bytes/iobuf.h"
 #include "model/metadata.h"
 #include "outcome.h"
 #include "raft/logger.h"
@@ -24,6 +25,15 @@
 
 namespace raft {
 
+/**
+ * Recovery keeps up to `raft_max_concurrent_append_requests_per_follower`
+ * append entries requests in flight to the follower, the limit is shared with
+ * the replicate path through the follower queue. Each request continues where
+ * the previous one ended, replies are processed in order of dispatch. When a
+ * request fails the pipeline is drained, replies of requests dispatched after
+ * it are not used to move the follower next index, and recovery restarts from
+ * the rewound next index.
+ */
 class recovery_stm {
 public:
     recovery_stm(consensus*, vnode, scheduling_config, recovery_memory_quota&);
@@ -38,7 +48,14 @@ private:
     ss::future<> replicate(
       model::record_batch_reader&&,
       append_entries_request::flush_after_append,
+      ss::semaphore_units<>,
       ss::semaphore_units<>);
+    void process_reply(
+      result<append_entries_reply>,
+      follower_req_seq,
+      model::offset dirty_offset,
+      model::offset base_batch_offset);
+    ss::future<> drain_pipeline();
     ss::future<result<append_entries_reply>> dispatch_append_entries(
       append_entries_request&&, std::vector<ss::semaphore_units<>>);
     std::optional<follower_index_metadata*> get_follower_meta();
@@ -46,7 +63,9 @@ private:
 
     ss::future<> install_snapshot();
     ss::future<> send_install_snapshot_request();
-    ss::future<> handle_install_snapshot_reply(result<install_snapshot_reply>);
+    ss::future<> handle_install_snapshot_reply(
+      result<install_snapshot_reply>, uint64_t chunk_end);
+    ss::future<> resume_snapshot(uint64_t);
     ss::future<> open_snapshot_reader();
     ss::future<> close_snapshot_reader();
     bool state_changed();
@@ -57,14 +76,26 @@ private:
     vnode _node_id;
     model::offset _base_batch_offset;
     model::offset _last_batch_offset;
+    // last offset sent by a request still in flight
+    model::offset _last_dispatched_offset;
+    size_t _in_flight = 0;
+    // reply processing chained in order of dispatch
+    ss::future<> _pending_replies = ss::now();
+    // a request failed, requests dispatched after it are stale
+    bool _pipeline_broken = false;
     model::offset _committed_offset;
     model::term_id _term;
     scheduling_config _scheduling;
     prefix_logger _ctxlog;
     // tracking follower snapshot delivery
+    static constexpr int max_snapshot_chunk_failures = 5;
     std::unique_ptr<storage::snapshot_reader> _snapshot_reader;
+    model::offset _snapshot_last_included_index;
     size_t _sent_snapshot_bytes = 0;
     size_t _snapshot_size = 0;
+    int _snapshot_chunk_failures = 0;
+    // the last chunk sent, kept until the follower acknowledges it
+    iobuf _unacked_chunk;
     // needed to early exit. (node down)
     bool _stop_requested = false;
     recovery_memory_quota& _memory_quota;
@@ -9,12 +9,16 @@
 
 #include "raft/rpc_client_protocol.h"
 
+#include "bytes/utils.h"
+#include "hashing/crc32c.h"
 #include "outcome_future_utils.h"
+#include "raft/logger.h"
 #include "raft/raftgen_service.h"
 #include "rpc/connection_cache.h"
 #include "rpc/exceptions.h"
 #include "rpc/transport.h"
 #include "rpc/types.h"
+#include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
 
@@ -49,6 +53,57 @@ ss::future<result<append_entries_reply>> rpc_client_protocol::append_entries(
 }
 
 ss::future<result<heartbeat_reply>> rpc_client_protocol::heartbeat(
+  model::node_id n, heartbeat_request&& r, rpc::client_opts opts) {
+    auto it = _heartbeat_formats.find(n);
+    if (
+      it != _heartbeat_formats.end()
+      && it->second == heartbeat_format::legacy) {
+        return legacy_heartbeat(n, std::move(r), std::move(opts))
+          .then([this, n](result<heartbeat_reply> ret) {
+              update_heartbeat_format(n, heartbeat_format::legacy, ret);
+              return ret;
+          });
+    }
+    // until the node replied once keep a copy to resend in the old format
+    std::optional<heartbeat_request> fallback;
+    if (it == _heartbeat_formats.end()) {
+        fallback = heartbeat_request{r.heartbeats};
+    }
+    auto timeout = opts.timeout;
+    auto compression = opts.compression;
+    auto min_compression_bytes = opts.min_compression_bytes;
+    return _connection_cache.local()
+      .with_node_client<raftgen_client_protocol>(
+        _self,
+        ss::this_shard_id(),
+        n,
+        opts.timeout,
+        [r = compact_heartbeat_request{std::move(r.heartbeats)},
+         opts = std::move(opts)](raftgen_client_protocol client) mutable {
+            return client.heartbeat_v2(std::move(r), std::move(opts))
+              .then(&rpc::get_ctx_data<heartbeat_reply>);
+        })
+      .then([this,
+             n,
+             fallback = std::move(fallback),
+             timeout,
+             compression,
+             min_compression_bytes](result<heartbeat_reply> ret) mutable {
+          update_heartbeat_format(n, heartbeat_format::compact, ret);
+          if (
+            ret.has_error() && ret.error() == rpc::errc::method_not_found
+            && fallback) {
+              return legacy_heartbeat(
+                n,
+                std::move(*fallback),
+                rpc::client_opts(timeout, compression, min_compression_bytes));
+          }
+          return ss::make_ready_future<result<heartbeat_reply>>(
+            std::move(ret));
+      });
+}
+
+ss::future<result<heartbeat_reply>> rpc_client_protocol::legacy_heartbeat(
   model::node_id n, heartbeat_request&& r, rpc::client_opts opts) {
     return _connection_cache.local().with_node_client<raftgen_client_protocol>(
       _self,
@@ -62,8 +117,111 @@ ss::future<result<heartbeat_reply>> rpc_client_protocol::heartbeat(
       });
 }
 
+void rpc_client_protocol::update_heartbeat_format(
+  model::node_id n, heartbeat_format sent, const result<heartbeat_reply>& r) {
+    if (r) {
+        _heartbeat_formats[n] = sent;
+        return;
+    }
+    if (
+      r.error() == rpc::errc::method_not_found
+      && sent == heartbeat_format::compact) {
+        _heartbeat_formats[n] = heartbeat_format::legacy;
+        vlog(
+          raftlog.info,
+          "node {} does not support compact heartbeats, falling back",
+          n);
+        return;
+    }
+    if (
+      r.error() == rpc::errc::disconnected_endpoint
+      || r.error() == rpc::errc::exponential_backoff) {
+        _heartbeat_formats.erase(n);
+    }
+}
+
+ss::future<result<node_heartbeat_reply>> rpc_client_protocol::node_heartbeat(
+  model::node_id n, node_heartbeat_request&& r, rpc::client_opts opts) {
+    return _connection_cache.local().with_node_client<raftgen_client_protocol>(
+      _self,
+      ss::this_shard_id(),
+      n,
+      opts.timeout,
+      [r = std::move(r),
+       opts = std::move(opts)](raftgen_client_protocol client) mutable {
+          return client.node_heartbeat(std::move(r), std::move(opts))
+            .then(&rpc::get_ctx_data<node_heartbeat_reply>);
+      });
+}
+
 ss::future<result<install_snapshot_reply>>
 rpc_client_protocol::install_snapshot(
+  model::node_id n, install_snapshot_request&& r, rpc::client_opts opts) {
+    if (_legacy_install_snapshot.contains(n)) {
+        return legacy_install_snapshot(n, std::move(r), std::move(opts))
+          .then([this, n](result<install_snapshot_reply> ret) {
+              // the node may be upgraded by the time it reconnects
+              if (
+                ret.has_error()
+                && (ret.error() == rpc::errc::disconnected_endpoint
+                    || ret.error() == rpc::errc::exponential_backoff)) {
+                  _legacy_install_snapshot.erase(n);
+              }
+              return ret;
+          });
+    }
+    crc::crc32c crc;
+    crc_extend_iobuf(crc, r.chunk);
+    // keep a copy to resend in the old format
+    install_snapshot_request fallback{
+      .target_node_id = r.target_node_id,
+      .term = r.term,
+      .group = r.group,
+      .node_id = r.node_id,
+      .last_included_index = r.last_included_index,
+      .file_offset = r.file_offset,
+      .chunk = r.chunk.share(0, r.chunk.size_bytes()),
+      .done = r.done};
+    auto timeout = opts.timeout;
+    auto compression = opts.compression;
+    auto min_compression_bytes = opts.min_compression_bytes;
+    return _connection_cache.local()
+      .with_node_client<raftgen_client_protocol>(
+        _self,
+        ss::this_shard_id(),
+        n,
+        opts.timeout,
+        [r = install_snapshot_v2_request{std::move(r), crc.value()},
+         opts = std::move(opts)](raftgen_client_protocol client) mutable {
+            return client.install_snapshot_v2(std::move(r), std::move(opts))
+              .then(&rpc::get_ctx_data<install_snapshot_reply>);
+        })
+      .then([this,
+             n,
+             fallback = std::move(fallback),
+             timeout,
+             compression,
+             min_compression_bytes](
+              result<install_snapshot_reply> ret) mutable {
+          if (ret.has_error() && ret.error() == rpc::errc::method_not_found) {
+              vlog(
+                raftlog.info,
+                "node {} does not support snapshot chunk checksums, falling "
+                "back",
+                n);
+              _legacy_install_snapshot.insert(n);
+              return legacy_install_snapshot(
+                n,
+                std::move(fallback),
+                rpc::client_opts(timeout, compression, min_compression_bytes));
+          }
+          return ss::make_ready_future<result<install_snapshot_reply>>(
+            std::move(ret));
+      });
+}
+
+ss::future<result<install_snapshot_reply>>
+rpc_client_protocol::legacy_install_snapshot(
   model::node_id n, install_snapshot_request&& r, rpc::client_opts opts) {
     return _connection_cache.local().with_node_client<raftgen_client_protocol>(
       _self,
@@ -97,6 +255,8 @@ ss::future<> rpc_client_protocol::reset_backoff(model::node_id n) {
 }
 
 ss::future<bool> rpc_client_protocol::ensure_disconnect(model::node_id n) {
+    _heartbeat_formats.erase(n);
+    _legacy_install_snapshot.erase(n);
     struct resetter {
         rpc::transport& transport;
         resetter(rpc::transport& t)
@@ -19,6 +19,9 @@
 #include "rpc/connection_cache.h"
 #include "rpc/transport.h"
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
 #include <system_error>
 
 namespace raft {
@@ -40,6 +43,9 @@ public:
     ss::future<result<heartbeat_reply>>
     heartbeat(model::node_id, heartbeat_request&&, rpc::client_opts) final;
 
+    ss::future<result<node_heartbeat_reply>> node_heartbeat(
+      model::node_id, node_heartbeat_request&&, rpc::client_opts) final;
+
     ss::future<result<install_snapshot_reply>> install_snapshot(
       model::node_id, install_snapshot_request&&, rpc::client_opts) final;
 
@@ -54,8 +60,29 @@ public:
     ss::future<> reset_backoff(model::node_id n);
 
 private:
+    /// Heartbeats are sent with the compact encoding of heartbeat_v2 unless
+    /// the node is known not to support it. The format is negotiated per
+    /// connection: the first heartbeat to a node tries heartbeat_v2 and falls
+    /// back to heartbeat if the node replies with method_not_found. Whatever
+    /// was learned is forgotten when the connection drops, the node may have
+    /// been upgraded or downgraded in the meantime.
+    enum class heartbeat_format { compact, legacy };
+
+    ss::future<result<heartbeat_reply>>
+    legacy_heartbeat(model::node_id, heartbeat_request&&, rpc::client_opts);
+    void update_heartbeat_format(
+      model::node_id, heartbeat_format sent, const result<heartbeat_reply>&);
+
+    /// Snapshot chunks are sent with their checksum through
+    /// install_snapshot_v2 unless the node replied with method_not_found, in
+    /// which case install_snapshot is used until the connection drops.
+    ss::future<result<install_snapshot_reply>> legacy_install_snapshot(
+      model::node_id, install_snapshot_request&&, rpc::client_opts);
+
     model::node_id _self;
     ss::sharded<rpc::connection_cache>& _connection_cache;
+    absl::flat_hash_map<model::node_id, heartbeat_format> _heartbeat_formats;
+    absl::flat_hash_set<model::node_id> _legacy_install_snapshot;
 };
 
 inline consensus_client_protocol make_rpc_client_protocol(
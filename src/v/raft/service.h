@@ -13,6 +13,7 @@
 
 #include "likely.h"
 #include "raft/consensus.h"
+#include "raft/node_liveness.h"
 #include "raft/raftgen_service.h"
 #include "raft/types.h"
 #include "seastarx.h"
@@ -20,6 +21,7 @@
 
 #include <seastar/core/sharded.hh>
 #include <seastar/core/shared_ptr.hh>
+#include <seastar/core/smp.hh>
 #include <seastar/core/timed_out_error.hh>
 #include <seastar/core/with_timeout.hh>
 
@@ -119,6 +121,33 @@ public:
           });
     }
 
+    ss::future<heartbeat_reply> heartbeat_v2(
+      compact_heartbeat_request&& r, rpc::streaming_context& ctx) final {
+        return heartbeat(heartbeat_request{std::move(r.heartbeats)}, ctx);
+    }
+
+    ss::future<node_heartbeat_reply>
+    node_heartbeat(node_heartbeat_request&& r, rpc::streaming_context&) final {
+        node_heartbeat_reply reply{
+          .node_id = r.target_node_id, .incarnation = node_incarnation()};
+        const auto now = clock_type::now();
+        auto& liveness = local_node_liveness();
+        // every shard of the sender beats, they may land on any shard here.
+        // other shards are refreshed at most twice per heartbeat interval
+        const bool propagate = liveness.last_seen(r.node_id)
+                               < now - _heartbeat_interval / 2;
+        liveness.mark_alive(r.node_id, r.incarnation, now);
+        if (!propagate) {
+            return ss::make_ready_future<node_heartbeat_reply>(reply);
+        }
+        return ss::smp::invoke_on_others(
+                 ss::this_shard_id(),
+                 [n = r.node_id, incarnation = r.incarnation, now] {
+                     local_node_liveness().mark_alive(n, incarnation, now);
+                 })
+          .then([reply] { return reply; });
+    }
+
     [[gnu::always_inline]] ss::future<vote_reply>
     vote(vote_request&& r, rpc::streaming_context&) final {
         return _probe.vote().then([this, r = std::move(r)]() mutable {
@@ -158,6 +187,21 @@ public:
         });
     }
 
+    [[gnu::always_inline]] ss::future<install_snapshot_reply>
+    install_snapshot_v2(
+      install_snapshot_v2_request&& r, rpc::streaming_context&) final {
+        return _probe.install_snapshot().then([this,
+                                               r = std::move(r)]() mutable {
+            return dispatch_request(
+              install_snapshot_request_foreign_wrapper(std::move(r.request)),
+              &service::make_failed_install_snapshot_reply,
+              [crc = r.chunk_crc](
+                install_snapshot_request_foreign_wrapper&& r, consensus_ptr c) {
+                  return c->install_snapshot(r.copy(), crc);
+              });
+        });
+    }
+
     [[gnu::always_inline]] ss::future<timeout_now_reply>
     timeout_now(timeout_now_request&& r, rpc::streaming_context&) final {
         return _probe.timeout_now().then([this, r = std::move(r)]() mutable {
@@ -15,6 +15,8 @@
 #include "storage/log.h"
 #include "storage/record_batch_builder.h"
 
+#include <seastar/core/coroutine.hh>
+
 namespace raft {
 
 state_machine::state_machine(
@@ -61,26 +63,72 @@ model::offset state_machine::bootstrap_last_applied() const {
     return _bootstrap_last_applied;
 }
 
-state_machine::batch_applicator::batch_applicator(state_machine* machine)
-  : _machine(machine) {}
-
-ss::future<ss::stop_iteration>
-state_machine::batch_applicator::operator()(model::record_batch batch) {
-    if (_machine->stop_batch_applicator()) {
-        return ss::make_ready_future<ss::stop_iteration>(
-          ss::stop_iteration::yes);
+ss::future<> state_machine::apply_batches(
+  ss::circular_buffer<model::record_batch> batches) {
+    for (auto& b : batches) {
+        co_await apply(std::move(b));
     }
-
-    auto last_offset = batch.last_offset();
-    return _machine->apply(std::move(batch)).then([this, last_offset] {
-        _last_applied = last_offset;
-        _machine->_waiters.notify(_last_applied);
-        return ss::stop_iteration::no;
-    });
 }
 
 bool state_machine::stop_batch_applicator() { return _gate.is_closed(); }
 
+static ss::circular_buffer<model::record_batch>
+take_batches(model::record_batch_reader::storage_t slice) {
+    return ss::visit(
+      slice,
+      [](model::record_batch_reader::data_t& d) { return std::move(d); },
+      [](model::record_batch_reader::foreign_data_t& d) {
+          // batches of a foreign slice have to be copied
+          ss::circular_buffer<model::record_batch> ret;
+          ret.reserve(d.buffer->size() - d.index);
+          for (auto i = d.index; i < d.buffer->size(); ++i) {
+              ret.push_back((*d.buffer)[i].copy());
+          }
+          return ret;
+      });
+}
+
+ss::future<> state_machine::apply_from(model::record_batch_reader reader) {
+    using storage_t = model::record_batch_reader::storage_t;
+    auto rdr = std::move(reader).release();
+    std::optional<ss::future<storage_t>> next;
+    std::exception_ptr e;
+    try {
+        if (!rdr->is_end_of_stream()) {
+            next = rdr->do_load_slice(model::no_timeout);
+        }
+        while (next) {
+            auto batches = take_batches(co_await std::move(*next));
+            next.reset();
+            if (stop_batch_applicator()) {
+                break;
+            }
+            // read ahead the next slice while applying the current one
+            if (!rdr->is_end_of_stream()) {
+                next = rdr->do_load_slice(model::no_timeout);
+            }
+            if (batches.empty()) {
+                continue;
+            }
+            auto last_offset = batches.back().last_offset();
+            co_await apply_batches(std::move(batches));
+            _next = last_offset + model::offset(1);
+            _waiters.notify(last_offset);
+        }
+    } catch (...) {
+        e = std::current_exception();
+    }
+    if (next) {
+        // the read ahead slice is dropped, it is read again on retry
+        co_await std::move(*next).discard_result().handle_exception(
+          [](const std::exception_ptr&) {});
+    }
+    co_await rdr->finally();
+    if (e) {
+        std::rethrow_exception(e);
+    }
+}
+
 model::record_batch_reader make_checkpoint() {
     storage::record_batch_builder builder(
       model::record_batch_type::checkpoint, model::offset(0));
@@ -125,14 +173,7 @@ ss::future<> state_machine::apply() {
           });
       })
       .then([this](model::record_batch_reader reader) {
-          // apply each batch to the state machine
-          return std::move(reader)
-            .consume(batch_applicator(this), model::no_timeout)
-            .then([this](model::offset last_applied) {
-                if (last_applied >= model::offset(0)) {
-                    _next = last_applied + model::offset(1);
-                }
-            });
+          return apply_from(std::move(reader));
       })
       .handle_exception([this](const std::exception_ptr& e) {
           vlog(
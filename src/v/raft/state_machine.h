@@ -53,6 +53,12 @@ class consensus;
  * The state machine tracks which batches have been applied. Use the `wait`
  * primitive to wait until a particular log offset has been applied to the state
  * machine.
+ *
+ * Batches are read from the log in slices and handed to `apply_batches` a
+ * slice at a time. The next slice is read and decoded while the current one is
+ * being applied, so that replaying a long log is not bound by the sum of read
+ * and apply latencies. State machines that have per batch overhead which can
+ * be amortized over many batches should override `apply_batches`.
  */
 class state_machine {
 public:
@@ -72,6 +78,13 @@ public:
      * is returned an error is logged and the same batch will be applied again.
      */
     virtual ss::future<> apply(model::record_batch) = 0;
+    /**
+     * Applies consecutive batches of the log, in order. The default
+     * implementation calls `apply` for every batch. If an exceptional future
+     * is returned an error is logged and all of the batches are applied again.
+     */
+    virtual ss::future<>
+      apply_batches(ss::circular_buffer<model::record_batch>);
     /**
      * Return last applied offset established when STM starts. This can be used
      * to wait for the entries to be applied when STM is starting.
@@ -107,20 +120,8 @@ protected:
     ss::gate _gate;
 
 private:
-    class batch_applicator {
-    public:
-        explicit batch_applicator(state_machine*);
-        ss::future<ss::stop_iteration> operator()(model::record_batch);
-        model::offset end_of_stream() const { return _last_applied; }
-
-    private:
-        state_machine* _machine;
-        model::offset _last_applied;
-    };
-
-    friend batch_applicator;
-
     ss::future<> apply();
+    ss::future<> apply_from(model::record_batch_reader);
     bool stop_batch_applicator();
 
     ss::io_priority_class _io_prio;
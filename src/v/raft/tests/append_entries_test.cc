@@ -8,7 +8,9 @@
 // by the Apache License, Version 2.0
 
 #include "bytes/bytes.h"
+#include "bytes/utils.h"
 #include "finjector/hbadger.h"
+#include "hashing/crc32c.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
 #include "model/record.h"
@@ -25,6 +27,8 @@
 #include "storage/tests/utils/random_batch.h"
 #include "test_utils/async.h"
 
+#include <seastar/util/defer.hh>
+
 #include <system_error>
 
 FIXTURE_TEST(test_entries_are_replicated_to_all_nodes, raft_test_fixture) {
@@ -196,6 +200,58 @@ FIXTURE_TEST(test_single_node_recovery, raft_test_fixture) {
     validate_offset_translation(gr);
 };
 
+FIXTURE_TEST(test_pipelined_recovery, raft_test_fixture) {
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+    model::node_id disabled_id;
+    for (auto& [id, _] : gr.get_members()) {
+        if (leader_id != id) {
+            disabled_id = id;
+            gr.disable_node(id);
+            break;
+        }
+    }
+    // many times the recovery read buffer, recovery has to send multiple
+    // requests to the follower
+    for (int i = 0; i < 10; ++i) {
+        bool success = replicate_random_batches(
+                         gr,
+                         storage::test::record_batch_spec{
+                           .allow_compression = false,
+                           .count = 10,
+                           .records = 1,
+                           .record_sizes = std::vector<size_t>{64_KiB}})
+                         .get0();
+        BOOST_REQUIRE(success);
+    }
+
+    // nothing is replicated while the follower recovers, all the requests in
+    // flight are recovery requests
+    auto leader = get_leader_raft(gr);
+    bool recovered = false;
+    size_t max_in_flight = 0;
+    auto sampler = ss::do_until(
+      [&recovered] { return recovered; },
+      [&leader, &max_in_flight] {
+          max_in_flight = std::max(
+            max_in_flight, leader->append_entries_in_flight());
+          return ss::later();
+      });
+    gr.enable_node(disabled_id);
+
+    wait_for(
+      10s,
+      [this, &gr] { return are_all_commit_indexes_the_same(gr); },
+      "After recovery state is consistent");
+    recovered = true;
+    sampler.get();
+    BOOST_REQUIRE_GT(max_in_flight, size_t(1));
+
+    validate_logs_replication(gr);
+    validate_offset_translation(gr);
+};
+
 FIXTURE_TEST(test_empty_node_recovery, raft_test_fixture) {
     raft_group gr = raft_group(raft::group_id(0), 3);
     gr.enable_all();
@@ -612,6 +668,158 @@ FIXTURE_TEST(test_snapshot_recovery, raft_test_fixture) {
     validate_offset_translation(gr);
 };
 
+FIXTURE_TEST(test_snapshot_recovery_multiple_chunks, raft_test_fixture) {
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg()
+          .get("raft_install_snapshot_chunk_size")
+          .set_value(size_t(4_KiB));
+    }).get();
+    auto reset_chunk_size = ss::defer([] {
+        ss::smp::invoke_on_all([] {
+            config::shard_local_cfg()
+              .get("raft_install_snapshot_chunk_size")
+              .reset();
+        }).get();
+    });
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+    model::node_id disabled_id;
+    for (auto& [id, _] : gr.get_members()) {
+        // disable one of the non leader nodes
+        if (leader_id != id) {
+            disabled_id = id;
+            gr.disable_node(id);
+            break;
+        }
+    }
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+    validate_logs_replication(gr);
+
+    tests::cooperative_spin_wait_with_timeout(2s, [&gr] {
+        auto offset
+          = gr.get_members().begin()->second.consensus->committed_offset();
+        if (offset <= model::offset(0)) {
+            return false;
+        }
+        return are_all_commit_indexes_the_same(gr);
+    }).get0();
+
+    // snapshot spanning many chunks
+    const auto data = random_generators::get_bytes(64_KiB);
+    for (auto& [_, member] : gr.get_members()) {
+        member.consensus
+          ->write_snapshot(raft::write_snapshot_cfg(
+            get_leader_raft(gr)->committed_offset(), bytes_to_iobuf(data)))
+          .get0();
+    }
+    gr.enable_node(disabled_id);
+    success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    wait_for(
+      10s,
+      [this, &gr] { return are_all_commit_indexes_the_same(gr); },
+      "After recovery state is consistent");
+
+    validate_logs_replication(gr);
+    validate_offset_translation(gr);
+};
+
+/*
+ * sends snapshot chunks to a follower the way the leader does
+ */
+struct snapshot_chunk_sender {
+    consensus_ptr leader;
+    consensus_ptr follower;
+    model::offset last_included_index{100};
+
+    raft::install_snapshot_reply
+    send(uint64_t offset, const bytes& chunk, bool corrupt = false) {
+        auto data = bytes_to_iobuf(chunk);
+        crc::crc32c crc;
+        crc_extend_iobuf(crc, data);
+        return follower
+          ->install_snapshot(
+            raft::install_snapshot_request{
+              .target_node_id = follower->self(),
+              .term = leader->term(),
+              .group = follower->group(),
+              .node_id = leader->self(),
+              .last_included_index = last_included_index,
+              .file_offset = offset,
+              .chunk = std::move(data),
+              .done = false},
+            corrupt ? crc.value() + 1 : crc.value())
+          .get0();
+    }
+};
+
+static snapshot_chunk_sender
+make_chunk_sender(raft_test_fixture& f, raft_group& gr) {
+    auto leader_id = wait_for_group_leader(gr);
+    auto& members = gr.get_members();
+    auto it = std::find_if(
+      members.begin(), members.end(), [leader_id](const auto& m) {
+          return m.first != leader_id;
+      });
+    BOOST_REQUIRE(it != members.end());
+    return snapshot_chunk_sender{
+      .leader = f.get_leader_raft(gr), .follower = it->second.consensus};
+}
+
+FIXTURE_TEST(test_snapshot_chunk_checksum_mismatch, raft_test_fixture) {
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto sender = make_chunk_sender(*this, gr);
+    const auto chunk = random_generators::get_bytes(4_KiB);
+
+    auto reply = sender.send(0, chunk);
+    BOOST_REQUIRE(reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 4_KiB);
+
+    // a corrupted chunk is rejected, the follower reports the bytes it kept
+    reply = sender.send(4_KiB, chunk, true);
+    BOOST_REQUIRE(!reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 4_KiB);
+
+    // and the leader sends the chunk again from there
+    reply = sender.send(4_KiB, chunk);
+    BOOST_REQUIRE(reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 8_KiB);
+}
+
+FIXTURE_TEST(test_snapshot_transfer_resumes_after_failure, raft_test_fixture) {
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto sender = make_chunk_sender(*this, gr);
+    const auto chunk = random_generators::get_bytes(4_KiB);
+
+    BOOST_REQUIRE(sender.send(0, chunk).success);
+    BOOST_REQUIRE(sender.send(4_KiB, chunk).success);
+
+    // the leader lost the reply to the last chunk and sends it again
+    auto reply = sender.send(4_KiB, chunk);
+    BOOST_REQUIRE(!reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 8_KiB);
+
+    // a new recovery starts the same snapshot over, the follower keeps the
+    // partial snapshot and the leader resumes from its end
+    reply = sender.send(0, chunk);
+    BOOST_REQUIRE(!reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 8_KiB);
+    reply = sender.send(8_KiB, chunk);
+    BOOST_REQUIRE(reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 12_KiB);
+
+    // a different snapshot replaces the partial one
+    sender.last_included_index = model::offset(200);
+    reply = sender.send(0, chunk);
+    BOOST_REQUIRE(reply.success);
+    BOOST_REQUIRE_EQUAL(reply.bytes_stored, 4_KiB);
+}
+
 FIXTURE_TEST(test_snapshot_recovery_last_config, raft_test_fixture) {
     raft_group gr = raft_group(raft::group_id(0), 3);
     gr.enable_all();
@@ -0,0 +1,168 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/property.h"
+#include "model/fundamental.h"
+#include "raft/group_commit.h"
+#include "seastarx.h"
+#include "storage/log.h"
+
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+/*
+ * log that only counts its flushes, group commit does not use anything else
+ */
+class flush_counting_log final : public storage::log::impl {
+public:
+    explicit flush_counting_log(model::ntp ntp)
+      : storage::log::impl(storage::ntp_config(std::move(ntp), "test")) {}
+
+    ss::future<> flush() final {
+        ++flushes;
+        if (fail) {
+            return ss::make_exception_future<>(
+              std::runtime_error("flush failed"));
+        }
+        return ss::now();
+    }
+
+    ss::future<> compact(storage::compaction_config) final {
+        return ss::now();
+    }
+    ss::future<> truncate(storage::truncate_config) final {
+        return ss::now();
+    }
+    ss::future<> truncate_prefix(storage::truncate_prefix_config) final {
+        return ss::now();
+    }
+    ss::future<model::record_batch_reader>
+    make_reader(storage::log_reader_config) final {
+        return ss::make_exception_future<model::record_batch_reader>(
+          std::logic_error("not supported"));
+    }
+    storage::log_appender make_appender(storage::log_append_config) final {
+        throw std::logic_error("not supported");
+    }
+    ss::future<> close() final { return ss::now(); }
+    ss::future<> remove() final { return ss::now(); }
+    ss::future<std::optional<storage::timequery_result>>
+    timequery(storage::timequery_config) final {
+        return ss::make_ready_future<std::optional<storage::timequery_result>>(
+          std::nullopt);
+    }
+    size_t segment_count() const final { return 0; }
+    storage::offset_stats offsets() const final { return {}; }
+    std::ostream& print(std::ostream& o) const final {
+        return o << "flush_counting_log";
+    }
+    std::optional<model::term_id> get_term(model::offset) const final {
+        return std::nullopt;
+    }
+    std::optional<model::offset>
+    get_term_last_offset(model::term_id) const final {
+        return std::nullopt;
+    }
+    ss::future<model::offset> monitor_eviction(ss::abort_source&) final {
+        return ss::make_exception_future<model::offset>(
+          std::logic_error("not supported"));
+    }
+    void set_collectible_offset(model::offset) final {}
+    size_t size_bytes() const final { return 0; }
+    ss::future<>
+    update_configuration(storage::ntp_config::default_overrides) final {
+        return ss::now();
+    }
+    int64_t compaction_backlog() const final { return 0; }
+
+    size_t flushes{0};
+    bool fail{false};
+};
+
+static ss::shared_ptr<flush_counting_log> make_log(int partition) {
+    return ss::make_shared<flush_counting_log>(model::ntp(
+      model::ns("test"), model::topic("tp"), model::partition_id(partition)));
+}
+
+SEASTAR_THREAD_TEST_CASE(zero_window_flushes_per_request) {
+    raft::group_commit gc(config::mock_binding<uint32_t>(0));
+    auto log = make_log(0);
+
+    // every request flushes the log right away, even while other groups
+    // append
+    auto guard = gc.start_append();
+    auto f0 = gc.flush(storage::log(log));
+    BOOST_REQUIRE(f0.available());
+    auto f1 = gc.flush(storage::log(log));
+    BOOST_REQUIRE(f1.available());
+    f0.get();
+    f1.get();
+    BOOST_REQUIRE_EQUAL(log->flushes, size_t(2));
+    gc.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(window_groups_flushes_of_a_log) {
+    raft::group_commit gc(config::mock_binding<uint32_t>(1000));
+    auto log = make_log(0);
+    auto other = make_log(1);
+
+    auto f0 = gc.flush(storage::log(log));
+    auto f1 = gc.flush(storage::log(log));
+    auto f2 = gc.flush(storage::log(other));
+    BOOST_REQUIRE(!f0.available());
+    f0.get();
+    f1.get();
+    f2.get();
+    BOOST_REQUIRE_EQUAL(log->flushes, size_t(1));
+    BOOST_REQUIRE_EQUAL(other->flushes, size_t(1));
+    gc.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(append_guard_holds_flush_until_released) {
+    // the window outlasts the test, only the appends dispatch the round
+    raft::group_commit gc(config::mock_binding<uint32_t>(60'000'000));
+    auto log = make_log(0);
+
+    std::optional<raft::group_commit::append_guard> guard;
+    guard.emplace(gc.start_append());
+    auto f = gc.flush(storage::log(log));
+    ss::sleep(10ms).get();
+    BOOST_REQUIRE(!f.available());
+    BOOST_REQUIRE_EQUAL(log->flushes, size_t(0));
+
+    // an append started after the round was opened does not hold it
+    auto later = gc.start_append();
+    guard.reset();
+    f.get();
+    BOOST_REQUIRE_EQUAL(log->flushes, size_t(1));
+    gc.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(flush_error_fails_all_waiters) {
+    raft::group_commit gc(config::mock_binding<uint32_t>(1000));
+    auto failing = make_log(0);
+    failing->fail = true;
+    auto log = make_log(1);
+
+    auto f0 = gc.flush(storage::log(failing));
+    auto f1 = gc.flush(storage::log(failing));
+    auto f2 = gc.flush(storage::log(log));
+    BOOST_REQUIRE_THROW(f0.get(), std::runtime_error);
+    BOOST_REQUIRE_THROW(f1.get(), std::runtime_error);
+    // other logs of the round are not affected
+    BOOST_REQUIRE_NO_THROW(f2.get());
+    BOOST_REQUIRE_EQUAL(failing->flushes, size_t(1));
+    gc.stop().get();
+}
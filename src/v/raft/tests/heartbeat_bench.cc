@@ -0,0 +1,149 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/types.h"
+#include "random/generators.h"
+#include "reflection/async_adl.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/testing/perf_tests.hh>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Compares the size and the encoding/decoding cost of the heartbeat_request
+ * and compact_heartbeat_request wire formats for a node pair sharing `Groups`
+ * raft groups, `Idle` percent of which are idle with up to date followers.
+ */
+template<size_t Groups, int Idle>
+struct heartbeat_bench {
+    heartbeat_bench() {
+        for (size_t i = 0; i < Groups; ++i) {
+            raft::heartbeat_metadata hb;
+            const auto revision = model::revision_id(
+              random_generators::get_int(0, 100000));
+            hb.node_id = raft::vnode(model::node_id(1), revision);
+            hb.target_node_id = raft::vnode(model::node_id(2), revision);
+            hb.meta.group = raft::group_id(i);
+            hb.meta.term = model::term_id(random_generators::get_int(1, 20));
+            hb.meta.commit_index = model::offset(
+              random_generators::get_int(0, 100000000));
+            hb.meta.prev_log_index = hb.meta.commit_index;
+            hb.meta.last_visible_index = hb.meta.commit_index;
+            hb.meta.prev_log_term = hb.meta.term;
+            if (random_generators::get_int(0, 99) >= Idle) {
+                hb.meta.prev_log_index += model::offset(
+                  random_generators::get_int(1, 1000));
+                hb.meta.last_visible_index = hb.meta.prev_log_index;
+            }
+            heartbeats.push_back(hb);
+        }
+        std::shuffle(
+          heartbeats.begin(), heartbeats.end(), random_generators::internal::gen);
+    }
+
+    ~heartbeat_bench() {
+        fmt::print(
+          "{} groups, {}% idle: heartbeat_request {} bytes, "
+          "compact_heartbeat_request {} bytes\n",
+          Groups,
+          Idle,
+          encoded_bytes<raft::heartbeat_request>(),
+          encoded_bytes<raft::compact_heartbeat_request>());
+    }
+
+    template<typename Request>
+    static ss::future<iobuf> encode(Request r) {
+        iobuf out;
+        co_await reflection::async_adl<Request>{}.to(out, std::move(r));
+        co_return out;
+    }
+
+    template<typename Request>
+    ss::future<size_t> run_encode() {
+        Request r{heartbeats};
+        perf_tests::start_measuring_time();
+        auto out = co_await encode(std::move(r));
+        perf_tests::do_not_optimize(out);
+        perf_tests::stop_measuring_time();
+        encoded_bytes<Request>() = out.size_bytes();
+        co_return Groups;
+    }
+
+    template<typename Request>
+    ss::future<size_t> run_decode() {
+        auto in = co_await encode(Request{heartbeats});
+        iobuf_parser parser(std::move(in));
+        perf_tests::start_measuring_time();
+        auto r = co_await reflection::async_adl<Request>{}.from(parser);
+        perf_tests::do_not_optimize(r);
+        perf_tests::stop_measuring_time();
+        co_return Groups;
+    }
+
+    template<typename Request>
+    size_t& encoded_bytes() {
+        if constexpr (std::is_same_v<Request, raft::heartbeat_request>) {
+            return v1_bytes;
+        } else {
+            return compact_bytes;
+        }
+    }
+
+    std::vector<raft::heartbeat_metadata> heartbeats;
+    size_t v1_bytes{0};
+    size_t compact_bytes{0};
+};
+
+using hbeat_10k_idle = heartbeat_bench<10000, 95>;
+using hbeat_50k_idle = heartbeat_bench<50000, 95>;
+using hbeat_50k_busy = heartbeat_bench<50000, 20>;
+
+PERF_TEST_F(hbeat_10k_idle, encode_v1) {
+    return run_encode<raft::heartbeat_request>();
+}
+PERF_TEST_F(hbeat_10k_idle, encode_compact) {
+    return run_encode<raft::compact_heartbeat_request>();
+}
+PERF_TEST_F(hbeat_10k_idle, decode_v1) {
+    return run_decode<raft::heartbeat_request>();
+}
+PERF_TEST_F(hbeat_10k_idle, decode_compact) {
+    return run_decode<raft::compact_heartbeat_request>();
+}
+
+PERF_TEST_F(hbeat_50k_idle, encode_v1) {
+    return run_encode<raft::heartbeat_request>();
+}
+PERF_TEST_F(hbeat_50k_idle, encode_compact) {
+    return run_encode<raft::compact_heartbeat_request>();
+}
+PERF_TEST_F(hbeat_50k_idle, decode_v1) {
+    return run_decode<raft::heartbeat_request>();
+}
+PERF_TEST_F(hbeat_50k_idle, decode_compact) {
+    return run_decode<raft::compact_heartbeat_request>();
+}
+
+PERF_TEST_F(hbeat_50k_busy, encode_v1) {
+    return run_encode<raft::heartbeat_request>();
+}
+PERF_TEST_F(hbeat_50k_busy, encode_compact) {
+    return run_encode<raft::compact_heartbeat_request>();
+}
+PERF_TEST_F(hbeat_50k_busy, decode_v1) {
+    return run_decode<raft::heartbeat_request>();
+}
+PERF_TEST_F(hbeat_50k_busy, decode_compact) {
+    return run_decode<raft::compact_heartbeat_request>();
+}
@@ -0,0 +1,56 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/node_liveness.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace std::chrono_literals; // NOLINT
+
+SEASTAR_THREAD_TEST_CASE(node_liveness_unknown_node) {
+    raft::node_liveness l;
+    BOOST_CHECK(
+      l.last_seen(model::node_id(1)) == raft::clock_type::time_point::min());
+    BOOST_CHECK(
+      l.last_seen(model::node_id(1), raft::clock_type::now())
+      == raft::clock_type::time_point::min());
+}
+
+SEASTAR_THREAD_TEST_CASE(node_liveness_same_incarnation) {
+    raft::node_liveness l;
+    const auto t0 = raft::clock_type::now();
+    l.mark_alive(model::node_id(1), 10, t0);
+    l.mark_alive(model::node_id(1), 10, t0 + 1s);
+    l.mark_alive(model::node_id(2), 20, t0 + 2s);
+
+    BOOST_CHECK(l.last_seen(model::node_id(1)) == t0 + 1s);
+    // quiescent since after the incarnation started
+    BOOST_CHECK(l.last_seen(model::node_id(1), t0 + 500ms) == t0 + 1s);
+    BOOST_CHECK(l.last_seen(model::node_id(2), t0 + 2s) == t0 + 2s);
+    // quiescent since before the incarnation was first seen
+    BOOST_CHECK(
+      l.last_seen(model::node_id(2), t0 + 1s)
+      == raft::clock_type::time_point::min());
+}
+
+SEASTAR_THREAD_TEST_CASE(node_liveness_restarted_node) {
+    raft::node_liveness l;
+    const auto t0 = raft::clock_type::now();
+    l.mark_alive(model::node_id(1), 10, t0);
+    // groups that became quiescent with the old incarnation do not trust
+    // beats of the new one
+    l.mark_alive(model::node_id(1), 11, t0 + 2s);
+    BOOST_CHECK(
+      l.last_seen(model::node_id(1), t0 + 1s)
+      == raft::clock_type::time_point::min());
+    BOOST_CHECK(l.last_seen(model::node_id(1), t0 + 3s) == t0 + 2s);
+    BOOST_CHECK(l.last_seen(model::node_id(1)) == t0 + 2s);
+}
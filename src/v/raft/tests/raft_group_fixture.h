@@ -160,7 +160,8 @@ struct raft_node {
           [this](raft::leadership_status st) { leader_callback(st); },
           storage.local(),
           recovery_throttle.local(),
-          recovery_mem_quota);
+          recovery_mem_quota,
+          std::nullopt);
 
         // create connections to initial nodes
         consensus->config().for_each_broker(
@@ -752,6 +753,26 @@ static ss::future<bool> replicate_random_batches(
       });
 }
 
+static ss::future<bool> replicate_random_batches(
+  raft_group& gr,
+  storage::test::record_batch_spec spec,
+  raft::consistency_level c_lvl = raft::consistency_level::quorum_ack,
+  model::timeout_clock::duration tout = 1s) {
+    return retry_with_leader(
+      gr, 5, tout, [spec, c_lvl](raft_node& leader_node) {
+          auto rdr = random_batches_reader(spec);
+          raft::replicate_options opts(c_lvl);
+
+          return leader_node.consensus->replicate(std::move(rdr), opts)
+            .then([](result<raft::replicate_result> res) {
+                if (!res) {
+                    return false;
+                }
+                return true;
+            });
+      });
+}
+
 static ss::future<bool> replicate_random_batches(
   model::term_id expected_term,
   raft_group& gr,
@@ -0,0 +1,130 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/property.h"
+#include "raft/recovery_memory_quota.h"
+#include "raft/recovery_read_cache.h"
+#include "storage/tests/utils/random_batch.h"
+#include "units.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+raft::recovery_memory_quota make_quota(size_t max_memory) {
+    return raft::recovery_memory_quota([max_memory] {
+        return raft::recovery_memory_quota::configuration{
+          .max_recovery_memory = config::mock_binding<std::optional<size_t>>(
+            max_memory),
+          .default_read_buffer_size = config::mock_binding<size_t>(32_KiB),
+        };
+    });
+}
+
+size_t size_bytes(const ss::circular_buffer<model::record_batch>& batches) {
+    size_t ret = 0;
+    for (const auto& b : batches) {
+        ret += b.size_bytes();
+    }
+    return ret;
+}
+
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(recovery_read_cache_hit_and_miss) {
+    auto quota = make_quota(32_MiB);
+    auto& cache = quota.read_cache();
+    const auto group = raft::group_id(1);
+    const auto term = model::term_id(2);
+
+    auto batches = storage::test::make_random_batches(model::offset(0), 10);
+    const auto last = batches.back().last_offset();
+    cache.put(group, term, batches);
+    BOOST_REQUIRE_EQUAL(cache.cached_bytes(), size_bytes(batches));
+
+    // from the start of the range
+    auto all = cache.get(group, term, model::offset(0), 32_MiB);
+    BOOST_REQUIRE(all);
+    BOOST_REQUIRE_EQUAL(all->size(), batches.size());
+    BOOST_REQUIRE_EQUAL(all->back().last_offset(), last);
+
+    // from a batch in the middle of the range
+    const auto start = batches[5].base_offset();
+    auto tail = cache.get(group, term, start, 32_MiB);
+    BOOST_REQUIRE(tail);
+    BOOST_REQUIRE_EQUAL(tail->front().base_offset(), start);
+
+    // at least one batch is returned
+    auto one = cache.get(group, term, start, 1);
+    BOOST_REQUIRE(one);
+    BOOST_REQUIRE_EQUAL(one->size(), 1);
+
+    // past the end, other group
+    BOOST_REQUIRE(!cache.get(group, term, last + model::offset(1), 32_MiB));
+    BOOST_REQUIRE(
+      !cache.get(raft::group_id(2), term, model::offset(0), 32_MiB));
+}
+
+SEASTAR_THREAD_TEST_CASE(recovery_read_cache_term_change) {
+    auto quota = make_quota(32_MiB);
+    auto& cache = quota.read_cache();
+    const auto group = raft::group_id(1);
+
+    auto batches = storage::test::make_random_batches(model::offset(0), 10);
+    cache.put(group, model::term_id(1), batches);
+    BOOST_REQUIRE(!cache.get(group, model::term_id(2), model::offset(0), 1_MiB));
+    BOOST_REQUIRE_EQUAL(cache.cached_bytes(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(recovery_read_cache_overlapping_ranges) {
+    auto quota = make_quota(32_MiB);
+    auto& cache = quota.read_cache();
+    const auto group = raft::group_id(1);
+    const auto term = model::term_id(1);
+
+    auto batches = storage::test::make_random_batches(model::offset(0), 10);
+    cache.put(group, term, batches);
+    const auto cached = cache.cached_bytes();
+
+    ss::circular_buffer<model::record_batch> tail;
+    for (size_t i = 5; i < batches.size(); ++i) {
+        tail.push_back(batches[i].share());
+    }
+    cache.put(group, term, tail);
+    BOOST_REQUIRE_EQUAL(cache.cached_bytes(), cached);
+}
+
+SEASTAR_THREAD_TEST_CASE(recovery_read_cache_yields_memory_to_reads) {
+    auto quota = make_quota(32_MiB);
+    auto& cache = quota.read_cache();
+    const auto term = model::term_id(1);
+
+    // fill the half of the quota available for caching
+    for (int g = 0;; ++g) {
+        auto batches = storage::test::make_random_batches(
+          model::offset(0), 10, false);
+        if (cache.cached_bytes() + size_bytes(batches) > 16_MiB) {
+            break;
+        }
+        cache.put(raft::group_id(g), term, batches);
+    }
+    const auto cached = cache.cached_bytes();
+    BOOST_REQUIRE_GT(cached, 0);
+
+    // take all the memory that is left for reads, the next read evicts
+    std::vector<ss::semaphore_units<>> units;
+    for (size_t i = 0; i < (32_MiB - cached) / 32_KiB; ++i) {
+        units.push_back(quota.acquire_read_memory().get0());
+    }
+    BOOST_REQUIRE_EQUAL(cache.cached_bytes(), cached);
+    units.push_back(quota.acquire_read_memory().get0());
+    BOOST_REQUIRE_LT(cache.cached_bytes(), cached);
+}
@@ -0,0 +1,79 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "model/fundamental.h"
+#include "model/record_batch_reader.h"
+#include "raft/state_machine.h"
+#include "raft/tests/mux_state_machine_fixture.h"
+#include "raft/types.h"
+#include "storage/record_batch_builder.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/util/log.hh>
+
+static ss::logger bench_log("stm-replay-bench");
+
+/*
+ * Replays a log of one million small batches into a state machine that only
+ * counts the records, e.g. what a restarted node does before its rm_stm or
+ * controller state machines are up to date. The time reported per run is the
+ * time per applied batch.
+ */
+struct counting_stm final : public raft::state_machine {
+    explicit counting_stm(raft::consensus* c)
+      : raft::state_machine(c, bench_log, ss::default_priority_class()) {}
+
+    ss::future<> apply(model::record_batch b) final {
+        records += b.record_count();
+        return ss::now();
+    }
+
+    size_t records{0};
+};
+
+struct stm_replay_bench : mux_state_machine_fixture {
+    static constexpr size_t batch_count = 1'000'000;
+    static constexpr size_t batches_per_replicate = 1000;
+
+    stm_replay_bench() {
+        start_raft();
+        wait_for_leader();
+        for (size_t i = 0; i < batch_count / batches_per_replicate; ++i) {
+            ss::circular_buffer<model::record_batch> batches;
+            for (size_t j = 0; j < batches_per_replicate; ++j) {
+                storage::record_batch_builder builder(
+                  model::record_batch_type::raft_data, model::offset(0));
+                builder.add_raw_kv(iobuf(), iobuf());
+                batches.push_back(std::move(builder).build());
+            }
+            _raft
+              ->replicate(
+                model::make_memory_record_batch_reader(std::move(batches)),
+                raft::replicate_options(raft::consistency_level::quorum_ack))
+              .get();
+        }
+        last_offset = _raft->committed_offset();
+    }
+
+    ss::future<size_t> replay() {
+        counting_stm stm(_raft.get());
+        perf_tests::start_measuring_time();
+        co_await stm.start();
+        co_await stm.wait(last_offset, model::no_timeout);
+        perf_tests::stop_measuring_time();
+        co_await stm.stop();
+        co_return batch_count;
+    }
+
+    model::offset last_offset;
+};
+
+PERF_TEST_F(stm_replay_bench, replay) { return replay(); }
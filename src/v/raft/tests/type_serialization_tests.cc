@@ -7,6 +7,7 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "bytes/bytes.h"
 #include "compression/stream_zstd.h"
 #include "model/metadata.h"
 #include "model/record.h"
@@ -21,6 +22,7 @@
 #include "storage/tests/utils/random_batch.h"
 #include "test_utils/randoms.h"
 #include "test_utils/rpc.h"
+#include "units.h"
 
 #include <seastar/core/future.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -29,6 +31,7 @@
 #include <boost/test/tools/old/interface.hpp>
 #include <boost/test/unit_test_log.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -204,6 +207,109 @@ SEASTAR_THREAD_TEST_CASE(heartbeat_request_roundtrip_with_negative) {
           raft::vnode(model::node_id(0), model::revision_id{}));
     }
 }
+raft::heartbeat_request random_heartbeats(size_t count) {
+    auto offset = [] {
+        return model::offset(random_generators::get_int(-2, 1000000));
+    };
+    auto term = [] {
+        return model::term_id(random_generators::get_int(-2, 10));
+    };
+    auto revision = [] {
+        return model::revision_id(random_generators::get_int(-2, 100));
+    };
+    raft::heartbeat_request req;
+    for (size_t i = 0; i < count; ++i) {
+        raft::heartbeat_metadata hb;
+        hb.meta.group = raft::group_id(i * 3);
+        hb.meta.term = term();
+        hb.meta.commit_index = offset();
+        // idle and up to date followers have all offsets equal
+        if (i % 3 == 0) {
+            hb.meta.prev_log_index = offset();
+            hb.meta.last_visible_index = offset();
+            hb.meta.prev_log_term = term();
+        } else {
+            hb.meta.prev_log_index = hb.meta.commit_index;
+            hb.meta.last_visible_index = hb.meta.commit_index;
+            hb.meta.prev_log_term = hb.meta.term;
+        }
+        hb.node_id = raft::vnode(model::node_id(1), revision());
+        hb.target_node_id = raft::vnode(
+          model::node_id(2), i % 7 == 0 ? revision() : hb.node_id.revision());
+        req.heartbeats.push_back(hb);
+    }
+    std::shuffle(
+      req.heartbeats.begin(),
+      req.heartbeats.end(),
+      random_generators::internal::gen);
+    return req;
+}
+
+SEASTAR_THREAD_TEST_CASE(compact_heartbeat_request_decodes_as_v1) {
+    static constexpr size_t count = 5000;
+    auto req = random_heartbeats(count);
+
+    iobuf v1_buf;
+    reflection::async_adl<raft::heartbeat_request>{}
+      .to(v1_buf, raft::heartbeat_request{req.heartbeats})
+      .get();
+    iobuf v2_buf;
+    reflection::async_adl<raft::compact_heartbeat_request>{}
+      .to(v2_buf, raft::compact_heartbeat_request{req.heartbeats})
+      .get();
+    BOOST_TEST_MESSAGE(
+      "v1 size: " << v1_buf.size_bytes()
+                  << ", compact size: " << v2_buf.size_bytes());
+    BOOST_REQUIRE_LT(v2_buf.size_bytes(), v1_buf.size_bytes());
+
+    auto v1_parser = iobuf_parser(std::move(v1_buf));
+    auto v1 = reflection::async_adl<raft::heartbeat_request>{}
+                .from(v1_parser)
+                .get0();
+    auto v2_parser = iobuf_parser(std::move(v2_buf));
+    auto v2 = reflection::async_adl<raft::compact_heartbeat_request>{}
+                .from(v2_parser)
+                .get0();
+    BOOST_REQUIRE_EQUAL(v2_parser.bytes_left(), 0);
+
+    auto by_group = [](const auto& lhs, const auto& rhs) {
+        return lhs.meta.group < rhs.meta.group;
+    };
+    std::sort(v1.heartbeats.begin(), v1.heartbeats.end(), by_group);
+    BOOST_REQUIRE(std::is_sorted(
+      v2.heartbeats.begin(), v2.heartbeats.end(), by_group));
+    BOOST_REQUIRE_EQUAL(v1.heartbeats.size(), v2.heartbeats.size());
+    for (size_t i = 0; i < count; ++i) {
+        const auto& expected = v1.heartbeats[i];
+        const auto& actual = v2.heartbeats[i];
+        BOOST_REQUIRE_EQUAL(actual.meta.group, expected.meta.group);
+        BOOST_REQUIRE_EQUAL(
+          actual.meta.commit_index, expected.meta.commit_index);
+        BOOST_REQUIRE_EQUAL(actual.meta.term, expected.meta.term);
+        BOOST_REQUIRE_EQUAL(
+          actual.meta.prev_log_index, expected.meta.prev_log_index);
+        BOOST_REQUIRE_EQUAL(
+          actual.meta.prev_log_term, expected.meta.prev_log_term);
+        BOOST_REQUIRE_EQUAL(
+          actual.meta.last_visible_index, expected.meta.last_visible_index);
+        BOOST_REQUIRE_EQUAL(actual.node_id, expected.node_id);
+        BOOST_REQUIRE_EQUAL(actual.target_node_id, expected.target_node_id);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(compact_heartbeat_request_empty) {
+    iobuf buf;
+    reflection::async_adl<raft::compact_heartbeat_request>{}
+      .to(buf, raft::compact_heartbeat_request{})
+      .get();
+    auto parser = iobuf_parser(std::move(buf));
+    auto res = reflection::async_adl<raft::compact_heartbeat_request>{}
+                 .from(parser)
+                 .get0();
+    BOOST_REQUIRE(res.heartbeats.empty());
+    BOOST_REQUIRE_EQUAL(parser.bytes_left(), 0);
+}
+
 SEASTAR_THREAD_TEST_CASE(heartbeat_response_roundtrip) {
     static constexpr int64_t group_count = 10000;
     raft::heartbeat_reply reply;
@@ -363,3 +469,33 @@ SEASTAR_THREAD_TEST_CASE(snapshot_metadata_backward_compatibility) {
     BOOST_REQUIRE_EQUAL(
       metadata.log_start_delta, raft::offset_translator_delta{});
 }
+
+SEASTAR_THREAD_TEST_CASE(install_snapshot_v2_request_roundtrip) {
+    auto chunk = bytes_to_iobuf(random_generators::get_bytes(4_KiB));
+    raft::install_snapshot_v2_request req{
+      .request = raft::install_snapshot_request{
+        .target_node_id = raft::vnode(model::node_id(1), model::revision_id(2)),
+        .term = model::term_id(3),
+        .group = raft::group_id(4),
+        .node_id = raft::vnode(model::node_id(5), model::revision_id(6)),
+        .last_included_index = model::offset(7),
+        .file_offset = 8_KiB,
+        .chunk = chunk.copy(),
+        .done = true},
+      .chunk_crc = 42};
+
+    auto d = serialize_roundtrip_rpc(std::move(req));
+
+    BOOST_REQUIRE_EQUAL(d.chunk_crc, 42);
+    BOOST_REQUIRE_EQUAL(
+      d.request.target_node_id,
+      raft::vnode(model::node_id(1), model::revision_id(2)));
+    BOOST_REQUIRE_EQUAL(d.request.term, model::term_id(3));
+    BOOST_REQUIRE_EQUAL(d.request.group, raft::group_id(4));
+    BOOST_REQUIRE_EQUAL(
+      d.request.node_id, raft::vnode(model::node_id(5), model::revision_id(6)));
+    BOOST_REQUIRE_EQUAL(d.request.last_included_index, model::offset(7));
+    BOOST_REQUIRE_EQUAL(d.request.file_offset, 8_KiB);
+    BOOST_REQUIRE(d.request.chunk == chunk);
+    BOOST_REQUIRE(d.request.done);
+}
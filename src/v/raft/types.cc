@@ -75,6 +75,9 @@ std::ostream& operator<<(std::ostream& o, const heartbeat_request& r) {
     }
     return o << "]}";
 }
+std::ostream& operator<<(std::ostream& o, const compact_heartbeat_request& r) {
+    return o << "{compact heartbeats:(" << r.heartbeats.size() << ")}";
+}
 std::ostream& operator<<(std::ostream& o, const heartbeat_reply& r) {
     o << "{meta:[";
     for (auto& m : r.meta) {
@@ -487,6 +490,189 @@ async_adl<raft::heartbeat_request>::from(iobuf_parser& in) {
     return ss::make_ready_future<raft::heartbeat_request>(std::move(req));
 }
 
+namespace internal {
+/// appends a vint without the intermediate allocation of vint::to_bytes
+inline void append_vint(iobuf& out, int64_t v) {
+    std::array<uint8_t, vint::max_length> staging{};
+    auto sz = vint::serialize(v, staging.data());
+    // NOLINTNEXTLINE
+    out.append(reinterpret_cast<const char*>(staging.data()), sz);
+}
+
+/// writes a bitmap with the entries of `values` equal to the corresponding
+/// entry of `refs`, followed by the delta from the reference of every other
+/// entry
+template<typename T>
+void encode_against_refs(
+  iobuf& out, const std::vector<T>& values, const std::vector<T>& refs) {
+    std::vector<uint8_t> same((values.size() + 7) / 8, 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] == refs[i]) {
+            same[i / 8] |= uint8_t(1) << (i % 8);
+        }
+    }
+    // NOLINTNEXTLINE
+    out.append(reinterpret_cast<const char*>(same.data()), same.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] != refs[i]) {
+            append_vint(out, values[i]() - refs[i]());
+        }
+    }
+}
+
+/// reverse of encode_against_refs, `get_ref(i)` and `set(i, value)` access
+/// the i-th reference and decoded value
+template<typename T, typename RefFn, typename SetFn>
+void decode_against_refs(
+  iobuf_parser& in, size_t size, RefFn&& get_ref, SetFn&& set) {
+    std::vector<uint8_t> same((size + 7) / 8, 0);
+    in.consume_to(same.size(), same.data());
+    for (size_t i = 0; i < size; ++i) {
+        const T ref = get_ref(i);
+        if (same[i / 8] & (uint8_t(1) << (i % 8))) {
+            set(i, ref);
+        } else {
+            set(i, ref + varlong_reader<T>(in));
+        }
+    }
+}
+} // namespace internal
+
+ss::future<> async_adl<raft::compact_heartbeat_request>::to(
+  iobuf& out, raft::compact_heartbeat_request&& request) {
+    const size_t size = request.heartbeats.size();
+    adl<uint32_t>{}.to(out, size);
+    if (size == 0) {
+        return ss::now();
+    }
+    std::sort(
+      request.heartbeats.begin(),
+      request.heartbeats.end(),
+      [](const raft::heartbeat_metadata& lhs,
+         const raft::heartbeat_metadata& rhs) {
+          return lhs.meta.group < rhs.meta.group;
+      });
+    // physical node ids are the same for all requests
+    adl<model::node_id>{}.to(out, request.heartbeats.front().node_id.id());
+    adl<model::node_id>{}.to(
+      out, request.heartbeats.front().target_node_id.id());
+
+    internal::hbeat_soa encodee(size);
+    for (size_t i = 0; i < size; ++i) {
+        const auto& hb = request.heartbeats[i];
+        vassert(
+          hb.meta.group() >= 0,
+          "Negative raft group detected. {}",
+          hb.meta.group);
+        encodee.groups[i] = hb.meta.group;
+        encodee.commit_indices[i] = std::max(
+          model::offset(-1), hb.meta.commit_index);
+        encodee.terms[i] = std::max(model::term_id(-1), hb.meta.term);
+        encodee.prev_log_indices[i] = std::max(
+          model::offset(-1), hb.meta.prev_log_index);
+        encodee.prev_log_terms[i] = std::max(
+          model::term_id(-1), hb.meta.prev_log_term);
+        encodee.last_visible_indices[i] = std::max(
+          model::offset(-1), hb.meta.last_visible_index);
+        encodee.revisions[i] = std::max(
+          model::revision_id(-1), hb.node_id.revision());
+        encodee.target_revisions[i] = std::max(
+          model::revision_id(-1), hb.target_node_id.revision());
+    }
+    request.heartbeats = {};
+
+    // sorted, the deltas are small and positive
+    internal::encode_one_delta_array<raft::group_id>(out, encodee.groups);
+    // revisions grow with group ids as both are assigned on creation
+    internal::encode_one_delta_array<model::revision_id>(
+      out, encodee.revisions);
+    for (auto t : encodee.terms) {
+        internal::append_vint(out, t());
+    }
+    for (auto o : encodee.commit_indices) {
+        internal::append_vint(out, o());
+    }
+    internal::encode_against_refs(
+      out, encodee.prev_log_indices, encodee.commit_indices);
+    internal::encode_against_refs(
+      out, encodee.last_visible_indices, encodee.commit_indices);
+    internal::encode_against_refs(out, encodee.prev_log_terms, encodee.terms);
+    internal::encode_against_refs(
+      out, encodee.target_revisions, encodee.revisions);
+    return ss::now();
+}
+
+ss::future<raft::compact_heartbeat_request>
+async_adl<raft::compact_heartbeat_request>::from(iobuf_parser& in) {
+    raft::compact_heartbeat_request req;
+    req.heartbeats = std::vector<raft::heartbeat_metadata>(
+      adl<uint32_t>{}.from(in));
+    if (req.heartbeats.empty()) {
+        return ss::make_ready_future<raft::compact_heartbeat_request>(
+          std::move(req));
+    }
+    auto& hbs = req.heartbeats;
+    const size_t size = hbs.size();
+    auto node_id = adl<model::node_id>{}.from(in);
+    auto target_node = adl<model::node_id>{}.from(in);
+
+    hbs[0].meta.group = varlong_reader<raft::group_id>(in);
+    for (size_t i = 1; i < size; ++i) {
+        hbs[i].meta.group = internal::read_one_varint_delta<raft::group_id>(
+          in, hbs[i - 1].meta.group);
+    }
+    std::vector<model::revision_id> revisions(size);
+    revisions[0] = varlong_reader<model::revision_id>(in);
+    for (size_t i = 1; i < size; ++i) {
+        revisions[i] = internal::read_one_varint_delta<model::revision_id>(
+          in, revisions[i - 1]);
+    }
+    for (auto& hb : hbs) {
+        hb.meta.term = varlong_reader<model::term_id>(in);
+    }
+    for (auto& hb : hbs) {
+        hb.meta.commit_index = varlong_reader<model::offset>(in);
+    }
+    internal::decode_against_refs<model::offset>(
+      in,
+      size,
+      [&hbs](size_t i) { return hbs[i].meta.commit_index; },
+      [&hbs](size_t i, model::offset o) { hbs[i].meta.prev_log_index = o; });
+    internal::decode_against_refs<model::offset>(
+      in,
+      size,
+      [&hbs](size_t i) { return hbs[i].meta.commit_index; },
+      [&hbs](size_t i, model::offset o) {
+          hbs[i].meta.last_visible_index = o;
+      });
+    internal::decode_against_refs<model::term_id>(
+      in,
+      size,
+      [&hbs](size_t i) { return hbs[i].meta.term; },
+      [&hbs](size_t i, model::term_id t) { hbs[i].meta.prev_log_term = t; });
+    internal::decode_against_refs<model::revision_id>(
+      in,
+      size,
+      [&revisions](size_t i) { return revisions[i]; },
+      [&hbs, target_node](size_t i, model::revision_id r) {
+          hbs[i].target_node_id = raft::vnode(target_node, r);
+      });
+
+    // same normalization of the clamped values as the v1 format
+    for (size_t i = 0; i < size; ++i) {
+        auto& hb = hbs[i];
+        hb.meta.prev_log_index = decode_signed(hb.meta.prev_log_index);
+        hb.meta.commit_index = decode_signed(hb.meta.commit_index);
+        hb.meta.prev_log_term = decode_signed(hb.meta.prev_log_term);
+        hb.meta.last_visible_index = decode_signed(hb.meta.last_visible_index);
+        hb.node_id = raft::vnode(node_id, decode_signed(revisions[i]));
+        hb.target_node_id = raft::vnode(
+          target_node, decode_signed(hb.target_node_id.revision()));
+    }
+    return ss::make_ready_future<raft::compact_heartbeat_request>(
+      std::move(req));
+}
+
 ss::future<> async_adl<raft::heartbeat_reply>::to(
   iobuf& out, raft::heartbeat_reply&& reply) {
     struct sorter_fn {
@@ -153,6 +153,14 @@ struct follower_index_metadata {
      */
     heartbeats_suppressed suppress_heartbeats = heartbeats_suppressed::no;
     follower_req_seq last_suppress_heartbeats_seq{0};
+    /**
+     * Set when the follower acknowledged a heartbeat saying that everything
+     * up to this offset is committed while having all of it flushed, see
+     * consensus::is_follower_quiescent
+     */
+    std::optional<model::offset> quiescent_offset;
+    model::term_id quiescent_term;
+    clock_type::time_point quiescent_since;
 };
 /**
  * class containing follower statistics, this may be helpful for debugging,
@@ -260,10 +268,38 @@ struct heartbeat_metadata {
 struct heartbeat_request {
     std::vector<heartbeat_metadata> heartbeats;
 };
+
+/// \brief the same heartbeats as heartbeat_request, with a more compact wire
+/// encoding; sent through the `heartbeat_v2` method to nodes that know it.
+///
+/// Groups are sorted by id so that the group ids and their revisions are
+/// encoded as small deltas. Instead of delta encoding every offset and term
+/// column against the previous group, the fields of a group are encoded
+/// against each other: prev_log_index and last_visible_index against the
+/// commit index, prev_log_term against the term and the target revision
+/// against the revision. A bitmap per column marks the groups whose field is
+/// equal to its reference, only the others are followed by a delta. An idle
+/// and up to date follower costs a group id delta, a term, a commit index and
+/// a revision delta.
+struct compact_heartbeat_request {
+    std::vector<heartbeat_metadata> heartbeats;
+};
 struct heartbeat_reply {
     std::vector<append_entries_reply> meta;
 };
 
+/// \brief node level liveness beat, sent instead of the heartbeats of
+/// quiescent groups (see node_liveness)
+struct node_heartbeat_request {
+    model::node_id node_id;
+    model::node_id target_node_id;
+    uint64_t incarnation;
+};
+struct node_heartbeat_reply {
+    model::node_id node_id;
+    uint64_t incarnation;
+};
+
 struct vote_request {
     vnode node_id;
     // node id to validate on receiver
@@ -408,6 +444,15 @@ private:
     ptr_t _ptr;
 };
 
+/// \brief install_snapshot_request with the checksum of its chunk, sent
+/// through `install_snapshot_v2` to nodes that know it. A chunk that does not
+/// match the checksum is rejected and the leader resends it.
+struct install_snapshot_v2_request {
+    install_snapshot_request request;
+    // crc32c of request.chunk
+    uint32_t chunk_crc;
+};
+
 struct install_snapshot_reply {
     // node id to validate on receiver
     vnode target_node_id;
@@ -529,6 +574,7 @@ std::ostream& operator<<(std::ostream& o, const append_entries_reply& r);
 std::ostream& operator<<(std::ostream& o, const vote_request& r);
 std::ostream& operator<<(std::ostream& o, const follower_index_metadata& i);
 std::ostream& operator<<(std::ostream& o, const heartbeat_request& r);
+std::ostream& operator<<(std::ostream& o, const compact_heartbeat_request& r);
 std::ostream& operator<<(std::ostream& o, const heartbeat_reply& r);
 } // namespace raft
 
@@ -549,6 +595,12 @@ struct async_adl<raft::heartbeat_request> {
     ss::future<raft::heartbeat_request> from(iobuf_parser& in);
 };
 
+template<>
+struct async_adl<raft::compact_heartbeat_request> {
+    ss::future<> to(iobuf& out, raft::compact_heartbeat_request&& request);
+    ss::future<raft::compact_heartbeat_request> from(iobuf_parser& in);
+};
+
 template<>
 struct async_adl<raft::heartbeat_reply> {
     ss::future<> to(iobuf& out, raft::heartbeat_reply&& request);
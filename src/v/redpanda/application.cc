@@ -459,6 +459,8 @@ manager_config_from_global_config(scheduling_groups& sgs) {
         .max_size = config::shard_local_cfg().reclaim_max_size(),
         .min_free_memory
         = config::shard_local_cfg().reclaim_batch_cache_min_free(),
+        .compressed_tier_max_size
+        = config::shard_local_cfg().batch_cache_compressed_tier_size(),
       },
       config::shard_local_cfg().readers_cache_eviction_timeout_ms(),
       sgs.compaction_sg());
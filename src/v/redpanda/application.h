@@ -74,6 +74,8 @@ public:
     ss::future<> set_proxy_config(ss::sstring name, std::any val);
     ss::future<> set_proxy_client_config(ss::sstring name, std::any val);
 
+    ss::sharded<net::server>& kafka_server() { return _kafka_server; }
+
     ss::sharded<cluster::metadata_cache> metadata_cache;
     ss::sharded<kafka::group_router> group_router;
     ss::sharded<cluster::shard_table> shard_table;
@@ -61,7 +61,8 @@ public:
       std::vector<config::seed_server> seed_servers,
       ss::sstring base_dir,
       std::optional<scheduling_groups> sch_groups,
-      bool remove_on_shutdown)
+      bool remove_on_shutdown,
+      std::optional<model::rack_id> rack = model::rack_id(rack_name))
       : app(ssx::sformat("redpanda-{}", node_id()))
       , proxy_port(proxy_port)
       , schema_reg_port(schema_reg_port)
@@ -72,7 +73,8 @@ public:
           kafka_port,
           rpc_port,
           coproc_supervisor_port,
-          std::move(seed_servers));
+          std::move(seed_servers),
+          std::move(rack));
         app.initialize(
           proxy_config(proxy_port),
           proxy_client_config(kafka_port),
@@ -150,14 +152,16 @@ public:
       int32_t kafka_port,
       int32_t rpc_port,
       int32_t coproc_supervisor_port,
-      std::vector<config::seed_server> seed_servers) {
+      std::vector<config::seed_server> seed_servers,
+      std::optional<model::rack_id> rack) {
         auto base_path = std::filesystem::path(data_dir);
         ss::smp::invoke_on_all([node_id,
                                 kafka_port,
                                 rpc_port,
                                 coproc_supervisor_port,
                                 seed_servers = std::move(seed_servers),
-                                base_path]() mutable {
+                                base_path,
+                                rack]() mutable {
             auto& config = config::shard_local_cfg();
 
             config.get("enable_pid_file").set_value(false);
@@ -170,8 +174,7 @@ public:
               std::vector<model::broker_endpoint>());
             node_config.get("developer_mode").set_value(true);
             node_config.get("node_id").set_value(node_id);
-            node_config.get("rack").set_value(
-              std::optional<model::rack_id>(model::rack_id(rack_name)));
+            node_config.get("rack").set_value(rack);
             node_config.get("seed_servers").set_value(seed_servers);
             node_config.get("rpc_server")
               .set_value(net::unresolved_address("127.0.0.1", rpc_port));
@@ -423,6 +426,35 @@ public:
           std::chrono::milliseconds(0));
     }
 
+    // the probe of the kafka connections served on this shard
+    kafka::pipeline_probe& kafka_pipeline_probe() {
+        return static_cast<kafka::protocol*>(
+                 app.kafka_server().local().get_protocol())
+          ->pipeline_probe();
+    }
+
+    kafka::request_context make_fetch_request_context(
+      kafka::fetch_request request, kafka::api_version version) {
+        security::sasl_server sasl(security::sasl_server::sasl_state::complete);
+        auto conn = ss::make_lw_shared<kafka::connection_context>(
+          *proto,
+          net::server::resources(nullptr, nullptr),
+          std::move(sasl),
+          false);
+
+        kafka::request_header header{
+          .key = kafka::fetch_api::key, .version = version};
+        iobuf buf;
+        kafka::response_writer writer(buf);
+        request.encode(writer, version);
+
+        return kafka::request_context(
+          conn,
+          std::move(header),
+          std::move(buf),
+          std::chrono::milliseconds(0));
+    }
+
     application app;
     uint16_t proxy_port;
     uint16_t schema_reg_port;
@@ -15,6 +15,7 @@
 #include "storage/kvstore.h"
 #include "storage/log_manager.h"
 #include "storage/probe.h"
+#include "storage/write_coalescer.h"
 
 namespace storage {
 
@@ -50,13 +51,18 @@ public:
         _kvstore = std::make_unique<kvstore>(_kv_conf_cb());
         return _kvstore->start().then([this] {
             _log_mgr = std::make_unique<log_manager>(_log_conf_cb(), kvs());
+            _log_mgr->index_residency().setup_metrics();
+            _log_mgr->cache().setup_metrics();
+            internal::coalescer().start();
+            internal::coalescer().setup_metrics();
         });
     }
 
     ss::future<> stop() {
         auto f = ss::now();
         if (_log_mgr) {
-            f = _log_mgr->stop();
+            f = _log_mgr->stop().finally(
+              [] { return internal::coalescer().stop(); });
         }
         if (_kvstore) {
             return f.then([this] { return _kvstore->stop(); });
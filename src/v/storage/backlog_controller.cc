@@ -128,6 +128,9 @@ ss::future<> backlog_controller::update() {
 ss::future<> backlog_controller::set() {
     vlog(_log.debug, "updating shares {}", _current_shares);
     _scheduling_group.set_shares(static_cast<float>(_current_shares));
+    if (_listener) {
+        _listener(_current_shares);
+    }
     return _io_priority.update_shares(_current_shares);
 }
 
@@ -15,6 +15,7 @@
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/timer.hh>
 #include <seastar/util/log.hh>
+#include <seastar/util/noncopyable_function.hh>
 
 namespace storage {
 struct backlog_controller_config {
@@ -93,7 +94,12 @@ public:
     backlog_controller(
       std::unique_ptr<sampler>, ss::logger&, backlog_controller_config);
 
+    /// called with the new shares every time the controller applies them, for
+    /// processes that scale something other than CPU and IO shares
+    using shares_listener = ss::noncopyable_function<void(int)>;
+
     void update_setpoint(int64_t);
+    void set_shares_listener(shares_listener l) { _listener = std::move(l); }
     ss::future<> start();
     ss::future<> stop();
 
@@ -124,6 +130,7 @@ private:
     int _current_shares;
     int _min_shares;
     int _max_shares;
+    shares_listener _listener;
     ss::gate _gate;
     ss::metrics::metric_groups _metrics;
 };
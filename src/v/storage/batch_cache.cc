@@ -10,6 +10,7 @@
 #include "batch_cache.h"
 
 #include "bytes/iobuf_parser.h"
+#include "compression/internal/lz4_frame_compressor.h"
 #include "model/adl_serde.h"
 #include "ssx/future-util.h"
 #include "utils/gate_guard.h"
@@ -21,6 +22,8 @@
 
 #include <fmt/ostream.h>
 
+#include <chrono>
+
 namespace storage {
 
 batch_cache::range::range(batch_cache_index& index)
@@ -160,7 +163,7 @@ batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
 batch_cache::~batch_cache() noexcept {
     clear();
     vassert(
-      _size_bytes == 0 && _lru.empty(),
+      _size_bytes == 0 && _lru.empty() && _compressed_size_bytes == 0,
       "Detected incorrect batch_cache accounting. {}",
       *this);
 }
@@ -177,7 +180,7 @@ void batch_cache::evict(range_ptr&& e) {
     }
 }
 
-size_t batch_cache::reclaim(size_t size) {
+size_t batch_cache::reclaim(size_t size, demote_ranges demote_to_tier) {
     if (is_memory_reclaiming()) {
         return 0;
     }
@@ -210,6 +213,7 @@ size_t batch_cache::reclaim(size_t size) {
      * index still exists even though the batch data was removed.
      */
     size_t reclaimed = 0;
+    size_t demoted = 0;
     intrusive_list<range, &range::_hook> reclaimed_ranges;
 
     for (auto it = _lru.begin(); it != _lru.end();) {
@@ -226,6 +230,13 @@ size_t batch_cache::reclaim(size_t size) {
         if (unlikely(it->empty())) {
             continue;
         }
+        if (
+          demote_to_tier && compressed_tier_enabled() && it->valid()
+          && !it->_index.locked() && demoted < max_demote_size) {
+            demoted += it->_arena.size_bytes();
+            demote(*it);
+        }
+
         // reclaim the batch's record data
         reclaimed += it->memory_size();
         it->_arena.clear();
@@ -273,17 +284,149 @@ size_t batch_cache::reclaim(size_t size) {
 
     _last_reclaim = ss::lowres_clock::now();
     _size_bytes -= reclaimed;
+
+    /*
+     * the synchronous reclaimer may also release the compressed tier if the
+     * first tier was not enough
+     */
+    if (!demote_to_tier && reclaimed < _reclaim_size) {
+        const auto missing = std::min(
+          _reclaim_size - reclaimed, _compressed_size_bytes);
+        reclaimed += shrink_compressed_tier(_compressed_size_bytes - missing);
+    }
     return reclaimed;
 }
 
+bool batch_cache::demote(range& r) {
+    try {
+        std::vector<model::offset> offsets;
+        std::vector<model::offset> last_offsets;
+        iobuf_const_parser parser(r._arena);
+        while (parser.bytes_left() > 0) {
+            auto hdr = reflection::adl<model::record_batch_header>{}.from(
+              parser);
+            parser.skip(
+              hdr.size_bytes - model::packed_record_batch_header_size);
+            offsets.push_back(hdr.base_offset);
+            last_offsets.push_back(hdr.last_offset());
+        }
+        if (offsets.empty()) {
+            return false;
+        }
+        auto data = compression::internal::lz4_frame_compressor::compress(
+          r._arena);
+        auto& index = r._index;
+        auto cr = std::make_unique<compressed_range>(
+          index, std::move(data), r._arena.size_bytes(), offsets);
+        if (cr->memory_size() > _reclaim_opts.compressed_tier_max_size) {
+            return false;
+        }
+        // a batch may have been read from disk and cached again after its
+        // previous range was demoted. the newest copy wins
+        for (auto o : offsets) {
+            if (auto it = index._demoted.find(o); it != index._demoted.end()) {
+                drop_compressed(it->second.range);
+            }
+        }
+        shrink_compressed_tier(
+          _reclaim_opts.compressed_tier_max_size - cr->memory_size());
+
+        auto p = cr.release();
+        for (size_t i = 0; i < offsets.size(); ++i) {
+            index._demoted.emplace(
+              offsets[i], batch_cache_index::demoted_batch{last_offsets[i], p});
+        }
+        _compressed_size_bytes += p->memory_size();
+        _compressed_lru.push_back(*p);
+        _probe.range_demoted();
+        _probe.set_compressed_bytes(_compressed_size_bytes);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+size_t batch_cache::shrink_compressed_tier(size_t max_size) {
+    size_t freed = 0;
+    for (auto it = _compressed_lru.begin();
+         it != _compressed_lru.end() && _compressed_size_bytes > max_size;) {
+        auto p = &*it;
+        ++it;
+        freed += p->memory_size();
+        drop_compressed(p);
+    }
+    return freed;
+}
+
+void batch_cache::drop_compressed(compressed_range* r) {
+    auto& demoted = r->_index._demoted;
+    for (auto o : r->_offsets) {
+        if (auto it = demoted.find(o);
+            it != demoted.end() && it->second.range == r) {
+            demoted.erase(it);
+        }
+    }
+    _compressed_size_bytes -= r->memory_size();
+    _probe.set_compressed_bytes(_compressed_size_bytes);
+    _compressed_lru.erase_and_dispose(
+      _compressed_lru.iterator_to(*r),
+      [](compressed_range* e) { delete e; }); // NOLINT
+}
+
+iobuf batch_cache::take_compressed(compressed_range* r) {
+    // unlink before decompressing; the allocations below may run the
+    // reclaimer which must not see the range anymore
+    auto data = std::move(r->_data);
+    const auto uncompressed_size = r->_uncompressed_size;
+    drop_compressed(r);
+
+    const auto start = std::chrono::steady_clock::now();
+    auto ret = compression::internal::lz4_frame_compressor::uncompress(data);
+    _probe.add_decompression(
+      uncompressed_size,
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start));
+    return ret;
+}
+
+bool batch_cache_index::maybe_promote(model::offset offset) {
+    if (_demoted.empty() || find_first_contains(offset) != _index.end()) {
+        return false;
+    }
+    auto it = _demoted.upper_bound(offset);
+    if (it == _demoted.begin()) {
+        return false;
+    }
+    --it;
+    if (it->second.last_offset < offset) {
+        return false;
+    }
+    iobuf_parser parser(_cache->take_compressed(it->second.range));
+    while (parser.bytes_left() > 0) {
+        auto hdr = reflection::adl<model::record_batch_header>{}.from(parser);
+        auto data = parser.share(
+          hdr.size_bytes - model::packed_record_batch_header_size);
+        put(model::record_batch(
+          hdr, std::move(data), model::record_batch::tag_ctor_ng{}));
+    }
+    return true;
+}
+
 std::optional<model::record_batch>
 batch_cache_index::get(model::offset offset) {
+    const bool promoted = maybe_promote(offset);
     lock_guard lk(*this);
     if (auto it = find_first_contains(offset); it != _index.end()) {
         batch_cache::range::lock_guard g(*it->second.range());
         _cache->touch(it->second.range());
+        if (promoted) {
+            _cache->_probe.compressed_cache_hit();
+        } else {
+            _cache->_probe.cache_hit();
+        }
         return it->second.batch();
     }
+    _cache->_probe.cache_miss();
     return std::nullopt;
 }
 
@@ -294,13 +437,22 @@ batch_cache_index::read_result batch_cache_index::read(
   std::optional<model::timestamp> first_ts,
   size_t max_bytes,
   bool skip_lru_promote) {
-    lock_guard lk(*this);
     read_result ret;
     ret.next_batch = offset;
     if (unlikely(offset > max_offset)) {
         return ret;
     }
-    for (auto it = find_first_contains(offset); it != _index.end();) {
+    const bool promoted = maybe_promote(offset);
+    lock_guard lk(*this);
+    auto it = find_first_contains(offset);
+    if (it == _index.end()) {
+        _cache->_probe.cache_miss();
+    } else if (promoted) {
+        _cache->_probe.compressed_cache_hit();
+    } else {
+        _cache->_probe.cache_hit();
+    }
+    while (it != _index.end()) {
         auto batch = it->second.batch();
 
         auto take = !type_filter || type_filter == batch.header().type;
@@ -355,6 +507,19 @@ batch_cache_index::read_result batch_cache_index::read(
 }
 
 void batch_cache_index::truncate(model::offset offset) {
+    // compressed ranges are dropped if any of their batches may be truncated
+    std::vector<batch_cache::compressed_range*> to_drop;
+    for (auto& [base, b] : _demoted) {
+        if (b.last_offset >= offset) {
+            to_drop.push_back(b.range);
+        }
+    }
+    std::sort(to_drop.begin(), to_drop.end());
+    to_drop.erase(std::unique(to_drop.begin(), to_drop.end()), to_drop.end());
+    for (auto* r : to_drop) {
+        _cache->drop_compressed(r);
+    }
+
     lock_guard lk(*this);
     if (auto it = find_first(offset); it != _index.end()) {
         // rule out if possible, otherwise always be pessimistic
@@ -398,7 +563,7 @@ ss::future<> batch_cache::background_reclaimer::reclaim_loop() {
 
         if (free < _min_free_memory) {
             auto to_reclaim = _min_free_memory - free;
-            _cache.reclaim(to_reclaim);
+            _cache.reclaim(to_reclaim, demote_ranges::yes);
         }
     }
     co_return;
@@ -421,6 +586,7 @@ std::ostream& operator<<(std::ostream& o, const batch_cache& b) {
     // Do _not_ print size of _lru
     return o << "{is_reclaiming:" << b.is_memory_reclaiming()
              << ", size_bytes: " << b._size_bytes
+             << ", compressed_size_bytes: " << b._compressed_size_bytes
              << ", lru_empty:" << b._lru.empty() << "}";
 }
 std::ostream&
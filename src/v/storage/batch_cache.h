@@ -11,6 +11,7 @@
 
 #pragma once
 #include "model/record.h"
+#include "storage/batch_cache_probe.h"
 #include "units.h"
 #include "utils/intrusive_list_helpers.h"
 #include "vassert.h"
@@ -22,6 +23,7 @@
 #include <seastar/core/memory.hh>
 #include <seastar/core/scheduling.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/util/bool_class.hh>
 
 #include <absl/container/btree_map.h>
 #include <absl/container/flat_hash_map.h>
@@ -92,8 +94,18 @@ class batch_cache_index;
  * the future, consider other solutions like blocking the reclaimer or only
  * allowing asynchronous reclaims while executing within the batch catch.
  *
- * TODO:
- *  - add probes to track statistics
+ * Compressed tier
+ * ===============
+ *
+ * When `reclaim_options::compressed_tier_max_size` is set, ranges evicted by
+ * the background reclaimer are not dropped but compressed with lz4 into a
+ * second LRU with its own memory budget. A lookup that misses the first tier
+ * but hits a compressed range decompresses it and puts its batches back into
+ * the first tier. Compressing allocates, so ranges are only demoted from the
+ * background reclaimer and never from the synchronous reclaim upcall, which
+ * instead also frees compressed ranges when the first tier is not enough.
+ * Compression runs without yielding, so a single reclaim compresses at most
+ * `max_demote_size` bytes and frees the rest of the ranges it evicts.
  */
 
 class batch_cache {
@@ -113,8 +125,14 @@ public:
         // background reclaimer settings
         ss::scheduling_group background_reclaimer_sg;
         size_t min_free_memory = 64_MiB;
+        // memory budget of the compressed tier, disabled when 0
+        size_t compressed_tier_max_size = 0;
     };
 
+    using demote_ranges = ss::bool_class<struct demote_ranges_tag>;
+    /// Maximum size of the ranges compressed by a single reclaim.
+    static constexpr size_t max_demote_size = 512_KiB;
+
     /*
      * An range manages the lifetime of a multiple cached record batches.
      */
@@ -193,6 +211,45 @@ public:
         batch_cache_index& _index;
     };
 
+    /*
+     * A range demoted to the compressed tier. It owns the lz4 compressed arena
+     * of the original range and registers the base offset of every batch it
+     * holds in the owning index.
+     */
+    class compressed_range {
+    public:
+        compressed_range(
+          batch_cache_index& index,
+          iobuf data,
+          size_t uncompressed_size,
+          std::vector<model::offset> offsets) noexcept
+          : _data(std::move(data))
+          , _uncompressed_size(uncompressed_size)
+          , _offsets(std::move(offsets))
+          , _index(index) {}
+
+        ~compressed_range() noexcept = default;
+        compressed_range(compressed_range&&) noexcept = delete;
+        compressed_range& operator=(compressed_range&&) noexcept = delete;
+        compressed_range(const compressed_range&) = delete;
+        compressed_range& operator=(const compressed_range&) = delete;
+
+        size_t memory_size() const {
+            return _data.size_bytes()
+                   + _offsets.capacity() * sizeof(model::offset);
+        }
+
+    private:
+        friend class batch_cache;
+        friend class batch_cache_index;
+
+        iobuf _data;
+        size_t _uncompressed_size;
+        std::vector<model::offset> _offsets;
+        intrusive_list_hook _hook;
+        batch_cache_index& _index;
+    };
+
     using range_ptr = ss::weak_ptr<range>;
     /**
      * Entry represents single batch in given range, it contains range weak
@@ -253,7 +310,7 @@ public:
     ss::future<> stop() { return _background_reclaimer.stop(); }
 
     /// Returns true if the cache is empty, and false otherwise.
-    bool empty() const { return _lru.empty(); }
+    bool empty() const { return _lru.empty() && _compressed_lru.empty(); }
 
     /// Removes all entries from the cache.
     void clear() { reclaim(std::numeric_limits<size_t>::max()); }
@@ -299,8 +356,18 @@ public:
      * Unlike `evict` which places the cache range back into the free pool, this
      * method releases the entire range because this interface is intended to be
      * used to deal with low-memory situations.
+     *
+     * With `demote_ranges::yes` and the compressed tier enabled, the released
+     * ranges are compressed into the second tier. Must not be used from the
+     * synchronous reclaimer.
      */
-    size_t reclaim(size_t size);
+    size_t reclaim(size_t size, demote_ranges = demote_ranges::no);
+
+    bool compressed_tier_enabled() const {
+        return _reclaim_opts.compressed_tier_max_size > 0;
+    }
+
+    void setup_metrics() { _probe.setup_metrics(); }
 
     /**
      * returns true if there is an active reclaim happening
@@ -359,6 +426,17 @@ private:
      * fiber. A more advanced usage that is allowed to invoke reclaim
      * synchronously with memory allocation is also possible.
      */
+    /// compresses the range into the second tier. returns false if the range
+    /// could not be demoted
+    bool demote(range&);
+    /// frees compressed ranges from the tail of the second tier until the
+    /// tier uses at most `max_size` bytes. returns bytes freed
+    size_t shrink_compressed_tier(size_t max_size);
+    /// unregisters the range from its index and frees it
+    void drop_compressed(compressed_range*);
+    /// decompresses the range and frees it. returns the original arena
+    iobuf take_compressed(compressed_range*);
+
     ss::memory::reclaiming_result reclaim(reclaimer::request r) {
         const size_t lower_bound = std::max(
           r.bytes_to_reclaim, min_reclaim_size);
@@ -370,9 +448,12 @@ private:
     }
 
     intrusive_list<range, &range::_hook> _lru;
+    intrusive_list<compressed_range, &compressed_range::_hook> _compressed_lru;
     reclaimer _reclaimer;
     bool _is_reclaiming{false};
     size_t _size_bytes{0};
+    size_t _compressed_size_bytes{0};
+    batch_cache_probe _probe;
 
     reclaim_options _reclaim_opts;
     ss::lowres_clock::time_point _last_reclaim;
@@ -399,6 +480,9 @@ public:
     explicit batch_cache_index(batch_cache& cache)
       : _cache(&cache) {}
     ~batch_cache_index() {
+        while (!_demoted.empty()) {
+            _cache->drop_compressed(_demoted.begin()->second.range);
+        }
         lock_guard lk(*this);
         std::for_each(
           _index.begin(), _index.end(), [this](index_type::value_type& e) {
@@ -486,6 +570,20 @@ public:
 private:
     friend class batch_cache;
 
+    // a batch held by a range of the compressed tier
+    struct demoted_batch {
+        model::offset last_offset;
+        batch_cache::compressed_range* range;
+    };
+    using demoted_type = absl::btree_map<model::offset, demoted_batch>;
+
+    /*
+     * If the batch containing the offset is only held in the compressed tier
+     * move its whole range back to the first tier. Returns true if the range
+     * was promoted.
+     */
+    bool maybe_promote(model::offset offset);
+
     class lock_guard {
     public:
         explicit lock_guard(batch_cache_index& index) noexcept
@@ -558,6 +656,7 @@ private:
     bool _locked{false};
     batch_cache* _cache;
     index_type _index;
+    demoted_type _demoted;
     batch_cache::range_ptr _small_batches_range = nullptr;
 
     friend std::ostream& operator<<(std::ostream&, const batch_cache_index&);
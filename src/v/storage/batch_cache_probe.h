@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include <seastar/core/metrics_registration.hh>
+
+#include <chrono>
+#include <cstdint>
+
+namespace storage {
+
+// Per-shard batch cache probe.
+class batch_cache_probe {
+public:
+    void cache_hit() { ++_hits; }
+    void compressed_cache_hit() { ++_compressed_hits; }
+    void cache_miss() { ++_misses; }
+
+    void range_demoted() { ++_ranges_demoted; }
+    void set_compressed_bytes(size_t b) { _compressed_bytes = b; }
+    void add_decompression(size_t bytes, std::chrono::microseconds t) {
+        _decompressed_bytes += bytes;
+        _decompression_time_us += t.count();
+    }
+
+    void setup_metrics();
+
+private:
+    double hit_ratio() const {
+        const auto lookups = _hits + _compressed_hits + _misses;
+        return lookups == 0 ? 0.0 : double(_hits) / double(lookups);
+    }
+    double compressed_hit_ratio() const {
+        // of the lookups that missed the first tier
+        const auto lookups = _compressed_hits + _misses;
+        return lookups == 0 ? 0.0 : double(_compressed_hits) / double(lookups);
+    }
+
+    uint64_t _hits{0};
+    uint64_t _compressed_hits{0};
+    uint64_t _misses{0};
+    uint64_t _ranges_demoted{0};
+    uint64_t _compressed_bytes{0};
+    uint64_t _decompressed_bytes{0};
+    uint64_t _decompression_time_us{0};
+
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
@@ -11,10 +11,15 @@
 
 #include "storage/compaction_controller.h"
 
+#include "config/configuration.h"
 #include "storage/api.h"
+#include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
 
+#include <algorithm>
+#include <cmath>
+
 namespace storage {
 static ss::logger compaction_log{"compaction_ctrl"};
 
@@ -22,11 +27,46 @@ ss::future<int64_t> compaction_backlog_sampler::sample_backlog() {
     co_return _api.local().log_mgr().compaction_backlog();
 }
 
+/**
+ * Maps the shares chosen by the controller linearly onto the number of
+ * partitions compacted concurrently: a single one at minimum shares and
+ * `storage_max_concurrent_compactions` at maximum shares.
+ */
+static size_t
+concurrency_for_shares(int shares, int min_shares, int max_shares) {
+    const size_t max_concurrency = std::max<size_t>(
+      1, config::shard_local_cfg().storage_max_concurrent_compactions());
+    if (max_shares <= min_shares) {
+        return max_concurrency;
+    }
+    const auto ratio = static_cast<double>(shares - min_shares)
+                       / static_cast<double>(max_shares - min_shares);
+    return 1
+           + static_cast<size_t>(std::lround(
+             std::clamp(ratio, 0.0, 1.0) * (max_concurrency - 1)));
+}
+
 compaction_controller::compaction_controller(
   ss::sharded<api>& api, backlog_controller_config cfg)
   : _ctrl(
     std::make_unique<compaction_backlog_sampler>(api), compaction_log, cfg) {
     _ctrl.setup_metrics("storage:compaction");
+    _ctrl.set_shares_listener(
+      [&api, min = cfg.min_shares, max = cfg.max_shares](int shares) {
+          if (!api.local_is_initialized()) {
+              return;
+          }
+          auto concurrency = concurrency_for_shares(shares, min, max);
+          auto& mgr = api.local().log_mgr();
+          if (concurrency != mgr.max_concurrent_compactions()) {
+              vlog(
+                compaction_log.debug,
+                "updating compaction concurrency {} -> {}",
+                mgr.max_concurrent_compactions(),
+                concurrency);
+              mgr.set_max_concurrent_compactions(concurrency);
+          }
+      });
 }
 
 } // namespace storage
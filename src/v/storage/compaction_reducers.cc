@@ -21,6 +21,7 @@
 #include "storage/segment_utils.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
 
 #include <absl/algorithm/container.h>
@@ -28,6 +29,7 @@
 #include <boost/range/irange.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <exception>
 
 namespace storage::internal {
@@ -83,6 +85,210 @@ Roaring compaction_key_reducer::end_of_stream() {
     return std::move(_inverted);
 }
 
+void compaction_spilling_key_reducer::insert(bytes key, model::offset o) {
+    _keys_mem_usage += key.size();
+    _indices.emplace(std::move(key), value_type(o, _natural_index));
+}
+
+ss::future<ss::stop_iteration>
+compaction_spilling_key_reducer::operator()(compacted_index::entry&& e) {
+    using stop_t = ss::stop_iteration;
+    const model::offset o = e.offset + model::offset(e.delta);
+
+    auto it = _indices.find(e.key);
+    if (it != _indices.end()) {
+        if (o > it->second.offset) {
+            it->second.offset = o;
+            it->second.natural_index = _natural_index;
+        }
+        ++_natural_index;
+        return ss::make_ready_future<stop_t>(stop_t::no);
+    }
+    const auto expected_size = idx_mem_usage() + _keys_mem_usage
+                               + e.key.size();
+    if (expected_size >= _max_mem && !_indices.empty()) {
+        return spill_run().then([this, k = std::move(e.key), o]() mutable {
+            insert(std::move(k), o);
+            ++_natural_index;
+            return stop_t::no;
+        });
+    }
+    insert(std::move(e.key), o);
+    ++_natural_index;
+    return ss::make_ready_future<stop_t>(stop_t::no);
+}
+
+ss::future<> compaction_spilling_key_reducer::spill_run() {
+    // node_hash_map has pointer stability, sort the nodes in place
+    using node_t = underlying_t::value_type;
+    std::vector<std::pair<uint64_t, const node_t*>> sorted;
+    sorted.reserve(_indices.size());
+    for (const auto& node : _indices) {
+        sorted.emplace_back(hasher{}(node.first), &node);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return bytes_view(a.second->first) < bytes_view(b.second->first);
+    });
+
+    auto path = sorted_run_path(_run_prefix, _runs++);
+    vlog(
+      gclog.debug,
+      "spilling {} compaction keys ({} bytes) to {}",
+      sorted.size(),
+      idx_mem_usage() + _keys_mem_usage,
+      path);
+    auto w = co_await sorted_run_writer::open(path, _iopc);
+    std::exception_ptr ep;
+    try {
+        for (auto& [hash, node] : sorted) {
+            co_await w.write(
+              hash,
+              node->first,
+              node->second.offset,
+              node->second.natural_index);
+        }
+    } catch (...) {
+        ep = std::current_exception();
+    }
+    co_await w.close();
+    if (ep) {
+        std::rethrow_exception(ep);
+    }
+    if (_probe) {
+        _probe->add_compaction_spill_bytes(w.bytes_written());
+    }
+    _indices.clear();
+    _keys_mem_usage = 0;
+}
+
+ss::future<> compaction_spilling_key_reducer::merge_runs(
+  size_t first, size_t last, sink_t sink) {
+    struct head {
+        sorted_run_entry entry;
+        size_t reader;
+    };
+    // min-heap on (hash, key)
+    auto cmp = [](const head& a, const head& b) { return b.entry < a.entry; };
+
+    std::vector<sorted_run_reader> readers;
+    readers.reserve(last - first);
+    std::vector<head> heap;
+    heap.reserve(last - first);
+    std::exception_ptr ep;
+    try {
+        for (auto i = first; i < last; ++i) {
+            readers.push_back(co_await sorted_run_reader::open(
+              sorted_run_path(_run_prefix, i), _iopc, run_read_buffer_size));
+        }
+        for (size_t i = 0; i < readers.size(); ++i) {
+            if (auto e = co_await readers[i].next(); e) {
+                heap.push_back(head{std::move(*e), i});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+        // every run holds a key at most once; across runs the latest offset
+        // wins, ties keep the first occurrence like the in-memory reducer
+        std::optional<sorted_run_entry> best;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            head h = std::move(heap.back());
+            heap.pop_back();
+            if (auto e = co_await readers[h.reader].next(); e) {
+                heap.push_back(head{std::move(*e), h.reader});
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+            if (best && best->same_key(h.entry)) {
+                if (
+                  h.entry.offset > best->offset
+                  || (h.entry.offset == best->offset
+                      && h.entry.natural_index < best->natural_index)) {
+                    best = std::move(h.entry);
+                }
+                continue;
+            }
+            if (best) {
+                co_await sink(std::move(*best));
+            }
+            best = std::move(h.entry);
+        }
+        if (best) {
+            co_await sink(std::move(*best));
+        }
+    } catch (...) {
+        ep = std::current_exception();
+    }
+    for (auto& r : readers) {
+        co_await r.close();
+    }
+    if (ep) {
+        std::rethrow_exception(ep);
+    }
+}
+
+ss::future<>
+compaction_spilling_key_reducer::merge_into_run(size_t first, size_t last) {
+    auto path = sorted_run_path(_run_prefix, _runs++);
+    vlog(
+      gclog.debug,
+      "merging compaction runs [{}, {}) into {}",
+      first,
+      last,
+      path);
+    auto w = co_await sorted_run_writer::open(path, _iopc);
+    std::exception_ptr ep;
+    try {
+        // merge_runs keeps the entry alive until the write completed
+        co_await merge_runs(
+          first, last, [&w](sorted_run_entry&& e) { return w.write(e); });
+    } catch (...) {
+        ep = std::current_exception();
+    }
+    co_await w.close();
+    if (ep) {
+        std::rethrow_exception(ep);
+    }
+    if (_probe) {
+        _probe->add_compaction_spill_bytes(w.bytes_written());
+    }
+}
+
+ss::future<Roaring> compaction_spilling_key_reducer::end_of_stream() {
+    if (_runs == 0) {
+        // everything fit in memory
+        for (auto& e : _indices) {
+            _inverted.add(e.second.natural_index);
+        }
+        _inverted.shrinkToFit();
+        co_return std::move(_inverted);
+    }
+    if (!_indices.empty()) {
+        co_await spill_run();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    // each reader holds its buffer plus one read ahead
+    const size_t fan_in = std::max<size_t>(
+      2, _max_mem / (2 * run_read_buffer_size));
+    size_t first = 0;
+    while (_runs - first > fan_in) {
+        co_await merge_into_run(first, first + fan_in);
+        first += fan_in;
+    }
+    co_await merge_runs(first, _runs, [this](sorted_run_entry&& e) {
+        _inverted.add(e.natural_index);
+        return ss::now();
+    });
+    if (_probe) {
+        _probe->add_compaction_merge_time(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+    }
+    _inverted.shrinkToFit();
+    co_return std::move(_inverted);
+}
+
 ss::future<ss::stop_iteration>
 index_copy_reducer::operator()(compacted_index::entry&& e) {
     using stop_t = ss::stop_iteration;
@@ -19,14 +19,20 @@
 #include "storage/compacted_offset_list.h"
 #include "storage/index_state.h"
 #include "storage/logger.h"
+#include "storage/probe.h"
 #include "storage/segment_appender.h"
+#include "storage/sorted_key_run.h"
 #include "units.h"
 
+#include <seastar/util/noncopyable_function.hh>
+
 #include <absl/container/btree_map.h>
 #include <absl/container/node_hash_map.h>
 #include <fmt/core.h>
 #include <roaring/roaring.hh>
 
+#include <filesystem>
+
 namespace storage::internal {
 
 struct compaction_reducer {};
@@ -66,6 +72,71 @@ private:
     uint32_t _natural_index{0};
 };
 
+/**
+ * Computes the same keep-set as compaction_key_reducer but never gives up on
+ * deduplication when the key map outgrows its budget. Instead of evicting
+ * random keys (which then have to be kept) the whole map is spilled as a run
+ * sorted by (hash, key). At the end of the stream the runs are merged k-way,
+ * keeping the latest offset of every key. If there are more runs than can be
+ * merged within the budget, they are first merged into larger runs.
+ *
+ * Run files are named after `run_prefix` (see sorted_run_path) and are left
+ * on disk; callers remove them with remove_sorted_runs().
+ */
+class compaction_spilling_key_reducer : public compaction_reducer {
+public:
+    static constexpr const size_t run_read_buffer_size = 64_KiB;
+    struct value_type {
+        value_type(model::offset o, uint32_t i)
+          : offset(o)
+          , natural_index(i) {}
+        model::offset offset;
+        uint32_t natural_index;
+    };
+    using hasher = bytes_hasher<uint64_t, xxhash_64>;
+    using underlying_t
+      = absl::node_hash_map<bytes, value_type, hasher, bytes_type_eq>;
+
+    compaction_spilling_key_reducer(
+      std::filesystem::path run_prefix,
+      ss::io_priority_class iopc,
+      size_t max_mem,
+      storage::probe* pb = nullptr)
+      : _run_prefix(std::move(run_prefix))
+      , _iopc(iopc)
+      , _max_mem(max_mem)
+      , _probe(pb) {}
+
+    ss::future<ss::stop_iteration> operator()(compacted_index::entry&&);
+    ss::future<Roaring> end_of_stream();
+
+    size_t spilled_runs() const { return _runs; }
+
+private:
+    using sink_t
+      = ss::noncopyable_function<ss::future<>(sorted_run_entry&&)>;
+
+    size_t idx_mem_usage() {
+        using debug = absl::container_internal::hashtable_debug_internal::
+          HashtableDebugAccess<underlying_t>;
+        return debug::AllocatedByteSize(_indices);
+    }
+    void insert(bytes key, model::offset o);
+    ss::future<> spill_run();
+    ss::future<> merge_runs(size_t first, size_t last, sink_t);
+    ss::future<> merge_into_run(size_t first, size_t last);
+
+    std::filesystem::path _run_prefix;
+    ss::io_priority_class _iopc;
+    size_t _max_mem;
+    storage::probe* _probe;
+    Roaring _inverted;
+    underlying_t _indices;
+    size_t _keys_mem_usage{0};
+    uint32_t _natural_index{0};
+    size_t _runs{0};
+};
+
 /// This class copies the input reader into the writer consulting the bitmap of
 /// wether ot keep the entry or not
 class index_filtered_copy_reducer : public compaction_reducer {
@@ -71,6 +71,7 @@ disk_log_impl::disk_log_impl(
         if (is_compacted) {
             s->mark_as_compacted_segment();
         }
+        _manager.index_residency().manage(s->index());
     }
     _probe.initial_segments_count(_segs.size());
     _probe.setup_metrics(this->config().ntp());
@@ -344,68 +345,52 @@ disk_log_impl::find_compaction_range() {
     /*
      * adjacent segment compaction.
      *
-     * the strategy is to choose a pair of adjacent segments and first combine
-     * them into a single segment that replaces the pair, and then perform
-     * self-compaction on the replacement segment.
+     * the strategy is to choose a run of adjacent segments and first combine
+     * them into a single segment that replaces the run, and then perform
+     * self-compaction on the replacement segment. the run is grown greedily
+     * from the first segment that can be combined with its successor so that
+     * logs with many small segments are folded in a single pass instead of a
+     * pair at a time.
      */
     if (_segs.size() < 2) {
         return std::nullopt;
     }
+    const size_t max_size = _manager.config().max_compacted_segment_size();
+    const size_t max_segments = std::max<size_t>(
+      2, config::shard_local_cfg().storage_compaction_max_adjacent_segments());
 
-    // sliding window over segments. currently restricted to two segments
-    auto range = std::make_pair(_segs.begin(), std::next(_segs.begin(), 2));
-
-    while (true) {
-        // the simple compaction process in use right now builds a concatenation
-        // of segments so we avoid processing a group that is too large.
-        const auto total_size = std::accumulate(
-          range.first,
-          range.second,
-          size_t(0),
-          [](size_t acc, ss::lw_shared_ptr<segment>& seg) {
-              return acc + seg->size_bytes();
-          });
-
+    for (auto first = _segs.begin(); std::next(first) != _segs.end();
+         ++first) {
+        // the chosen segments all need to be stable
+        if ((*first)->has_appender()) {
+            return std::nullopt;
+        }
         // batches in a segment have a term that is implicitly defined by the
         // name of the file they are contained in. since we need to retain the
         // term information for reach batch we'll avoid combining segments with
         // different terms. this can be addressed in a later optimization.
-        const auto same_term = std::all_of(
-          range.first,
-          range.second,
-          [term = (*range.first)->offsets().term](
-            ss::lw_shared_ptr<segment>& seg) {
-              return seg->offsets().term == term;
-          });
-
-        // found a good range if all the tests pass
-        if (
-          same_term
-          && total_size < _manager.config().max_compacted_segment_size()) {
-            break;
+        const auto term = (*first)->offsets().term;
+        // the simple compaction process in use right now builds a concatenation
+        // of segments so we avoid processing a group that is too large.
+        size_t total_size = (*first)->size_bytes();
+        auto last = std::next(first);
+        while (last != _segs.end()
+               && static_cast<size_t>(std::distance(first, last))
+                    < max_segments) {
+            const auto& seg = *last;
+            if (
+              seg->has_appender() || seg->offsets().term != term
+              || total_size + seg->size_bytes() >= max_size) {
+                break;
+            }
+            total_size += seg->size_bytes();
+            ++last;
         }
-
-        // no candidate range found, yet. advance the window if we aren't
-        // already at the end of the set. one option would also be to shrink the
-        // range from the lower end if the range is large enough. advanced
-        // scheduling is future work.
-        if (range.second == _segs.end()) {
-            return std::nullopt;
+        if (std::distance(first, last) >= 2) {
+            return std::make_pair(first, last);
         }
-        ++range.first;
-        ++range.second;
-    }
-
-    // the chosen segments all need to be stable
-    const auto unstable = std::any_of(
-      range.first, range.second, [](ss::lw_shared_ptr<segment>& seg) {
-          return seg->has_appender();
-      });
-    if (unstable) {
-        return std::nullopt;
     }
-
-    return range;
+    return std::nullopt;
 }
 
 ss::future<compaction_result> disk_log_impl::compact_adjacent_segments(
@@ -489,16 +474,23 @@ ss::future<compaction_result> disk_log_impl::compact_adjacent_segments(
     // this could occur if racing with functions like truncate which manipulate
     // the segment set before acquiring segment locks. this also means that the
     // input iterator range may not longer be valid so we must manually search
-    // the segment set.  the current adjacent segment compaction limits
-    // compaction to two segments, and we check that assumption here and use
-    // simplified clean-up routine.
+    // the segment set for each of them. all of them leave the set before any
+    // is closed so that readers are never directed to a closing segment.
     locks.clear();
-    vassert(segments.size() == 2, "Cannot compact more than two segments");
-    auto it = std::find(_segs.begin(), _segs.end(), segments.back());
-    if (it != _segs.end()) {
+    std::vector<ss::lw_shared_ptr<segment>> redundant;
+    redundant.reserve(segments.size() - 1);
+    for (size_t i = 1; i < segments.size(); ++i) {
+        const auto& segment = segments[i];
+        auto it = std::find(_segs.begin(), _segs.end(), segment);
+        if (it == _segs.end()) {
+            continue;
+        }
         _segs.erase(it, std::next(it));
+        redundant.push_back(segment);
+    }
+    for (auto& segment : redundant) {
         co_await remove_segment_permanently(
-          segments.back(), "compact_adjacent_segments");
+          segment, "compact_adjacent_segments");
     }
 
     co_return ret;
@@ -698,6 +690,7 @@ ss::future<> disk_log_impl::new_segment(
                 if (config().is_compacted()) {
                     h->mark_as_compacted_segment();
                 }
+                _manager.index_residency().manage(h->index());
                 _segs.add(std::move(h));
                 _probe.segment_created();
                 _stm_manager->make_snapshot_in_background();
@@ -828,7 +821,12 @@ disk_log_impl::make_cached_reader(log_reader_config config) {
     }
     return _lock_mngr.range_lock(config)
       .then([this, cfg = config](std::unique_ptr<lock_manager::lease> lease) {
-          return std::make_unique<log_reader>(std::move(lease), cfg, _probe);
+          auto rdr = std::make_unique<log_reader>(
+            std::move(lease), cfg, _probe);
+          // no cached reader continues from this offset, until the new one
+          // proves to be sequential treat it as a random read
+          rdr->readahead().on_seek();
+          return rdr;
       })
       .then([this](auto rdr) { return _readers_cache->put(std::move(rdr)); });
 }
@@ -1080,6 +1078,11 @@ ss::future<> disk_log_impl::do_truncate(truncate_config cfg) {
     if (cfg.base_offset > last.offsets().dirty_offset) {
         return ss::make_ready_future<>();
     }
+    if (last.index().is_evicted()) {
+        // a lookup on an evicted index would scan from the segment start
+        return last.index().hydrate().then(
+          [this, cfg, seg = _segs.back()] { return do_truncate(cfg); });
+    }
     auto pidx = last.index().find_nearest(cfg.base_offset);
     model::offset start = last.index().base_offset();
     size_t initial_size = 0;
@@ -0,0 +1,163 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/index_residency_manager.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "storage/logger.h"
+#include "vassert.h"
+#include "vlog.h"
+
+#include <seastar/core/metrics.hh>
+
+namespace storage {
+
+index_residency_manager::index_residency_manager(
+  config::binding<std::optional<size_t>> budget)
+  : _budget(std::move(budget)) {
+    _budget.watch([this] { maybe_evict(); });
+}
+
+index_residency_manager::~index_residency_manager() noexcept {
+    // indices may outlive the manager in tests, detach them
+    while (!_lru.empty()) {
+        forget(_lru.front());
+    }
+    while (!_pinned.empty()) {
+        forget(_pinned.front());
+    }
+}
+
+void index_residency_manager::manage(segment_index& idx) {
+    vassert(
+      idx._residency == nullptr,
+      "index {} is already under residency management",
+      idx);
+    idx._residency = this;
+    ++_managed;
+    relist(idx);
+    account(idx);
+    maybe_evict();
+}
+
+void index_residency_manager::forget(segment_index& idx) {
+    _resident_bytes -= idx._resident_bytes;
+    idx._resident_bytes = 0;
+    idx._residency = nullptr;
+    idx._residency_hook.unlink();
+    --_managed;
+}
+
+void index_residency_manager::account(segment_index& idx) {
+    const auto bytes = idx.memory_usage();
+    _resident_bytes = _resident_bytes - idx._resident_bytes + bytes;
+    idx._resident_bytes = bytes;
+}
+
+void index_residency_manager::touch(segment_index& idx) {
+    if (idx.is_evicted()) {
+        ++_misses;
+    } else {
+        ++_hits;
+    }
+    // promote to most recently used. appends to the active segment grow its
+    // index in between lookups, re-account it while we are here.
+    relist(idx);
+    account(idx);
+}
+
+void index_residency_manager::relist(segment_index& idx) {
+    idx._residency_hook.unlink();
+    if (idx._evictable && !idx._evicted) {
+        _lru.push_front(idx);
+    } else {
+        _pinned.push_front(idx);
+    }
+}
+
+void index_residency_manager::hydrated(segment_index& idx) {
+    ++_misses;
+    ++_hydrations;
+    relist(idx);
+    account(idx);
+    maybe_evict(&idx);
+}
+
+void index_residency_manager::evictable(segment_index& idx) {
+    relist(idx);
+    account(idx);
+    maybe_evict();
+}
+
+void index_residency_manager::maybe_evict(const segment_index* keep) {
+    const auto budget = _budget();
+    if (!budget || _resident_bytes <= *budget) {
+        return;
+    }
+    // walk from the least recently used end. indices that cannot be evicted
+    // right now (pending flushes) are skipped and stay in place
+    auto it = _lru.end();
+    while (it != _lru.begin() && _resident_bytes > *budget) {
+        auto& idx = *--it;
+        if (&idx == keep || !idx.can_evict()) {
+            continue;
+        }
+        idx.evict();
+        account(idx);
+        ++_evictions;
+        it = _lru.erase(it);
+        _pinned.push_front(idx);
+    }
+    if (_resident_bytes > *budget) {
+        vlog(
+          stlog.debug,
+          "Resident segment indices {} bytes over budget {} bytes, nothing "
+          "left to evict",
+          _resident_bytes,
+          *budget);
+    }
+}
+
+void index_residency_manager::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:segment_index"),
+      {
+        sm::make_gauge(
+          "resident_bytes",
+          [this] { return _resident_bytes; },
+          sm::description("Bytes of segment index entries held in memory")),
+        sm::make_gauge(
+          "managed_indices",
+          [this] { return _managed; },
+          sm::description("Number of segment indices under management")),
+        sm::make_derive(
+          "hits",
+          [this] { return _hits; },
+          sm::description("Lookups on a resident segment index")),
+        sm::make_derive(
+          "misses",
+          [this] { return _misses; },
+          sm::description("Lookups on an evicted segment index")),
+        sm::make_derive(
+          "evictions",
+          [this] { return _evictions; },
+          sm::description("Number of segment indices evicted from memory")),
+        sm::make_derive(
+          "hydrations",
+          [this] { return _hydrations; },
+          sm::description("Number of segment indices loaded back from disk")),
+      });
+}
+
+} // namespace storage
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/property.h"
+#include "seastarx.h"
+#include "storage/segment_index.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <seastar/core/metrics_registration.hh>
+
+#include <optional>
+
+namespace storage {
+
+/**
+ * Per-shard manager of the memory held by segment indices.
+ *
+ * Every segment keeps an index_state with one entry per indexed batch. For
+ * brokers with many segments most of these indices are cold. The manager
+ * tracks all indices of a shard in LRU order and, when the resident size
+ * goes over the configured budget, drops the entries of the least recently
+ * used indices that are persisted and belong to segments that are no longer
+ * being appended to. Evicted indices keep their offset and timestamp bounds
+ * and are read back from their index file on demand (segment_index::hydrate).
+ *
+ * Only the indices of rolled segments that are resident are kept in LRU
+ * order. Indices of active segments and evicted indices hold no memory that
+ * could be released and are kept apart, so that eviction never walks them.
+ *
+ * Without a budget nothing is ever evicted.
+ */
+class index_residency_manager {
+public:
+    explicit index_residency_manager(
+      config::binding<std::optional<size_t>> budget);
+    ~index_residency_manager() noexcept;
+    index_residency_manager(index_residency_manager&&) = delete;
+    index_residency_manager& operator=(index_residency_manager&&) = delete;
+    index_residency_manager(const index_residency_manager&) = delete;
+    index_residency_manager& operator=(const index_residency_manager&) = delete;
+
+    /// brings an index under management. the index unregisters itself on
+    /// destruction
+    void manage(segment_index&);
+
+    size_t resident_bytes() const { return _resident_bytes; }
+
+    void setup_metrics();
+
+private:
+    friend class segment_index;
+
+    /// lookup on a managed index
+    void touch(segment_index&);
+    /// moves the index to the front of the list matching its state
+    void relist(segment_index&);
+    /// evicted index was loaded back in memory
+    void hydrated(segment_index&);
+    /// the segment of the index was rolled or became active again
+    void evictable(segment_index&);
+    void forget(segment_index&);
+
+    void account(segment_index&);
+    /// evicts least recently used indices until the budget is met. `keep`,
+    /// an index that was just hydrated for a lookup, is never evicted here:
+    /// it would be read back right away when it alone is over the budget
+    void maybe_evict(const segment_index* keep = nullptr);
+
+    config::binding<std::optional<size_t>> _budget;
+    // resident indices of rolled segments, candidates for eviction
+    intrusive_list<segment_index, &segment_index::_residency_hook> _lru;
+    // indices of active segments and evicted indices
+    intrusive_list<segment_index, &segment_index::_residency_hook> _pinned;
+    size_t _resident_bytes{0};
+    size_t _managed{0};
+
+    uint64_t _hits{0};
+    uint64_t _misses{0};
+    uint64_t _evictions{0};
+    uint64_t _hydrations{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
@@ -42,6 +42,7 @@
 #include <seastar/core/thread.hh>
 #include <seastar/core/with_scheduling_group.hh>
 
+#include <boost/range/irange.hpp>
 #include <fmt/format.h>
 
 #include <chrono>
@@ -56,7 +57,9 @@ log_manager::log_manager(log_config config, kvstore& kvstore) noexcept
   : _config(std::move(config))
   , _kvstore(kvstore)
   , _jitter(_config.compaction_interval())
-  , _batch_cache(config.reclaim_opts) {
+  , _batch_cache(config.reclaim_opts)
+  , _index_residency(
+      config::shard_local_cfg().storage_segment_index_memory_budget.bind()) {
     _compaction_timer.set_callback([this] { trigger_housekeeping(); });
     _compaction_timer.rearm(_jitter());
 
@@ -105,6 +108,27 @@ static inline logs_type::iterator find_next_non_compacted_log(logs_type& logs) {
 ss::future<> log_manager::housekeeping() {
     auto collection_threshold = model::timestamp(
       model::timestamp::now().value() - _config.delete_retention().count());
+    /**
+     * Several workers pull logs from the same map. A worker picks the next
+     * log and flags it as compacted without a scheduling point in between, so
+     * a log is never picked by two workers in the same round.
+     */
+    const auto workers = std::min(_max_concurrent_compactions, _logs.size());
+    using bflags = log_housekeeping_meta::bitflags;
+    return ss::parallel_for_each(
+             boost::irange<size_t>(0, workers),
+             [this, collection_threshold](size_t) {
+                 return housekeeping_worker(collection_threshold);
+             })
+      .finally([this] {
+          for (auto& h : _logs) {
+              h.second.flags &= ~bflags::compacted;
+          }
+      });
+}
+
+ss::future<>
+log_manager::housekeeping_worker(model::timestamp collection_threshold) {
     /**
      * Note that this loop does a double find - which is not fast. This solution
      * is the tradeoff to *not* lock the segment during log_manager::remove(ntp)
@@ -122,33 +146,28 @@ ss::future<> log_manager::housekeeping() {
      */
     using bflags = log_housekeeping_meta::bitflags;
     return ss::do_until(
-             [this] {
-                 auto it = find_next_non_compacted_log(_logs);
-                 return it == _logs.end();
-             },
-             [this, collection_threshold] {
-                 return ss::with_scheduling_group(
-                   _config.compaction_sg, [this, collection_threshold] {
-                       auto it = find_next_non_compacted_log(_logs);
-                       if (it == _logs.end()) {
-                           // must check again because between the stop
-                           // condition and this continuation we might have
-                           // removed the log
-                           return ss::now();
-                       }
-                       it->second.flags |= bflags::compacted;
-                       it->second.last_compaction = ss::lowres_clock::now();
-                       return it->second.handle.compact(compaction_config(
-                         collection_threshold,
-                         _config.retention_bytes(),
-                         _config.compaction_priority,
-                         _abort_source));
-                   });
-             })
-      .finally([this] {
-          for (auto& h : _logs) {
-              h.second.flags &= ~bflags::compacted;
-          }
+      [this] {
+          auto it = find_next_non_compacted_log(_logs);
+          return it == _logs.end();
+      },
+      [this, collection_threshold] {
+          return ss::with_scheduling_group(
+            _config.compaction_sg, [this, collection_threshold] {
+                auto it = find_next_non_compacted_log(_logs);
+                if (it == _logs.end()) {
+                    // must check again because between the stop
+                    // condition and this continuation we might have
+                    // removed the log
+                    return ss::now();
+                }
+                it->second.flags |= bflags::compacted;
+                it->second.last_compaction = ss::lowres_clock::now();
+                return it->second.handle.compact(compaction_config(
+                  collection_threshold,
+                  _config.retention_bytes(),
+                  _config.compaction_priority,
+                  _abort_source));
+            });
       });
 }
 
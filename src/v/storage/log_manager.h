@@ -16,6 +16,7 @@
 #include "random/simple_time_jitter.h"
 #include "seastarx.h"
 #include "storage/batch_cache.h"
+#include "storage/index_residency_manager.h"
 #include "storage/log.h"
 #include "storage/log_housekeeping_meta.h"
 #include "storage/ntp_config.h"
@@ -225,6 +226,19 @@ public:
 
     int64_t compaction_backlog() const;
 
+    /// Number of logs compacted concurrently by housekeeping. Driven by the
+    /// compaction controller; takes effect on the next housekeeping round.
+    void set_max_concurrent_compactions(size_t n) {
+        _max_concurrent_compactions = std::max<size_t>(n, 1);
+    }
+    size_t max_concurrent_compactions() const {
+        return _max_concurrent_compactions;
+    }
+
+    index_residency_manager& index_residency() { return _index_residency; }
+
+    batch_cache& cache() { return _batch_cache; }
+
 private:
     using logs_type = absl::flat_hash_map<model::ntp, log_housekeeping_meta>;
 
@@ -236,6 +250,7 @@ private:
      */
     void trigger_housekeeping();
     ss::future<> housekeeping();
+    ss::future<> housekeeping_worker(model::timestamp collection_threshold);
 
     std::optional<batch_cache_index> create_cache(with_cache);
 
@@ -248,6 +263,8 @@ private:
     ss::timer<ss::lowres_clock> _compaction_timer;
     logs_type _logs;
     batch_cache _batch_cache;
+    index_residency_manager _index_residency;
+    size_t _max_concurrent_compactions{1};
     ss::gate _open_gate;
     ss::abort_source _abort_source;
 
@@ -10,6 +10,7 @@
 #include "storage/log_reader.h"
 
 #include "bytes/iobuf.h"
+#include "config/configuration.h"
 #include "model/record.h"
 #include "storage/logger.h"
 #include "vassert.h"
@@ -123,15 +124,22 @@ void skipping_consumer::print(std::ostream& os) const {
 }
 
 log_segment_batch_reader::log_segment_batch_reader(
-  segment& seg, log_reader_config& config, probe& p) noexcept
+  segment& seg,
+  log_reader_config& config,
+  probe& p,
+  readahead_policy& readahead) noexcept
   : _seg(seg)
   , _config(config)
-  , _probe(p) {}
+  , _probe(p)
+  , _readahead(readahead) {}
 
 std::unique_ptr<continuous_batch_parser> log_segment_batch_reader::initialize(
   model::timeout_clock::time_point timeout,
   std::optional<model::offset> next_cached_batch) {
-    auto input = _seg.offset_data_stream(_config.start_offset, _config.prio);
+    _window = _readahead.window(_seg.reader().default_window());
+    _probe.set_read_window(_window.bytes());
+    auto input = _seg.offset_data_stream(
+      _config.start_offset, _config.prio, _window);
     return std::make_unique<continuous_batch_parser>(
       std::make_unique<skipping_consumer>(*this, timeout, next_cached_batch),
       std::move(input));
@@ -152,6 +160,7 @@ void log_segment_batch_reader::add_one(model::record_batch&& batch) {
     _config.bytes_consumed += size_bytes;
     _state.buffer_size += size_bytes;
     _probe.add_bytes_read(size_bytes);
+    _readahead.on_sequential(size_bytes, _seg.reader().default_window());
     if (!_config.skip_batch_cache) {
         _seg.cache_put(b);
     }
@@ -196,7 +205,26 @@ log_segment_batch_reader::read_some(model::timeout_clock::time_point timeout) {
     }
 
     if (!_iterator) {
+        if (unlikely(_seg.index().is_evicted() && !_index_hydrated)) {
+            // position the reader using the index rather than scanning from
+            // the start of the segment. hydrate once: if the index is evicted
+            // again before the reader is positioned it scans instead.
+            _index_hydrated = true;
+            return _seg.index().hydrate().then(
+              [this, timeout] { return read_some(timeout); });
+        }
         _iterator = initialize(timeout, cache_read.next_cached_batch);
+    } else if (
+      _readahead.window(_seg.reader().default_window()) != _window) {
+        // the access pattern changed since the stream was opened. reopen it
+        // at the next batch with the new window
+        _probe.read_window_changed();
+        auto ptr = _iterator.get();
+        return ptr->close().then([this, timeout] {
+            _iterator = nullptr;
+            _index_hydrated = false;
+            return read_some(timeout);
+        });
     }
     auto ptr = _iterator.get();
     return ptr->consume().then(
@@ -216,7 +244,9 @@ log_reader::log_reader(
   : _lease(std::move(l))
   , _iterator(_lease->range.begin())
   , _config(config)
-  , _probe(probe) {
+  , _probe(probe)
+  , _readahead(
+      config::shard_local_cfg().storage_read_readahead_max_bytes()) {
     if (config.abort_source) {
         auto op_sub = config.abort_source.value().get().subscribe(
           [this]() noexcept { set_end_of_stream(); });
@@ -231,7 +261,7 @@ log_reader::log_reader(
 
     if (_iterator.next_seg != _lease->range.end()) {
         _iterator.reader = std::make_unique<log_segment_batch_reader>(
-          **_iterator.next_seg, _config, _probe);
+          **_iterator.next_seg, _config, _probe, _readahead);
     }
 }
 
@@ -251,7 +281,7 @@ ss::future<> log_reader::find_next_valid_iterator() {
     }
     if (_iterator.next_seg != _lease->range.end()) {
         _iterator.reader = std::make_unique<log_segment_batch_reader>(
-          **_iterator.next_seg, _config, _probe);
+          **_iterator.next_seg, _config, _probe, _readahead);
         _iterator.current_reader_seg = _iterator.next_seg;
     }
     if (tmp_reader) {
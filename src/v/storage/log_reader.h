@@ -17,6 +17,7 @@
 #include "storage/lock_manager.h"
 #include "storage/parser.h"
 #include "storage/probe.h"
+#include "storage/readahead_policy.h"
 #include "storage/segment_reader.h"
 #include "storage/segment_set.h"
 #include "storage/types.h"
@@ -91,7 +92,10 @@ public:
     static constexpr size_t max_buffer_size = 32 * 1024; // 32KB
 
     log_segment_batch_reader(
-      segment&, log_reader_config& config, probe& p) noexcept;
+      segment&,
+      log_reader_config& config,
+      probe& p,
+      readahead_policy& readahead) noexcept;
     log_segment_batch_reader(log_segment_batch_reader&&) noexcept = default;
     log_segment_batch_reader&
     operator=(log_segment_batch_reader&&) noexcept = delete;
@@ -122,8 +126,13 @@ private:
     segment& _seg;
     log_reader_config& _config;
     probe& _probe;
+    readahead_policy& _readahead;
 
     std::unique_ptr<continuous_batch_parser> _iterator;
+    // window of the stream backing `_iterator`
+    read_window _window;
+    // the evicted segment index was loaded back to position `_iterator`
+    bool _index_hydrated{false};
     tmp_state _state;
     friend class skipping_consumer;
 };
@@ -165,6 +174,9 @@ public:
      * 3. read next chunk of batches
      */
     void reset_config(log_reader_config cfg) {
+        if (cfg.start_offset != _config.start_offset) {
+            _readahead.on_seek();
+        }
         _config = cfg;
         _iterator.next_seg = _iterator.current_reader_seg;
     };
@@ -203,6 +215,8 @@ public:
      */
     bool is_reusable() const { return _iterator.reader != nullptr; }
 
+    readahead_policy& readahead() { return _readahead; }
+
 private:
     void set_end_of_stream() { _iterator.next_seg = _lease->range.end(); }
     bool is_done();
@@ -236,6 +250,7 @@ private:
     log_reader_config _config;
     model::offset _last_base;
     probe& _probe;
+    readahead_policy _readahead;
     ss::abort_source::subscription _as_sub;
 };
 
@@ -11,6 +11,7 @@
 
 #include "config/configuration.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "storage/batch_cache_probe.h"
 #include "storage/readers_cache_probe.h"
 #include "storage/segment.h"
 
@@ -140,6 +141,36 @@ void probe::setup_metrics(const model::ntp& ntp) {
           [this] { return _segment_compacted; },
           sm::description("Number of compacted segments"),
           labels),
+        sm::make_derive(
+          "compaction_spill_runs",
+          [this] { return _compaction_spill_runs; },
+          sm::description("Number of sorted key runs spilled to disk while "
+                          "compacting segments"),
+          labels),
+        sm::make_total_bytes(
+          "compaction_spill_bytes",
+          [this] { return _compaction_spill_bytes; },
+          sm::description("Total number of bytes of sorted key runs spilled "
+                          "to disk while compacting segments"),
+          labels),
+        sm::make_derive(
+          "compaction_merge_time_us",
+          [this] { return _compaction_merge_time_us; },
+          sm::description("Total time spent merging spilled key runs, in "
+                          "microseconds"),
+          labels),
+        sm::make_gauge(
+          "read_window_bytes",
+          [this] { return _read_window_bytes; },
+          sm::description("Bytes in flight of the last segment stream opened "
+                          "by a reader, as chosen by its read-ahead policy"),
+          labels),
+        sm::make_derive(
+          "read_window_changes",
+          [this] { return _read_window_changes; },
+          sm::description("Number of segment streams reopened because the "
+                          "reader access pattern changed"),
+          labels),
         sm::make_gauge(
           "partition_size",
           [this] { return _partition_bytes; },
@@ -199,4 +230,54 @@ void readers_cache_probe::setup_metrics(const model::ntp& ntp) {
           labels),
       });
 }
+void batch_cache_probe::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:batch_cache"),
+      {
+        sm::make_derive(
+          "hits",
+          [this] { return _hits; },
+          sm::description("Lookups served from the batch cache")),
+        sm::make_derive(
+          "compressed_hits",
+          [this] { return _compressed_hits; },
+          sm::description(
+            "Lookups served by promoting a range from the compressed tier")),
+        sm::make_derive(
+          "misses",
+          [this] { return _misses; },
+          sm::description("Lookups that missed both tiers")),
+        sm::make_gauge(
+          "hit_ratio",
+          [this] { return hit_ratio(); },
+          sm::description("Ratio of lookups served from the first tier")),
+        sm::make_gauge(
+          "compressed_hit_ratio",
+          [this] { return compressed_hit_ratio(); },
+          sm::description("Ratio of first tier misses served from the "
+                          "compressed tier")),
+        sm::make_derive(
+          "ranges_demoted",
+          [this] { return _ranges_demoted; },
+          sm::description("Ranges moved to the compressed tier")),
+        sm::make_gauge(
+          "compressed_bytes",
+          [this] { return _compressed_bytes; },
+          sm::description("Memory used by the compressed tier")),
+        sm::make_total_bytes(
+          "decompressed_bytes",
+          [this] { return _decompressed_bytes; },
+          sm::description("Bytes decompressed promoting ranges")),
+        sm::make_derive(
+          "decompression_time_us",
+          [this] { return _decompression_time_us; },
+          sm::description(
+            "Time spent decompressing promoted ranges, in microseconds")),
+      });
+}
+
 } // namespace storage
@@ -18,6 +18,7 @@
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <chrono>
 #include <cstdint>
 
 namespace storage {
@@ -68,6 +69,14 @@ public:
 
     void segment_compacted() { ++_segment_compacted; }
 
+    void add_compaction_spill_bytes(uint64_t bytes) {
+        ++_compaction_spill_runs;
+        _compaction_spill_bytes += bytes;
+    }
+    void add_compaction_merge_time(std::chrono::microseconds t) {
+        _compaction_merge_time_us += t.count();
+    }
+
     void batch_write_error(const std::exception_ptr& e) {
         stlog.error("Error writing record batch {}", e);
         ++_batch_write_errors;
@@ -80,6 +89,9 @@ public:
 
     void batch_parse_error() { ++_batch_parse_errors; }
 
+    void set_read_window(uint64_t bytes) { _read_window_bytes = bytes; }
+    void read_window_changed() { ++_read_window_changes; }
+
     void setup_metrics(const model::ntp&);
 
     void delete_segment(const segment&);
@@ -99,7 +111,14 @@ private:
     uint64_t _batches_read = 0;
     uint64_t _cached_batches_read = 0;
 
+    uint64_t _compaction_spill_bytes = 0;
+    uint64_t _compaction_merge_time_us = 0;
+
+    uint64_t _read_window_bytes = 0;
+    uint64_t _read_window_changes = 0;
+
     uint32_t _segment_compacted = 0;
+    uint32_t _compaction_spill_runs = 0;
     uint32_t _corrupted_compaction_index = 0;
     uint32_t _log_segments_created = 0;
     uint32_t _log_segments_removed = 0;
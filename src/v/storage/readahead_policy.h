@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "storage/segment_reader.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace storage {
+
+/**
+ * Sizes the read window of the streams a log reader opens, based on how the
+ * reader is being used. The window of a segment is configured through
+ * `storage_read_buffer_size` and `storage_read_readahead_count`:
+ *
+ *  - after a seek (e.g. a reader created on a readers cache miss) only a
+ *    single buffer is read ahead, a random read rarely uses more.
+ *  - every time the reader consumes a full window from disk in order, the
+ *    window is doubled, first the read-ahead count and then the buffer size,
+ *    up to `max_window_bytes`. Long scans, like catch-up consumers or raft
+ *    recovery, end up with a few large reads in flight.
+ *
+ * The policy lives with the log reader, so cached readers that are reused for
+ * consecutive reads keep growing their window.
+ */
+class readahead_policy {
+public:
+    static constexpr unsigned seek_read_ahead = 1;
+    static constexpr unsigned max_read_ahead = 32;
+
+    explicit readahead_policy(size_t max_window_bytes) noexcept
+      : _max_window_bytes(max_window_bytes) {}
+
+    /// window of a stream over a segment configured with `base`
+    read_window window(read_window base) const {
+        if (_level < 0) {
+            return {
+              base.buffer_size, std::min(base.read_ahead, seek_read_ahead)};
+        }
+        auto w = base;
+        for (int i = 0; i < _level; ++i) {
+            auto next = grow(w);
+            if (next == w) {
+                break;
+            }
+            w = next;
+        }
+        return w;
+    }
+
+    /// accounts bytes read in order from disk. returns true when the window
+    /// grew; streams opened before that keep their window
+    bool on_sequential(size_t bytes, read_window base) {
+        _sequential_bytes += bytes;
+        const auto current = window(base);
+        if (_sequential_bytes < current.bytes()) {
+            return false;
+        }
+        _sequential_bytes = 0;
+        if (_level >= 0 && grow(current) == current) {
+            return false;
+        }
+        ++_level;
+        return true;
+    }
+
+    void on_seek() {
+        _level = -1;
+        _sequential_bytes = 0;
+    }
+
+private:
+    // next larger window, or `w` itself if it cannot grow anymore
+    read_window grow(read_window w) const {
+        auto next = w;
+        if (next.read_ahead < max_read_ahead) {
+            next.read_ahead = std::max(next.read_ahead * 2, 1U);
+        } else {
+            next.buffer_size *= 2;
+        }
+        if (next.bytes() > _max_window_bytes) {
+            return w;
+        }
+        return next;
+    }
+
+    size_t _max_window_bytes;
+    // < 0 after a seek, otherwise number of times the window doubled
+    int _level{0};
+    size_t _sequential_bytes{0};
+};
+
+} // namespace storage
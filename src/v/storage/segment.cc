@@ -59,6 +59,8 @@ segment::segment(
     if (_appender) {
         _appender->set_callbacks(&_appender_callbacks);
     }
+    // the index of the active segment changes with every append
+    _idx.set_evictable(!_appender);
 }
 
 void segment::check_segment_not_closed(const char* msg) {
@@ -157,6 +159,7 @@ ss::future<> segment::do_release_appender(
         std::optional<compacted_index_writer>& compacted_index) {
           return appender->close()
             .then([this] { return _idx.flush(); })
+            .then([this] { _idx.set_evictable(true); })
             .then([&compacted_index] {
                 if (compacted_index) {
                     return compacted_index->close();
@@ -451,6 +454,11 @@ ss::future<append_result> segment::append(model::record_batch&& b) {
 
 ss::input_stream<char>
 segment::offset_data_stream(model::offset o, ss::io_priority_class iopc) {
+    return offset_data_stream(o, iopc, _reader.default_window());
+}
+
+ss::input_stream<char> segment::offset_data_stream(
+  model::offset o, ss::io_priority_class iopc, read_window window) {
     check_segment_not_closed("offset_data_stream()");
     auto nearest = _idx.find_nearest(o);
     size_t position = 0;
@@ -462,7 +470,7 @@ segment::offset_data_stream(model::offset o, ss::io_priority_class iopc) {
     // size) (https://github.com/redpanda-data/redpanda/issues/2101)
     vassert(position < size_bytes(), "Index points beyond file size");
 
-    return _reader.data_stream(position, iopc);
+    return _reader.data_stream(position, iopc, window);
 }
 
 void segment::advance_stable_offset(size_t offset) {
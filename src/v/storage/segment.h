@@ -93,6 +93,8 @@ public:
     /// main read interface
     ss::input_stream<char>
       offset_data_stream(model::offset, ss::io_priority_class);
+    ss::input_stream<char>
+      offset_data_stream(model::offset, ss::io_priority_class, read_window);
 
     const offset_tracker& offsets() const { return _tracker; }
     bool empty() const;
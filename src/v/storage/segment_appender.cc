@@ -13,6 +13,7 @@
 #include "likely.h"
 #include "storage/chunk_cache.h"
 #include "storage/logger.h"
+#include "storage/write_coalescer.h"
 #include "vassert.h"
 #include "vlog.h"
 
@@ -37,10 +38,10 @@ namespace storage {
  * option for avoiding this is to do more aligned appends or add a special
  * padding batch that is read and then fully ignored by the parser.
  *
- * 2. flush operations are completed asynchronously when writes complete. there
- * is not reason to do this so aggresively. we could potentially reduce the
- * amount of flushing by using a bytes or time heuristic. we'd increase the
- * latency of each flush, but we'd dispatch less physical flush operations.
+ * 2. flush operations are completed asynchronously when writes complete. the
+ * physical flushes are handed to the per-shard write coalescer, which merges
+ * the requests of all appenders made in the same task quota and never runs
+ * more than one flush per file at a time.
  */
 
 [[gnu::cold]] static ss::future<>
@@ -401,16 +402,13 @@ ss::future<> segment_appender::process_flush_ops(size_t committed) {
 
     _flush_ops.erase(flushable, _flush_ops.end());
 
-    return _out.flush().then([this, committed, ops = std::move(ops)]() mutable {
-        _flushed_offset = committed;
-        /*
-         * TODO: as an optimization, add a little house keeping to determine if
-         * eligible flush operations showed up while flush() was completing.
-         */
-        for (auto& op : ops) {
-            op.p.set_value();
-        }
-    });
+    return internal::coalescer().flush(this, _out).then(
+      [this, committed, ops = std::move(ops)]() mutable {
+          _flushed_offset = committed;
+          for (auto& op : ops) {
+              op.p.set_value();
+          }
+      });
 }
 
 void segment_appender::dispatch_background_head_write() {
@@ -536,9 +534,11 @@ ss::future<> segment_appender::flush() {
       _stable_offset,
       *this);
 
-    return _out.flush().handle_exception([this](std::exception_ptr e) {
-        vassert(false, "Could not flush: {} - {}", e, *this);
-    });
+    return internal::coalescer()
+      .flush(this, _out)
+      .handle_exception([this](std::exception_ptr e) {
+          vassert(false, "Could not flush: {} - {}", e, *this);
+      });
 }
 
 ss::future<> segment_appender::hard_flush() {
@@ -11,6 +11,7 @@
 
 #include "model/timestamp.h"
 #include "serde/serde.h"
+#include "storage/index_residency_manager.h"
 #include "storage/index_state.h"
 #include "storage/logger.h"
 #include "vassert.h"
@@ -45,21 +46,133 @@ segment_index::segment_index(
     _state.base_offset = base;
 }
 
+segment_index::~segment_index() noexcept {
+    if (_residency) {
+        _residency->forget(*this);
+    }
+}
+
+segment_index::segment_index(segment_index&& o) noexcept
+  : _name(std::move(o._name))
+  , _out(std::move(o._out))
+  , _step(o._step)
+  , _acc(o._acc)
+  , _needs_persistence(o._needs_persistence)
+  , _flushing(o._flushing)
+  , _evicted(o._evicted)
+  , _evictable(o._evictable)
+  , _state(std::move(o._state)) {}
+
+segment_index& segment_index::operator=(segment_index&& o) noexcept {
+    if (this != &o) {
+        if (_residency) {
+            _residency->forget(*this);
+        }
+        _name = std::move(o._name);
+        _out = std::move(o._out);
+        _step = o._step;
+        _acc = o._acc;
+        _needs_persistence = o._needs_persistence;
+        _flushing = o._flushing;
+        _evicted = o._evicted;
+        _evictable = o._evictable;
+        _state = std::move(o._state);
+    }
+    return *this;
+}
+
 void segment_index::reset() {
     auto base = _state.base_offset;
     _state = {};
     _state.base_offset = base;
     _acc = 0;
+    _evicted = false;
+    touch();
 }
 
 void segment_index::swap_index_state(index_state&& o) {
     _needs_persistence = true;
     _acc = 0;
+    _evicted = false;
     std::swap(_state, o);
+    touch();
+}
+
+size_t segment_index::memory_usage() const {
+    return _state.relative_offset_index.memory_size()
+           + _state.relative_time_index.memory_size()
+           + _state.position_index.memory_size();
+}
+
+bool segment_index::can_evict() const {
+    // while a flush is in progress the file is truncated and rewritten, so
+    // it cannot be used to hydrate the index
+    return _evictable && !_evicted && !_needs_persistence && !_flushing
+           && !_state.empty();
+}
+
+size_t segment_index::evict() {
+    vassert(can_evict(), "Cannot evict index: {}", *this);
+    const auto released = memory_usage();
+    // only the entries are dropped, the offset and timestamp bounds are used
+    // by segment lookups and must stay resident
+    _state.relative_offset_index = {};
+    _state.relative_time_index = {};
+    _state.position_index = {};
+    _evicted = true;
+    return released;
+}
+
+void segment_index::set_evictable(bool e) {
+    _evictable = e;
+    if (_residency) {
+        _residency->evictable(*this);
+    }
+}
+
+void segment_index::touch() {
+    if (_residency) {
+        _residency->touch(*this);
+    }
+}
+
+ss::future<> segment_index::hydrate() {
+    if (!_evicted) {
+        touch();
+        co_return;
+    }
+    auto size = co_await _out.size();
+    auto buf = co_await _out.dma_read_bulk<char>(0, size);
+    if (!_evicted) {
+        // raced with a concurrent hydration or with an operation that
+        // replaced the index state
+        co_return;
+    }
+    _evicted = false;
+    iobuf b;
+    b.append(std::move(buf));
+    try {
+        auto st = serde::from_iobuf<index_state>(std::move(b));
+        _state.relative_offset_index = std::move(st.relative_offset_index);
+        _state.relative_time_index = std::move(st.relative_time_index);
+        _state.position_index = std::move(st.position_index);
+    } catch (const serde::serde_exception& ex) {
+        // the index is only an optimization. with no entries lookups fall
+        // back to scanning the segment from its start
+        vlog(
+          stlog.warn,
+          "Unable to hydrate evicted index {}: {}",
+          _name,
+          ex.what());
+    }
+    if (_residency) {
+        _residency->hydrated(*this);
+    }
 }
 
 void segment_index::maybe_track(
   const model::record_batch_header& hdr, size_t filepos) {
+    vassert(!_evicted, "Cannot track batches on an evicted index: {}", *this);
     _acc += hdr.size_bytes;
     if (_state.maybe_index(
           _acc,
@@ -76,6 +189,7 @@ void segment_index::maybe_track(
 
 std::optional<segment_index::entry>
 segment_index::find_nearest(model::timestamp t) {
+    touch();
     if (t < _state.base_timestamp) {
         return std::nullopt;
     }
@@ -97,6 +211,7 @@ segment_index::find_nearest(model::timestamp t) {
 
 std::optional<segment_index::entry>
 segment_index::find_nearest(model::offset o) {
+    touch();
     if (o < _state.base_offset || _state.empty()) {
         return std::nullopt;
     }
@@ -124,6 +239,7 @@ ss::future<> segment_index::truncate(model::offset o) {
     if (o < _state.base_offset) {
         co_return;
     }
+    co_await hydrate();
     const uint32_t i = o() - _state.base_offset();
     auto it = std::lower_bound(
       std::begin(_state.relative_offset_index),
@@ -165,6 +281,8 @@ ss::future<bool> segment_index::materialize_index() {
     b.append(std::move(buf));
     try {
         _state = serde::from_iobuf<index_state>(std::move(b));
+        _evicted = false;
+        touch();
         co_return true;
     } catch (const serde::serde_exception& ex) {
         vlog(
@@ -185,14 +303,25 @@ ss::future<> segment_index::flush() {
         co_return;
     }
     _needs_persistence = false;
-    co_await _out.truncate(0);
-    auto out = co_await ss::make_file_output_stream(ss::file(_out.dup()));
+    // serialize before the first scheduling point. the index may not be
+    // evicted while _flushing is set, but the state must still be captured
+    // before the file is truncated.
     auto b = serde::to_iobuf(_state.copy());
-    for (const auto& f : b) {
-        co_await out.write(f.get(), f.size());
+    _flushing = true;
+    try {
+        co_await _out.truncate(0);
+        auto out = co_await ss::make_file_output_stream(
+          ss::file(_out.dup()));
+        for (const auto& f : b) {
+            co_await out.write(f.get(), f.size());
+        }
+        co_await out.flush();
+        co_await out.close();
+    } catch (...) {
+        _flushing = false;
+        throw;
     }
-    co_await out.flush();
-    co_await out.close();
+    _flushing = false;
 }
 ss::future<> segment_index::close() {
     co_await flush();
@@ -201,7 +330,8 @@ ss::future<> segment_index::close() {
 std::ostream& operator<<(std::ostream& o, const segment_index& i) {
     return o << "{file:" << i.filename() << ", offsets:" << i.base_offset()
              << ", index:" << i._state << ", step:" << i._step
-             << ", needs_persistence:" << i._needs_persistence << "}";
+             << ", needs_persistence:" << i._needs_persistence
+             << ", evicted:" << i._evicted << "}";
 }
 std::ostream& operator<<(std::ostream& o, const segment_index_ptr& i) {
     if (i) {
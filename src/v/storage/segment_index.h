@@ -13,7 +13,9 @@
 #include "model/fundamental.h"
 #include "model/record.h"
 #include "model/timestamp.h"
+#include "storage/fwd.h"
 #include "storage/index_state.h"
+#include "utils/intrusive_list_helpers.h"
 
 #include <seastar/core/file.hh>
 #include <seastar/core/unaligned.hh>
@@ -50,13 +52,18 @@ public:
 
     segment_index(
       ss::sstring filename, ss::file, model::offset base, size_t step);
-    ~segment_index() noexcept = default;
-    segment_index(segment_index&&) noexcept = default;
-    segment_index& operator=(segment_index&&) noexcept = default;
+    ~segment_index() noexcept;
+    // moving an index does not transfer its index_residency_manager
+    // registration. indices are registered once owned by their segment.
+    segment_index(segment_index&&) noexcept;
+    segment_index& operator=(segment_index&&) noexcept;
     segment_index(const segment_index&) = delete;
     segment_index& operator=(const segment_index&) = delete;
 
     void maybe_track(const model::record_batch_header&, size_t filepos);
+    /// lookups on an evicted index return std::nullopt, which callers treat
+    /// as "scan from the start of the segment". call hydrate() beforehand to
+    /// get precise positions
     std::optional<entry> find_nearest(model::offset);
     std::optional<entry> find_nearest(model::timestamp);
 
@@ -83,14 +90,41 @@ public:
     bool needs_persistence() const { return _needs_persistence; }
     index_state release_index_state() && { return std::move(_state); }
 
+    /// \brief true when the index entries were dropped from memory by the
+    /// index_residency_manager. offsets and timestamps bounds stay available
+    bool is_evicted() const { return _evicted; }
+    /// \brief loads evicted entries back from the index file
+    ss::future<> hydrate();
+    /// \brief memory held by the index entries
+    size_t memory_usage() const;
+    /// \brief the index of an active segment is mutated by every append and
+    /// must never be evicted. set by the owning segment
+    void set_evictable(bool);
+    bool can_evict() const;
+
 private:
+    friend class index_residency_manager;
+
+    /// \brief drops the index entries, keeping the bounds. returns the
+    /// number of bytes released
+    size_t evict();
+    void touch();
+
     ss::sstring _name;
     ss::file _out;
     size_t _step;
     size_t _acc{0};
     bool _needs_persistence{false};
+    bool _flushing{false};
+    bool _evicted{false};
+    bool _evictable{false};
     index_state _state;
 
+    // residency tracking, owned by index_residency_manager
+    index_residency_manager* _residency{nullptr};
+    size_t _resident_bytes{0};
+    intrusive_list_hook _residency_hook;
+
     friend std::ostream& operator<<(std::ostream&, const segment_index&);
 };
 
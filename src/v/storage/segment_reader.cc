@@ -33,15 +33,20 @@ segment_reader::segment_reader(
 
 ss::input_stream<char>
 segment_reader::data_stream(size_t pos, const ss::io_priority_class& pc) {
+    return data_stream(pos, pc, default_window());
+}
+
+ss::input_stream<char> segment_reader::data_stream(
+  size_t pos, const ss::io_priority_class& pc, read_window window) {
     vassert(
       pos <= _file_size,
       "cannot read negative bytes. Asked to read at position: '{}' - {}",
       pos,
       *this);
     ss::file_input_stream_options options;
-    options.buffer_size = _buffer_size;
+    options.buffer_size = window.buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = _read_ahead;
+    options.read_ahead = window.read_ahead;
     return make_file_input_stream(
       _data_file, pos, _file_size - pos, std::move(options));
 }
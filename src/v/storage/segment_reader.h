@@ -26,6 +26,16 @@
 
 namespace storage {
 
+/// size and number of the buffers a data stream keeps in flight
+struct read_window {
+    size_t buffer_size{0};
+    unsigned read_ahead{0};
+
+    size_t bytes() const { return buffer_size * (read_ahead + 1); }
+
+    bool operator==(const read_window&) const = default;
+};
+
 class segment_reader {
 public:
     segment_reader(
@@ -61,11 +71,16 @@ public:
     /// flushes the file metadata
     ss::future<> flush() { return _data_file.flush(); }
 
+    /// the configured read window of this segment
+    read_window default_window() const { return {_buffer_size, _read_ahead}; }
+
     /// create an input stream _sharing_ the underlying file handle
     /// starting at position @pos
     ss::input_stream<char>
     data_stream(size_t pos, const ss::io_priority_class&);
     ss::input_stream<char>
+    data_stream(size_t pos, const ss::io_priority_class&, read_window);
+    ss::input_stream<char>
     data_stream(size_t pos_begin, size_t pos_end, const ss::io_priority_class&);
 
 private:
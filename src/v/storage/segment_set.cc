@@ -50,6 +50,9 @@ struct segment_ordering {
 segment_set::segment_set(segment_set::underlying_t segs)
   : _handles(std::move(segs)) {
     std::sort(_handles.begin(), _handles.end(), segment_ordering{});
+    for (const auto& h : _handles) {
+        _summary.push_back(h->offsets().base_offset);
+    }
 }
 
 void segment_set::add(ss::lw_shared_ptr<segment> h) {
@@ -63,12 +66,22 @@ void segment_set::add(ss::lw_shared_ptr<segment> h) {
           *h,
           *this);
     }
+    _summary.push_back(h->offsets().base_offset);
     _handles.emplace_back(std::move(h));
 }
 
-void segment_set::pop_back() { _handles.pop_back(); }
-void segment_set::pop_front() { _handles.pop_front(); }
+void segment_set::pop_back() {
+    _handles.pop_back();
+    _summary.pop_back();
+}
+void segment_set::pop_front() {
+    _handles.pop_front();
+    _summary.pop_front();
+}
 void segment_set::erase(iterator begin, iterator end) {
+    _summary.erase(
+      std::distance(_handles.begin(), begin),
+      std::distance(_handles.begin(), end));
     _handles.erase(begin, end);
 }
 
@@ -115,19 +128,36 @@ Iterator segments_lower_bound(Iterator begin, Iterator end, Needle needle) {
     return end;
 }
 
-/// lower_bound returns the element that is _strictly_ greater than or equal
-/// to bucket->dirty_offset() - see comparator above because our offsets are
-/// _inclusive_ we must check the previous iterator in the case that we are at
-/// the end, we also check the last element.
+/// offset lookups go through the summary index, which holds the base offsets
+/// of all segments contiguously. The summary returns the last segment whose
+/// base offset is less than or equal to the needle; that segment is the only
+/// candidate, so we dereference a single segment to check its upper bound.
+template<typename Iterator>
+Iterator segments_lower_bound(
+  Iterator begin,
+  Iterator end,
+  const segment_summary_index& summary,
+  model::offset needle) {
+    auto idx = summary.find(needle);
+    if (!idx) {
+        return end;
+    }
+    auto it = std::next(begin, *idx);
+    if (needle_in_range<Iterator>()(it, needle)) {
+        return it;
+    }
+    return end;
+}
+
 segment_set::iterator segment_set::lower_bound(model::offset offset) {
     return segments_lower_bound(
-      std::begin(_handles), std::end(_handles), offset);
+      std::begin(_handles), std::end(_handles), _summary, offset);
 }
 
 segment_set::const_iterator
 segment_set::lower_bound(model::offset offset) const {
     return segments_lower_bound(
-      std::cbegin(_handles), std::cend(_handles), offset);
+      std::cbegin(_handles), std::cend(_handles), _summary, offset);
 }
 // Lower bound for timestamp based indexing
 //
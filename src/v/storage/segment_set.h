@@ -12,6 +12,7 @@
 #pragma once
 
 #include "storage/segment.h"
+#include "storage/segment_summary_index.h"
 
 #include <seastar/core/circular_buffer.hh>
 
@@ -62,7 +63,10 @@ public:
     void pop_front();
     void erase(iterator begin, iterator end);
 
-    underlying_t release() && { return std::move(_handles); }
+    underlying_t release() && {
+        _summary.clear();
+        return std::move(_handles);
+    }
     type& back() { return _handles.back(); }
     const type& back() const { return _handles.back(); }
     const type& front() const { return _handles.front(); }
@@ -83,8 +87,12 @@ public:
     const_iterator begin() const { return _handles.begin(); }
     const_iterator end() const { return _handles.end(); }
 
+    /// top level offset index, one entry per segment
+    const segment_summary_index& summary() const { return _summary; }
+
 private:
     underlying_t _handles;
+    segment_summary_index _summary;
 
     friend std::ostream& operator<<(std::ostream&, const segment_set&);
 };
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/fundamental.h"
+#include "vassert.h"
+
+#include <seastar/core/circular_buffer.hh>
+
+#include <algorithm>
+#include <optional>
+
+namespace storage {
+
+/**
+ * Top level of the two-level offset index of a log. It keeps the base offset
+ * of every segment in a contiguous buffer, in the same order as the segments
+ * of a segment_set, so that locating the segment that holds an offset is a
+ * binary search over a dense array of integers instead of a search that
+ * dereferences every segment it visits. The second level is the per-segment
+ * index_state (see segment_index::find_nearest).
+ *
+ * Base offsets of segments never change once a segment is created, so the
+ * summary only needs to follow insertions and removals of segments. The upper
+ * bound of a segment (its dirty offset) is mutable and is checked only on the
+ * candidate segment.
+ */
+class segment_summary_index {
+public:
+    segment_summary_index() noexcept = default;
+    ~segment_summary_index() noexcept = default;
+    segment_summary_index(segment_summary_index&&) noexcept = default;
+    segment_summary_index&
+    operator=(segment_summary_index&&) noexcept = default;
+    segment_summary_index(const segment_summary_index&) = delete;
+    segment_summary_index& operator=(const segment_summary_index&) = delete;
+
+    size_t size() const { return _base_offsets.size(); }
+    bool empty() const { return _base_offsets.empty(); }
+    void clear() { _base_offsets.clear(); }
+
+    /// must be monotonically increasing
+    void push_back(model::offset base);
+    void pop_back() { _base_offsets.pop_back(); }
+    void pop_front() { _base_offsets.pop_front(); }
+    /// erases entries in positions [first, last)
+    void erase(size_t first, size_t last);
+
+    model::offset operator[](size_t i) const { return _base_offsets[i]; }
+
+    /// \brief returns the position of the last segment whose base offset is
+    /// less than or equal to the needle. The caller must still check that the
+    /// needle is below the upper bound of the segment.
+    std::optional<size_t> find(model::offset) const;
+
+    /// \brief memory used by the summary
+    size_t memory_usage() const {
+        return _base_offsets.capacity() * sizeof(model::offset);
+    }
+
+private:
+    ss::circular_buffer<model::offset> _base_offsets;
+};
+
+inline void segment_summary_index::push_back(model::offset base) {
+    vassert(
+      _base_offsets.empty() || _base_offsets.back() <= base,
+      "Segment summary must be monotonically increasing. Got:{} - Last:{}",
+      base,
+      _base_offsets.back());
+    _base_offsets.push_back(base);
+}
+
+inline void segment_summary_index::erase(size_t first, size_t last) {
+    vassert(
+      first <= last && last <= _base_offsets.size(),
+      "Invalid segment summary erase range [{}, {}) size:{}",
+      first,
+      last,
+      _base_offsets.size());
+    _base_offsets.erase(
+      std::next(_base_offsets.begin(), first),
+      std::next(_base_offsets.begin(), last));
+}
+
+inline std::optional<size_t>
+segment_summary_index::find(model::offset o) const {
+    // upper_bound so that among several empty segments sharing a base offset
+    // we pick the last one, which is the only one that can hold data
+    auto it = std::upper_bound(_base_offsets.begin(), _base_offsets.end(), o);
+    if (it == _base_offsets.begin()) {
+        return std::nullopt;
+    }
+    return std::distance(_base_offsets.begin(), it) - 1;
+}
+
+} // namespace storage
@@ -29,6 +29,7 @@
 #include "storage/ntp_config.h"
 #include "storage/parser_utils.h"
 #include "storage/segment.h"
+#include "storage/sorted_key_run.h"
 #include "storage/types.h"
 #include "units.h"
 #include "utils/file_sanitizer.h"
@@ -203,6 +204,32 @@ natural_index_of_entries_to_keep(compacted_index_reader reader) {
     return reader.consume(compaction_key_reducer(), model::no_timeout);
 }
 
+ss::future<Roaring> natural_index_of_entries_to_keep(
+  compacted_index_reader reader, compaction_config cfg, storage::probe& pb) {
+    reader.reset();
+    const auto prefix = std::filesystem::path(reader.filename());
+    // runs left behind by a crash in the middle of a previous compaction
+    co_await remove_sorted_runs(prefix);
+    std::optional<Roaring> bitmap;
+    std::exception_ptr ep;
+    try {
+        bitmap = co_await reader.consume(
+          compaction_spilling_key_reducer(
+            prefix,
+            cfg.iopc,
+            config::shard_local_cfg().storage_compaction_key_map_memory(),
+            &pb),
+          model::no_timeout);
+    } catch (...) {
+        ep = std::current_exception();
+    }
+    co_await remove_sorted_runs(prefix);
+    if (ep) {
+        std::rethrow_exception(ep);
+    }
+    co_return std::move(*bitmap);
+}
+
 ss::future<> copy_filtered_entries(
   compacted_index_reader reader,
   Roaring to_copy_index,
@@ -226,19 +253,19 @@ ss::future<> copy_filtered_entries(
 }
 
 static ss::future<> do_write_clean_compacted_index(
-  compacted_index_reader reader, compaction_config cfg) {
-    return natural_index_of_entries_to_keep(reader).then([reader,
-                                                          cfg](Roaring bitmap) {
-        const auto tmpname = std::filesystem::path(
-          fmt::format("{}.staging", reader.filename()));
-        return make_handle(
-                 tmpname,
-                 ss::open_flags::rw | ss::open_flags::truncate
-                   | ss::open_flags::create,
-                 writer_opts(),
-                 cfg.sanitize)
-          .then(
-            [tmpname, cfg, reader, bm = std::move(bitmap)](ss::file f) mutable {
+  compacted_index_reader reader, compaction_config cfg, storage::probe& pb) {
+    return natural_index_of_entries_to_keep(reader, cfg, pb)
+      .then([reader, cfg](Roaring bitmap) {
+          const auto tmpname = std::filesystem::path(
+            fmt::format("{}.staging", reader.filename()));
+          return make_handle(
+                   tmpname,
+                   ss::open_flags::rw | ss::open_flags::truncate
+                     | ss::open_flags::create,
+                   writer_opts(),
+                   cfg.sanitize)
+            .then([tmpname, cfg, reader, bm = std::move(bitmap)](
+                    ss::file f) mutable {
                 auto writer = make_file_backed_compacted_index(
                   tmpname.string(),
                   std::move(f),
@@ -248,19 +275,19 @@ static ss::future<> do_write_clean_compacted_index(
                 return copy_filtered_entries(
                   reader, std::move(bm), std::move(writer));
             })
-          .then([old_name = tmpname.string(), new_name = reader.filename()] {
-              // from glibc: If oldname is not a directory, then any
-              // existing file named newname is removed during the
-              // renaming operation
-              return ss::rename_file(old_name, new_name);
-          });
-    });
+            .then([old_name = tmpname.string(), new_name = reader.filename()] {
+                // from glibc: If oldname is not a directory, then any
+                // existing file named newname is removed during the
+                // renaming operation
+                return ss::rename_file(old_name, new_name);
+            });
+      });
 }
 
 ss::future<> write_clean_compacted_index(
-  compacted_index_reader reader, compaction_config cfg) {
+  compacted_index_reader reader, compaction_config cfg, storage::probe& pb) {
     // integrity verified in `do_detect_compaction_index_state`
-    return do_write_clean_compacted_index(reader, cfg)
+    return do_write_clean_compacted_index(reader, cfg, pb)
       .finally([reader]() mutable {
           return reader.close().then_wrapped(
             [reader](ss::future<>) { /*ignore*/ });
@@ -313,16 +340,16 @@ generate_compacted_list(model::offset o, compacted_index_reader reader) {
       .finally([reader] {});
 }
 
-ss::future<>
-do_compact_segment_index(ss::lw_shared_ptr<segment> s, compaction_config cfg) {
+ss::future<> do_compact_segment_index(
+  ss::lw_shared_ptr<segment> s, compaction_config cfg, storage::probe& pb) {
     auto compacted_path = std::filesystem::path(s->reader().filename());
     compacted_path.replace_extension(".compaction_index");
     vlog(gclog.trace, "compacting segment compaction index:{}", compacted_path);
     return make_reader_handle(compacted_path, cfg.sanitize)
-      .then([cfg, compacted_path, s](ss::file f) {
+      .then([cfg, compacted_path, s, &pb](ss::file f) {
           auto reader = make_file_backed_compacted_reader(
             compacted_path.string(), std::move(f), cfg.iopc, 64_KiB);
-          return write_clean_compacted_index(reader, cfg);
+          return write_clean_compacted_index(reader, cfg, pb);
       });
 }
 ss::future<storage::index_state> do_copy_segment_data(
@@ -454,7 +481,7 @@ ss::future<size_t> do_self_compact_segment(
                 segment_closed_exception());
           }
 
-          return do_compact_segment_index(s, cfg)
+          return do_compact_segment_index(s, cfg, pb)
             // copy the bytes after segment is good - note that we
             // need to do it with the READ-lock, not the write lock
             .then([cfg, s, h = std::move(h), &pb]() mutable {
@@ -121,6 +121,12 @@ size_t number_of_chunks_from_config(const storage::ntp_config&);
 /// the fully dedupped entries, clean of truncations, etc
 ss::future<Roaring> natural_index_of_entries_to_keep(compacted_index_reader);
 
+/// \brief same as above, but bounded by the
+/// `storage_compaction_key_map_memory` budget: keys that do not fit are
+/// spilled as sorted runs next to the index and merged at the end
+ss::future<Roaring> natural_index_of_entries_to_keep(
+  compacted_index_reader, compaction_config, storage::probe&);
+
 ss::future<> copy_filtered_entries(
   storage::compacted_index_reader input,
   Roaring to_copy_index_filter,
@@ -129,7 +135,7 @@ ss::future<> copy_filtered_entries(
 /// \brief writes a new `*.compacted_index` file and *closes* the
 /// input compacted_index_reader file
 ss::future<> write_clean_compacted_index(
-  storage::compacted_index_reader, storage::compaction_config);
+  storage::compacted_index_reader, storage::compaction_config, storage::probe&);
 
 ss::future<compacted_offset_list>
   generate_compacted_list(model::offset, storage::compacted_index_reader);
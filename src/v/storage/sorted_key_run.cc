@@ -0,0 +1,123 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/sorted_key_run.h"
+
+#include "storage/logger.h"
+#include "vlog.h"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+
+#include <fmt/core.h>
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace storage::internal {
+
+std::filesystem::path
+sorted_run_path(const std::filesystem::path& prefix, size_t n) {
+    return std::filesystem::path(fmt::format("{}.run.{}", prefix.string(), n));
+}
+
+ss::future<> remove_sorted_runs(std::filesystem::path prefix) {
+    for (size_t n = 0;; ++n) {
+        auto path = sorted_run_path(prefix, n).string();
+        if (!co_await ss::file_exists(path)) {
+            co_return;
+        }
+        vlog(gclog.trace, "removing compaction run {}", path);
+        co_await ss::remove_file(path);
+    }
+}
+
+ss::future<sorted_run_writer> sorted_run_writer::open(
+  std::filesystem::path path, ss::io_priority_class iopc) {
+    auto f = co_await ss::open_file_dma(
+      path.string(),
+      ss::open_flags::rw | ss::open_flags::create | ss::open_flags::truncate);
+    ss::file_output_stream_options options;
+    options.io_priority_class = iopc;
+    auto out = co_await ss::make_file_output_stream(std::move(f), options);
+    co_return sorted_run_writer(std::move(out));
+}
+
+ss::future<> sorted_run_writer::write(
+  uint64_t hash, bytes_view key, model::offset o, uint32_t natural_index) {
+    std::array<char, sorted_run_entry::header_size> hdr;
+    size_t pos = 0;
+    auto put = [&hdr, &pos](auto v) {
+        v = ss::cpu_to_le(v);
+        std::memcpy(hdr.data() + pos, &v, sizeof(v));
+        pos += sizeof(v);
+    };
+    put(hash);
+    put(static_cast<uint64_t>(o()));
+    put(natural_index);
+    put(static_cast<uint32_t>(key.size()));
+    _bytes_written += hdr.size() + key.size();
+    co_await _out.write(hdr.data(), hdr.size());
+    // NOLINTNEXTLINE
+    co_await _out.write(reinterpret_cast<const char*>(key.data()), key.size());
+}
+
+ss::future<sorted_run_reader> sorted_run_reader::open(
+  std::filesystem::path path, ss::io_priority_class iopc, size_t buffer_size) {
+    auto f = co_await ss::open_file_dma(path.string(), ss::open_flags::ro);
+    ss::file_input_stream_options options;
+    options.buffer_size = buffer_size;
+    options.io_priority_class = iopc;
+    options.read_ahead = 1;
+    co_return sorted_run_reader(
+      ss::make_file_input_stream(std::move(f), 0, std::move(options)));
+}
+
+ss::future<std::optional<sorted_run_entry>> sorted_run_reader::next() {
+    auto hdr = co_await _in.read_exactly(sorted_run_entry::header_size);
+    if (hdr.empty()) {
+        co_return std::nullopt;
+    }
+    if (hdr.size() != sorted_run_entry::header_size) {
+        throw std::runtime_error(fmt::format(
+          "Truncated compaction run entry header. read:{}, expected:{}",
+          hdr.size(),
+          sorted_run_entry::header_size));
+    }
+    size_t pos = 0;
+    auto get = [&hdr, &pos](auto& v) {
+        std::memcpy(&v, hdr.get() + pos, sizeof(v));
+        v = ss::le_to_cpu(v);
+        pos += sizeof(v);
+    };
+    sorted_run_entry e;
+    uint64_t offset = 0;
+    uint32_t key_size = 0;
+    get(e.hash);
+    get(offset);
+    get(e.natural_index);
+    get(key_size);
+    e.offset = model::offset(static_cast<int64_t>(offset));
+
+    auto key = co_await _in.read_exactly(key_size);
+    if (key.size() != key_size) {
+        throw std::runtime_error(fmt::format(
+          "Truncated compaction run entry key. read:{}, expected:{}",
+          key.size(),
+          key_size));
+    }
+    // NOLINTNEXTLINE
+    e.key = bytes(reinterpret_cast<const uint8_t*>(key.get()), key.size());
+    co_return e;
+}
+
+} // namespace storage::internal
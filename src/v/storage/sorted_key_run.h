@@ -0,0 +1,114 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/bytes.h"
+#include "model/fundamental.h"
+
+#include <seastar/core/future.hh>
+#include <seastar/core/io_priority_class.hh>
+#include <seastar/core/iostream.hh>
+
+#include <filesystem>
+#include <optional>
+
+namespace storage::internal {
+
+/**
+ * An entry of a sorted run. Runs are spilled by the compaction key reducer
+ * when its in-memory key map exceeds its memory budget. Inside a run keys are
+ * unique and ordered by (hash, key), so any number of runs can be merged into
+ * the final set of entries to keep in a single streaming pass.
+ *
+ * On disk an entry is:
+ *
+ *    UINT64 UINT64 UINT32 UINT32 []BYTE
+ *    hash   offset index  size   key
+ */
+struct sorted_run_entry {
+    static constexpr size_t header_size = 2 * sizeof(uint64_t)
+                                          + 2 * sizeof(uint32_t);
+
+    uint64_t hash{0};
+    bytes key;
+    // absolute offset of the record, i.e.: base offset + delta
+    model::offset offset;
+    // position of the entry in the `.compaction_index` being compacted
+    uint32_t natural_index{0};
+
+    size_t size_bytes() const { return header_size + key.size(); }
+
+    bool same_key(const sorted_run_entry& o) const {
+        return hash == o.hash && bytes_view(key) == bytes_view(o.key);
+    }
+
+    friend bool
+    operator<(const sorted_run_entry& a, const sorted_run_entry& b) {
+        if (a.hash != b.hash) {
+            return a.hash < b.hash;
+        }
+        return bytes_view(a.key) < bytes_view(b.key);
+    }
+};
+
+/// \brief path of the n-th run spilled while compacting `prefix`
+std::filesystem::path
+sorted_run_path(const std::filesystem::path& prefix, size_t n);
+
+/// \brief removes all runs of `prefix`. Runs are numbered contiguously from
+/// zero and are only removed by this function, so the first missing run ends
+/// the sweep
+ss::future<> remove_sorted_runs(std::filesystem::path prefix);
+
+/// Appends entries to a run file. Callers must write keys in (hash, key) order
+/// and at most once per run.
+class sorted_run_writer {
+public:
+    static ss::future<sorted_run_writer>
+      open(std::filesystem::path, ss::io_priority_class);
+
+    explicit sorted_run_writer(ss::output_stream<char> out) noexcept
+      : _out(std::move(out)) {}
+
+    ss::future<>
+    write(uint64_t hash, bytes_view key, model::offset, uint32_t natural_index);
+    ss::future<> write(const sorted_run_entry& e) {
+        return write(e.hash, e.key, e.offset, e.natural_index);
+    }
+    ss::future<> close() { return _out.close(); }
+
+    size_t bytes_written() const { return _bytes_written; }
+
+private:
+    ss::output_stream<char> _out;
+    size_t _bytes_written{0};
+};
+
+/// Reads a run file back in order. Memory use is bounded by the read buffer
+/// plus the entry being returned.
+class sorted_run_reader {
+public:
+    static ss::future<sorted_run_reader>
+      open(std::filesystem::path, ss::io_priority_class, size_t buffer_size);
+
+    explicit sorted_run_reader(ss::input_stream<char> in) noexcept
+      : _in(std::move(in)) {}
+
+    /// \brief returns std::nullopt at the end of the run
+    ss::future<std::optional<sorted_run_entry>> next();
+    ss::future<> close() { return _in.close(); }
+
+private:
+    ss::input_stream<char> _in;
+};
+
+} // namespace storage::internal
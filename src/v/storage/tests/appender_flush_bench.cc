@@ -0,0 +1,97 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/bytes.h"
+#include "config/property.h"
+#include "random/generators.h"
+#include "storage/segment_appender.h"
+#include "units.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/perf_tests.hh>
+
+#include <fmt/core.h>
+
+#include <memory>
+#include <vector>
+
+/*
+ * Simulates produce on a shard with many active partitions: every round each
+ * partition appends a small batch to its own segment and flushes it, all
+ * partitions concurrently. Besides the time per append reported by the
+ * framework, the fixture prints the latency percentiles of a single
+ * append + flush, which is what a produce request with acks=all waits on.
+ */
+template<size_t Partitions>
+struct append_flush_bench {
+    static constexpr size_t rounds = 10;
+    static constexpr size_t write_size = 1_KiB;
+
+    ~append_flush_bench() {
+        fmt::print(
+          "{} partitions, append+flush latency: p50={}us p99={}us "
+          "p999={}us\n",
+          Partitions,
+          hist.get_value_at(50.0),
+          hist.get_value_at(99.0),
+          hist.get_value_at(99.9));
+    }
+
+    static ss::sstring path(size_t i) {
+        return fmt::format("append_flush_bench_{}_{}.log", Partitions, i);
+    }
+
+    ss::future<size_t> run() {
+        std::vector<std::unique_ptr<storage::segment_appender>> appenders;
+        appenders.reserve(Partitions);
+        for (size_t i = 0; i < Partitions; ++i) {
+            auto f = co_await ss::open_file_dma(
+              path(i),
+              ss::open_flags::create | ss::open_flags::rw
+                | ss::open_flags::truncate);
+            appenders.push_back(std::make_unique<storage::segment_appender>(
+              std::move(f),
+              storage::segment_appender::options(
+                ss::default_priority_class(),
+                1,
+                config::mock_binding<size_t>(32_MiB))));
+        }
+
+        perf_tests::start_measuring_time();
+        for (size_t r = 0; r < rounds; ++r) {
+            co_await ss::parallel_for_each(appenders, [this](auto& a) {
+                auto m = hist.auto_measure();
+                return a->append(data)
+                  .then([&a] { return a->flush(); })
+                  .finally([m = std::move(m)] {});
+            });
+        }
+        perf_tests::stop_measuring_time();
+
+        for (size_t i = 0; i < Partitions; ++i) {
+            co_await appenders[i]->close();
+            co_await ss::remove_file(path(i));
+        }
+        co_return Partitions * rounds;
+    }
+
+    bytes data = random_generators::get_bytes(write_size);
+    hdr_hist hist;
+};
+
+using append_flush_bench_100 = append_flush_bench<100>;
+using append_flush_bench_1k = append_flush_bench<1000>;
+using append_flush_bench_5k = append_flush_bench<5000>;
+
+PERF_TEST_F(append_flush_bench_100, produce) { return run(); }
+PERF_TEST_F(append_flush_bench_1k, produce) { return run(); }
+PERF_TEST_F(append_flush_bench_5k, produce) { return run(); }
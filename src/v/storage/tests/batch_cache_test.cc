@@ -306,3 +306,86 @@ FIXTURE_TEST(test_random_batch_sizes, batch_cache_test_fixture) {
         BOOST_REQUIRE_LE(r.waste(), max_waste);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(compressed_tier_promote) {
+    auto tier_opts = opts;
+    tier_opts.compressed_tier_max_size = 1_MiB;
+
+    storage::batch_cache cache(tier_opts);
+    {
+        storage::batch_cache_index index(cache);
+        for (int i = 0; i < 10; ++i) {
+            index.put(make_batch(10, model::offset(i * 10)));
+        }
+
+        // demoting keeps the batches in the second tier
+        cache.reclaim(
+          std::numeric_limits<size_t>::max(),
+          storage::batch_cache::demote_ranges::yes);
+        BOOST_CHECK(index.empty());
+        BOOST_CHECK(!cache.empty());
+
+        // a lookup promotes the whole range back to the first tier
+        auto b = index.get(model::offset(55));
+        BOOST_REQUIRE(b);
+        BOOST_CHECK_EQUAL(b->base_offset(), model::offset(50));
+        BOOST_CHECK(index.get(model::offset(0)));
+        BOOST_CHECK(index.get(model::offset(99)));
+        BOOST_CHECK(!index.get(model::offset(100)));
+
+        // the synchronous path does not demote
+        cache.reclaim(std::numeric_limits<size_t>::max());
+        BOOST_CHECK(cache.empty());
+        BOOST_CHECK(!index.get(model::offset(55)));
+
+        // truncation drops compressed batches past the truncation point
+        for (int i = 0; i < 10; ++i) {
+            index.put(make_batch(10, model::offset(i * 10)));
+        }
+        cache.reclaim(
+          std::numeric_limits<size_t>::max(),
+          storage::batch_cache::demote_ranges::yes);
+        index.truncate(model::offset(50));
+        BOOST_CHECK(!index.get(model::offset(55)));
+    }
+    BOOST_CHECK(cache.empty());
+    cache.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(compressed_tier_demotion_is_bounded) {
+    auto tier_opts = opts;
+    tier_opts.compressed_tier_max_size = 4_MiB;
+
+    storage::batch_cache cache(tier_opts);
+    {
+        // every batch is larger than a range and gets one of its own
+        storage::batch_cache_index index(cache);
+        const int count = 40;
+        for (int i = 0; i < count; ++i) {
+            index.put(make_random_batch(
+              storage::batch_cache::range::range_size, model::offset(i)));
+        }
+
+        // a single reclaim compresses a bounded prefix of the lru and frees
+        // the rest
+        cache.reclaim(
+          std::numeric_limits<size_t>::max(),
+          storage::batch_cache::demote_ranges::yes);
+        BOOST_CHECK(index.empty());
+
+        size_t promoted = 0;
+        for (int i = 0; i < count; ++i) {
+            if (index.get(model::offset(i))) {
+                ++promoted;
+            }
+        }
+        BOOST_CHECK_GT(promoted, size_t(0));
+        BOOST_CHECK_LE(
+          promoted,
+          storage::batch_cache::max_demote_size
+              / storage::batch_cache::range::range_size
+            + 1);
+    }
+    BOOST_CHECK(cache.empty());
+    cache.stop().get();
+}
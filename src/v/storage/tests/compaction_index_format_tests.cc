@@ -22,8 +22,13 @@
 #include "utils/tmpbuf_file.h"
 #include "utils/vint.h"
 
+#include <seastar/core/seastar.hh>
+
 #include <boost/test/unit_test_suite.hpp>
 
+#include <array>
+#include <filesystem>
+
 struct compacted_topic_fixture {};
 FIXTURE_TEST(format_verification, compacted_topic_fixture) {
     tmpbuf_file::store_t index_data;
@@ -344,3 +349,63 @@ FIXTURE_TEST(index_filtered_copy_tests, compacted_topic_fixture) {
         }
     }
 }
+
+FIXTURE_TEST(spilling_key_reducer, compacted_topic_fixture) {
+    tmpbuf_file::store_t index_data;
+    auto idx = storage::make_file_backed_compacted_index(
+      "dummy name",
+      ss::file(ss::make_shared(tmpbuf_file(index_data))),
+      ss::default_priority_class(),
+      32_KiB);
+
+    // short keys are stored inline by bytes, they must survive the writes of
+    // the intermediate merges as well
+    const std::array<size_t, 3> key_sizes{8, 24, 64};
+    std::vector<bytes> keys;
+    for (auto i = 0; i < 60; ++i) {
+        keys.push_back(random_generators::get_bytes(key_sizes[i % 3]));
+        idx.index(keys.back(), model::offset(i), 0).get();
+    }
+    for (auto i = 60; i < 300; ++i) {
+        auto& k = keys[random_generators::get_int<size_t>(keys.size() - 1)];
+        idx.index(k, model::offset(i), 0).get();
+    }
+    idx.close().get();
+
+    auto rdr = storage::make_file_backed_compacted_reader(
+      "dummy name",
+      ss::file(ss::make_shared(tmpbuf_file(index_data))),
+      ss::default_priority_class(),
+      32_KiB);
+    rdr.verify_integrity().get();
+    rdr.reset();
+    auto expected = rdr
+                      .consume(
+                        storage::internal::compaction_key_reducer(),
+                        model::no_timeout)
+                      .get0();
+
+    const auto prefix = std::filesystem::path(
+      fmt::format("spilling_key_reducer.{}", random_generators::get_int(1000)));
+    rdr.reset();
+    // a budget of a handful of keys forces many runs and, with a fan-in of
+    // two, intermediate merges
+    auto spilled = rdr
+                     .consume(
+                       storage::internal::compaction_spilling_key_reducer(
+                         prefix, ss::default_priority_class(), 1_KiB),
+                       model::no_timeout)
+                     .get0();
+    BOOST_REQUIRE(
+      ss::file_exists(storage::internal::sorted_run_path(prefix, 1).string())
+        .get0());
+    storage::internal::remove_sorted_runs(prefix).get();
+    BOOST_REQUIRE(
+      !ss::file_exists(storage::internal::sorted_run_path(prefix, 0).string())
+         .get0());
+
+    info("expected: {}", expected.toString());
+    info("spilled: {}", spilled.toString());
+    BOOST_REQUIRE_EQUAL(expected.cardinality(), keys.size());
+    BOOST_REQUIRE(expected == spilled);
+}
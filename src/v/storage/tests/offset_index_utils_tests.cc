@@ -8,6 +8,7 @@
 // by the Apache License, Version 2.0
 #include "random/generators.h"
 #include "serde/serde.h"
+#include "storage/index_residency_manager.h"
 #include "storage/segment_index.h"
 #include "test_utils/fixture.h"
 #include "utils/file_io.h"
@@ -126,3 +127,60 @@ FIXTURE_TEST(bucket_truncate, context) {
         BOOST_REQUIRE_EQUAL(p->filepos, 458048);
     }
 }
+
+FIXTURE_TEST(index_residency_evict_and_hydrate, context) {
+    for (uint32_t i = 0; i < 1024; ++i) {
+        model::offset o = _base_offset + model::offset(i);
+        _idx->maybe_track(
+          modify_get(o, storage::segment_index::default_data_buffer_step), i);
+    }
+    {
+        // budget of zero bytes: every evictable index is dropped
+        storage::index_residency_manager mgr(
+          config::mock_binding<std::optional<size_t>>(size_t(0)));
+        mgr.manage(*_idx);
+        BOOST_REQUIRE(mgr.resident_bytes() > 0);
+        // indices of active segments are never evicted
+        BOOST_REQUIRE(!_idx->is_evicted());
+
+        // nor indices that are not persisted yet
+        _idx->set_evictable(true);
+        BOOST_REQUIRE(!_idx->is_evicted());
+        _idx->set_evictable(false);
+
+        // segment roll: flush, then the index becomes evictable
+        _idx->flush().get();
+        _idx->set_evictable(true);
+        BOOST_REQUIRE(_idx->is_evicted());
+        BOOST_REQUIRE_EQUAL(mgr.resident_bytes(), 0);
+        BOOST_REQUIRE_EQUAL(_idx->max_offset(), model::offset(1023));
+        BOOST_REQUIRE(!_idx->find_nearest(model::offset(10)));
+    }
+    // no longer managed, hydration loads the entries back for good
+    _idx->hydrate().get();
+    BOOST_REQUIRE(!_idx->is_evicted());
+    index_entry_expect(10, 10);
+    index_entry_expect(1023, 1023);
+}
+
+FIXTURE_TEST(index_residency_hydrate_over_budget, context) {
+    for (uint32_t i = 0; i < 1024; ++i) {
+        model::offset o = _base_offset + model::offset(i);
+        _idx->maybe_track(
+          modify_get(o, storage::segment_index::default_data_buffer_step), i);
+    }
+    // the budget is smaller than the index alone
+    storage::index_residency_manager mgr(
+      config::mock_binding<std::optional<size_t>>(size_t(1)));
+    mgr.manage(*_idx);
+    _idx->flush().get();
+    _idx->set_evictable(true);
+    BOOST_REQUIRE(_idx->is_evicted());
+
+    // a hydrated index stays resident for the lookup that loaded it
+    _idx->hydrate().get();
+    BOOST_REQUIRE(!_idx->is_evicted());
+    BOOST_REQUIRE_GT(mgr.resident_bytes(), 1);
+    index_entry_expect(10, 10);
+    index_entry_expect(1023, 1023);
+}
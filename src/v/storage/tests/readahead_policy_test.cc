@@ -0,0 +1,51 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/readahead_policy.h"
+#include "units.h"
+
+#include <boost/test/unit_test.hpp>
+
+static const storage::read_window base{128_KiB, 10};
+
+BOOST_AUTO_TEST_CASE(readahead_starts_at_configured_window) {
+    storage::readahead_policy p(16_MiB);
+    BOOST_REQUIRE(p.window(base) == base);
+}
+
+BOOST_AUTO_TEST_CASE(readahead_seek_shrinks_window) {
+    storage::readahead_policy p(16_MiB);
+    p.on_seek();
+    auto w = p.window(base);
+    BOOST_REQUIRE_EQUAL(w.buffer_size, base.buffer_size);
+    BOOST_REQUIRE_EQUAL(w.read_ahead, 1);
+
+    // reading a full window in order restores the configured window
+    BOOST_REQUIRE(!p.on_sequential(w.bytes() - 1, base));
+    BOOST_REQUIRE(p.on_sequential(1, base));
+    BOOST_REQUIRE(p.window(base) == base);
+}
+
+BOOST_AUTO_TEST_CASE(readahead_sequential_grows_up_to_max) {
+    storage::readahead_policy p(16_MiB);
+    auto prev = p.window(base);
+    for (int i = 0; i < 100; ++i) {
+        p.on_sequential(1_MiB, base);
+        auto w = p.window(base);
+        BOOST_REQUIRE_GE(w.bytes(), prev.bytes());
+        BOOST_REQUIRE_LE(w.bytes(), 16_MiB);
+        prev = w;
+    }
+    // read-ahead grows first, then the buffer size
+    BOOST_REQUIRE_EQUAL(prev.read_ahead, 40);
+    BOOST_REQUIRE_EQUAL(prev.buffer_size, 256_KiB);
+
+    p.on_seek();
+    BOOST_REQUIRE_EQUAL(p.window(base).read_ahead, 1);
+}
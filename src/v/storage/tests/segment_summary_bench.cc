@@ -0,0 +1,97 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/fundamental.h"
+#include "random/generators.h"
+#include "storage/segment_summary_index.h"
+
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/testing/perf_tests.hh>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/*
+ * Compares locating the segment that holds a random offset using the
+ * contiguous segment_summary_index against a binary search that dereferences
+ * every segment visited, which is how segment_set looked segments up before.
+ */
+template<size_t Segments>
+struct seek_bench {
+    static constexpr int64_t offsets_per_segment = 1000;
+
+    struct fake_segment {
+        model::offset base_offset;
+        model::offset dirty_offset;
+        // pad the segment so that segments do not share cache lines
+        std::array<char, 512> payload{};
+    };
+
+    seek_bench() {
+        for (size_t i = 0; i < Segments; ++i) {
+            const auto base = model::offset(i * offsets_per_segment);
+            segments.push_back(ss::make_lw_shared<fake_segment>(fake_segment{
+              .base_offset = base,
+              .dirty_offset = base + model::offset(offsets_per_segment - 1)}));
+            summary.push_back(base);
+        }
+        needles.reserve(1024);
+        for (size_t i = 0; i < 1024; ++i) {
+            needles.push_back(model::offset(random_generators::get_int<int64_t>(
+              0, Segments * offsets_per_segment - 1)));
+        }
+    }
+
+    size_t run_summary() {
+        size_t found = 0;
+        perf_tests::start_measuring_time();
+        for (auto o : needles) {
+            auto idx = summary.find(o);
+            found += segments[*idx]->dirty_offset >= o;
+        }
+        perf_tests::do_not_optimize(found);
+        perf_tests::stop_measuring_time();
+        return needles.size();
+    }
+
+    size_t run_pointer_chasing() {
+        size_t found = 0;
+        perf_tests::start_measuring_time();
+        for (auto o : needles) {
+            auto it = std::lower_bound(
+              segments.begin(),
+              segments.end(),
+              o,
+              [](const ss::lw_shared_ptr<fake_segment>& s, model::offset o) {
+                  return s->dirty_offset < o;
+              });
+            found += (*it)->base_offset <= o;
+        }
+        perf_tests::do_not_optimize(found);
+        perf_tests::stop_measuring_time();
+        return needles.size();
+    }
+
+    ss::circular_buffer<ss::lw_shared_ptr<fake_segment>> segments;
+    storage::segment_summary_index summary;
+    std::vector<model::offset> needles;
+};
+
+using seek_bench_100 = seek_bench<100>;
+using seek_bench_1k = seek_bench<1000>;
+using seek_bench_10k = seek_bench<10000>;
+
+PERF_TEST_F(seek_bench_100, summary) { return run_summary(); }
+PERF_TEST_F(seek_bench_100, pointer_chasing) { return run_pointer_chasing(); }
+PERF_TEST_F(seek_bench_1k, summary) { return run_summary(); }
+PERF_TEST_F(seek_bench_1k, pointer_chasing) { return run_pointer_chasing(); }
+PERF_TEST_F(seek_bench_10k, summary) { return run_summary(); }
+PERF_TEST_F(seek_bench_10k, pointer_chasing) { return run_pointer_chasing(); }
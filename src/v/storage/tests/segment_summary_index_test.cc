@@ -0,0 +1,59 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/fundamental.h"
+#include "storage/segment_summary_index.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_CASE(summary_index_find) {
+    storage::segment_summary_index summary;
+    BOOST_REQUIRE(!summary.find(model::offset(0)));
+
+    // segments with base offsets 0, 10, 20, ..., 990
+    for (int i = 0; i < 100; ++i) {
+        summary.push_back(model::offset(i * 10));
+    }
+    BOOST_REQUIRE_EQUAL(summary.size(), 100);
+    BOOST_REQUIRE(!summary.find(model::offset(-1)));
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(0)), 0);
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(9)), 0);
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(10)), 1);
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(555)), 55);
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(100000)), 99);
+}
+
+BOOST_AUTO_TEST_CASE(summary_index_empty_segments_share_base) {
+    // an empty segment has dirty_offset = base_offset - 1, so the next
+    // segment may start at the same base offset. lookups must pick the last.
+    storage::segment_summary_index summary;
+    summary.push_back(model::offset(0));
+    summary.push_back(model::offset(10));
+    summary.push_back(model::offset(10));
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(10)), 2);
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(9)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(summary_index_erase) {
+    storage::segment_summary_index summary;
+    for (int i = 0; i < 10; ++i) {
+        summary.push_back(model::offset(i * 10));
+    }
+    summary.pop_front();
+    summary.pop_back();
+    BOOST_REQUIRE_EQUAL(summary.size(), 8);
+    BOOST_REQUIRE(!summary.find(model::offset(5)));
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(95)), 7);
+
+    // remove segments with base offsets 30 and 40
+    summary.erase(2, 4);
+    BOOST_REQUIRE_EQUAL(summary.size(), 6);
+    BOOST_REQUIRE_EQUAL(summary[2], model::offset(50));
+    BOOST_REQUIRE_EQUAL(*summary.find(model::offset(45)), 1);
+}
@@ -1269,9 +1269,7 @@ FIXTURE_TEST(adjacent_segment_compaction, storage_test_fixture) {
     log.compact(c_cfg).get0();
     BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 4);
 
-    log.compact(c_cfg).get0();
-    BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 3);
-
+    // the three closed segments are combined in a single pass
     log.compact(c_cfg).get0();
     BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 2);
 
@@ -1400,16 +1398,13 @@ FIXTURE_TEST(max_adjacent_segment_compaction, storage_test_fixture) {
     log.compact(c_cfg).get0();
     BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 6);
 
-    // the first two segments are combined 2+2=4 < 6 MB
+    // the first two segments are combined 2+2=4 < 6 MB, the third one would
+    // take the run over the limit 4+5 > 6 MB
     log.compact(c_cfg).get0();
     BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 5);
 
-    // the new first and second are too big 4+5 > 6 MB but the second and third
-    // can be combined 5 + 15KB < 6 MB
-    log.compact(c_cfg).get0();
-    BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 4);
-
-    // then the next 16 KB can be folded in
+    // the new first and second are too big 4+5 > 6 MB but the second and the
+    // two 16 KB segments after it are combined 5 + 32KB < 6 MB
     log.compact(c_cfg).get0();
     BOOST_REQUIRE_EQUAL(disk_log->segment_count(), 3);
 
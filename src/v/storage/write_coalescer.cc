@@ -0,0 +1,153 @@
+// Copyright 2020 Vectorized, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/write_coalescer.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "ssx/future-util.h"
+
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/util/later.hh>
+
+namespace storage::internal {
+
+static void resolve(std::vector<ss::promise<>>& waiters, ss::future<> fut) {
+    if (fut.failed()) {
+        auto e = fut.get_exception();
+        for (auto& w : waiters) {
+            w.set_exception(e);
+        }
+        return;
+    }
+    for (auto& w : waiters) {
+        w.set_value();
+    }
+}
+
+ss::future<> write_coalescer::flush(key_type key, ss::file f) {
+    if (_gate.is_closed()) {
+        // stopping, nothing left to group the request with
+        return f.flush();
+    }
+    ++_flush_requests;
+    auto& st = _files[key];
+    st.file = std::move(f);
+    auto fut = st.waiters.emplace_back().get_future();
+    if (!st.in_flight && !st.queued) {
+        st.queued = true;
+        _queued.push_back(key);
+        schedule_dispatch();
+    }
+    return fut;
+}
+
+void write_coalescer::schedule_dispatch() {
+    if (_dispatch_scheduled) {
+        return;
+    }
+    if (_files.size() == 1) {
+        // no other file is being flushed, waiting for more requests would
+        // only delay this one
+        dispatch();
+        return;
+    }
+    _dispatch_scheduled = true;
+    // let every task runnable in this quota add its requests to the round
+    ssx::spawn_with_gate(
+      _gate, [this] { return ss::later().then([this] { dispatch(); }); });
+}
+
+void write_coalescer::dispatch() {
+    _dispatch_scheduled = false;
+    ++_rounds;
+    auto queued = std::exchange(_queued, {});
+    for (auto key : queued) {
+        auto& st = _files.find(key)->second;
+        st.queued = false;
+        ssx::spawn_with_gate(
+          _gate, [this, key, &st] { return do_flush(key, st); });
+    }
+}
+
+ss::future<> write_coalescer::do_flush(key_type key, file_state& st) {
+    ++_flushes;
+    st.in_flight = true;
+    auto f = st.file;
+    return f.flush().then_wrapped(
+      [this, key, f, waiters = std::exchange(st.waiters, {})](
+        ss::future<> fut) mutable {
+          auto it = _files.find(key);
+          it->second.in_flight = false;
+          if (it->second.waiters.empty()) {
+              _files.erase(it);
+          } else {
+              // requests that arrived while syncing need another round
+              it->second.queued = true;
+              _queued.push_back(key);
+              schedule_dispatch();
+          }
+
+          resolve(waiters, std::move(fut));
+      });
+}
+
+ss::future<> write_coalescer::stop() {
+    if (_users == 0 || --_users > 0) {
+        return ss::now();
+    }
+    return _gate.close().then([this] {
+        // requests that came in while closing were never dispatched
+        auto files = std::exchange(_files, {});
+        _queued.clear();
+        _dispatch_scheduled = false;
+        _gate = ss::gate();
+        return ss::do_with(std::move(files), [](auto& files) {
+            return ss::parallel_for_each(files, [](auto& entry) {
+                auto& st = entry.second;
+                if (st.waiters.empty()) {
+                    return ss::now();
+                }
+                return st.file.flush().then_wrapped(
+                  [waiters = std::exchange(st.waiters, {})](
+                    ss::future<> fut) mutable {
+                      resolve(waiters, std::move(fut));
+                  });
+            });
+        });
+    });
+}
+
+void write_coalescer::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    namespace sm = ss::metrics;
+    // the coalescer outlives storage restarts within a shard
+    _metrics.clear();
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:write_coalescer"),
+      {
+        sm::make_derive(
+          "flush_requests",
+          [this] { return _flush_requests; },
+          sm::description("Segment flushes requested by appenders")),
+        sm::make_derive(
+          "flushes",
+          [this] { return _flushes; },
+          sm::description("Segment flushes issued to disk")),
+        sm::make_derive(
+          "rounds",
+          [this] { return _rounds; },
+          sm::description("Batches of coalesced segment flushes dispatched")),
+      });
+}
+
+} // namespace storage::internal
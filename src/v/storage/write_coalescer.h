@@ -0,0 +1,105 @@
+/*
+ * Copyright 2020 Vectorized, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "seastarx.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+
+#include <absl/container/node_hash_map.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace storage::internal {
+
+/**
+ * Per-shard coalescer of segment flushes.
+ *
+ * Every segment appender used to issue its own fdatasync as soon as one of
+ * its writes completed, so a shard with thousands of active partitions issues
+ * thousands of them per second, many of them for the same file while a
+ * previous one is still running. All of them are executed one at a time by
+ * the shard's syscall thread.
+ *
+ * Appenders hand their flushes to the coalescer instead. Requests made while
+ * the current task quota runs are collected and dispatched together in a
+ * single round, with one fdatasync per file no matter how many requests it
+ * got. A request for a file that is being synced joins the next round for
+ * that file, which starts as soon as the running sync completes; it cannot
+ * join the running sync since it may cover writes completed after the sync
+ * started. A request made while no other file is being flushed is dispatched
+ * right away, there is nothing to group it with.
+ *
+ * Data writes are not routed through the coalescer: the reactor already
+ * submits all dma writes queued during a poll in one batch.
+ */
+class write_coalescer {
+public:
+    using key_type = const void*;
+
+    write_coalescer() noexcept = default;
+    write_coalescer(write_coalescer&&) = delete;
+    write_coalescer& operator=(write_coalescer&&) = delete;
+    write_coalescer(const write_coalescer&) = delete;
+    write_coalescer& operator=(const write_coalescer&) = delete;
+    ~write_coalescer() noexcept = default;
+
+    /// \brief flushes `f` once all the writes to it that completed before the
+    /// call are durable. `key` identifies the file, usually its appender, and
+    /// must stay unique while the future is pending.
+    ss::future<> flush(key_type key, ss::file f);
+
+    /// \brief the coalescer is shared by all the storage instances of the
+    /// shard, each of them starts and stops it. Once the last one stopped, it
+    /// waits for the running flushes and flushes the files of the requests
+    /// that were not dispatched yet directly, as it does for requests made
+    /// while stopping. It can be started again afterwards.
+    void start() { ++_users; }
+    ss::future<> stop();
+
+    void setup_metrics();
+
+private:
+    struct file_state {
+        ss::file file;
+        // requests of the next round
+        std::vector<ss::promise<>> waiters;
+        bool in_flight{false};
+        bool queued{false};
+    };
+
+    void schedule_dispatch();
+    void dispatch();
+    ss::future<> do_flush(key_type, file_state&);
+
+    absl::node_hash_map<key_type, file_state> _files;
+    std::vector<key_type> _queued;
+    bool _dispatch_scheduled{false};
+    size_t _users{0};
+    ss::gate _gate;
+
+    uint64_t _flush_requests{0};
+    uint64_t _flushes{0};
+    uint64_t _rounds{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+inline write_coalescer& coalescer() {
+    static thread_local write_coalescer c;
+    return c;
+}
+
+} // namespace storage::internal
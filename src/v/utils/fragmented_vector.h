@@ -84,6 +84,8 @@ public:
     const T& back() const { return _frags.back().back(); }
     bool empty() const noexcept { return _size == 0; }
     size_t size() const noexcept { return _size; }
+    /// \brief bytes reserved by the allocated fragments
+    size_t memory_size() const noexcept { return _capacity * sizeof(T); }
 
     void shrink_to_fit() {
         if (!_frags.empty()) {